@@ -0,0 +1,134 @@
+#include "pf/util/compressor/codec.h"
+#include "pf/basic/clock.h"
+
+using namespace pf_util::compressor;
+
+//Usage: codec_bench [frame size] [trace file ...]
+//The trace file is the raw output stream recorded from a connection, it cut
+//into frames as the output flush. Without traces use the generated packets.
+
+static std::vector<unsigned char> generate_stream(uint32_t size) {
+  std::vector<unsigned char> result;
+  result.reserve(size);
+  std::mt19937 engine(20171019);
+  auto rng = [&engine]() { return static_cast<uint32_t>(engine()); };
+  const char *names[] = {"player", "monster", "npc", "item", "skill"};
+  while (result.size() < size) {
+    //The packet header: id(uint16) + index|size(uint32).
+    uint16_t id = static_cast<uint16_t>(1000 + rng() % 32);
+    uint32_t length = 16 + rng() % 128;
+    unsigned char header[6];
+    memcpy(header, &id, sizeof(id));
+    memcpy(header + 2, &length, sizeof(length));
+    result.insert(result.end(), header, header + sizeof(header));
+    char body[256] = {0};
+    snprintf(body, sizeof(body), "%s:%u pos(%u,%u,%u) hp:%u mp:%u",
+             names[rng() % 5], rng() % 10000, rng() % 1024, rng() % 1024,
+             rng() % 64, rng() % 100000, rng() % 5000);
+    for (uint32_t i = 0; i < length; ++i) {
+      result.push_back(static_cast<unsigned char>(
+            i < strlen(body) ? body[i] : rng() % 4));
+    }
+  }
+  result.resize(size);
+  return result;
+}
+
+static bool read_trace(const char *filename, std::vector<unsigned char> &data) {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file) return false;
+  data.assign(std::istreambuf_iterator<char>(file),
+              std::istreambuf_iterator<char>());
+  return !data.empty();
+}
+
+//The seconds from the start(the microseconds of the monotonic clock).
+static double seconds_since(uint64_t start_us) {
+  return (pf_basic::Clock::now_us() - start_us) / 1000000.0;
+}
+
+static double mbps(uint64_t bytes, double seconds) {
+  return seconds > 0 ? bytes / seconds / (1024.0 * 1024.0) : 0;
+}
+
+static void run(const char *title,
+                const std::vector<unsigned char> &data,
+                uint32_t frame) {
+  printf("%s: %zu bytes, frame %u\n", title, data.size(), frame);
+  printf("  %-12s %8s %12s %12s %8s\n",
+         "codec", "ratio", "comp MB/s", "decomp MB/s", "raw%");
+  for (uint8_t id = kCodecNone + 1; id < UTIL_COMPRESSOR_CODEC_MAX; ++id) {
+    Codec *codec = codec::get(id);
+    if (is_null(codec)) continue;
+    std::unique_ptr<CodecContext> encoder(codec->create_context(frame));
+    std::unique_ptr<CodecContext> decoder(codec->create_context(frame));
+    std::vector<unsigned char> out(codec->bound(frame));
+    std::vector<unsigned char> back(frame);
+    std::vector< std::vector<unsigned char> > frames;
+    std::vector<uint32_t> sizes;
+    uint64_t insize = 0;
+    uint64_t outsize = 0;
+    uint32_t rawcount = 0;
+    auto start_us = pf_basic::Clock::now_us();
+    for (size_t offset = 0; offset < data.size(); offset += frame) {
+      uint32_t size = static_cast<uint32_t>(
+          data.size() - offset < frame ? data.size() - offset : frame);
+      uint32_t size_out = static_cast<uint32_t>(out.size());
+      insize += size;
+      if (!codec->compress(
+            encoder.get(), &data[offset], size, &out[0], size_out)) {
+        ++rawcount; //Send the raw frame as the stream do.
+        outsize += size;
+        frames.push_back(std::vector<unsigned char>());
+        sizes.push_back(size);
+        continue;
+      }
+      outsize += size_out;
+      frames.push_back(std::vector<unsigned char>(&out[0], &out[size_out]));
+      sizes.push_back(size);
+    }
+    double compress_seconds = seconds_since(start_us);
+    start_us = pf_basic::Clock::now_us();
+    bool ok = true;
+    size_t offset = 0;
+    for (size_t i = 0; i < frames.size(); ++i) {
+      if (!frames[i].empty()) {
+        uint32_t size_out = frame;
+        if (!codec->decompress(decoder.get(),
+                               &frames[i][0],
+                               static_cast<uint32_t>(frames[i].size()),
+                               &back[0],
+                               size_out) ||
+            size_out != sizes[i] ||
+            memcmp(&back[0], &data[offset], size_out) != 0) ok = false;
+      }
+      offset += sizes[i];
+    }
+    double decompress_seconds = seconds_since(start_us);
+    printf("  %-12s %8.3f %12.1f %12.1f %7.1f%%%s\n",
+           codec->name(),
+           insize ? static_cast<double>(outsize) / insize : 0,
+           mbps(insize, compress_seconds),
+           mbps(insize, decompress_seconds),
+           frames.empty() ? 0 : 100.0 * rawcount / frames.size(),
+           ok ? "" : " (verify failed)");
+  }
+}
+
+int32_t main(int32_t argc, char **argv) {
+  uint32_t frame = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 1024;
+  if (0 == frame) frame = 1024;
+  if (argc > 2) {
+    for (int32_t i = 2; i < argc; ++i) {
+      std::vector<unsigned char> data;
+      if (!read_trace(argv[i], data)) {
+        printf("read trace %s failed\n", argv[i]);
+        continue;
+      }
+      run(argv[i], data, frame);
+    }
+  } else {
+    run("generated", generate_stream(32 * 1024 * 1024), frame);
+  }
+  return 0;
+}
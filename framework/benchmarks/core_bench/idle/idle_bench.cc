@@ -0,0 +1,127 @@
+#include "pf/basic/time_manager.h"
+#include "pf/basic/logger.h"
+#include "pf/net/connection/manager/listener.h"
+#include "pf/basic/clock.h"
+
+#if OS_UNIX
+#include <dlfcn.h>
+#include <sys/epoll.h>
+
+//Usage: idle_bench [connections] [ticks] [max syscalls per tick]
+//The idle connections must not cost syscalls every tick, the socket calls
+//of the process are counted by interposing the libc functions(same as
+//`strace -c -f`, but no permission needed). Exit 1 if over the max.
+
+static std::atomic<uint64_t> g_getsockopt{0};
+static std::atomic<uint64_t> g_recv{0};
+static std::atomic<uint64_t> g_send{0};
+static std::atomic<uint64_t> g_epoll_wait{0};
+static bool g_counting{false};
+
+template <typename T>
+static T next_symbol(const char *name) {
+  return reinterpret_cast<T>(dlsym(RTLD_NEXT, name));
+}
+
+extern "C" {
+
+int getsockopt(int fd, int level, int name, void *value, socklen_t *length) {
+  typedef int (*function_t)(int, int, int, void *, socklen_t *);
+  static function_t next = next_symbol<function_t>("getsockopt");
+  if (g_counting) ++g_getsockopt;
+  return next(fd, level, name, value, length);
+}
+
+ssize_t recv(int fd, void *buffer, size_t length, int flags) {
+  typedef ssize_t (*function_t)(int, void *, size_t, int);
+  static function_t next = next_symbol<function_t>("recv");
+  if (g_counting) ++g_recv;
+  return next(fd, buffer, length, flags);
+}
+
+ssize_t send(int fd, const void *buffer, size_t length, int flags) {
+  typedef ssize_t (*function_t)(int, const void *, size_t, int);
+  static function_t next = next_symbol<function_t>("send");
+  if (g_counting) ++g_send;
+  return next(fd, buffer, length, flags);
+}
+
+int epoll_wait(int fd, struct epoll_event *events, int max, int timeout) {
+  typedef int (*function_t)(int, struct epoll_event *, int, int);
+  static function_t next = next_symbol<function_t>("epoll_wait");
+  if (g_counting) ++g_epoll_wait;
+  return next(fd, events, max, timeout);
+}
+
+} //extern "C"
+
+//The seconds from the start(the microseconds of the monotonic clock).
+static double seconds_since(uint64_t start_us) {
+  return (pf_basic::Clock::now_us() - start_us) / 1000000.0;
+}
+
+int32_t main(int32_t argc, char **argv) {
+  using namespace pf_basic;
+  int32_t count = argc > 1 ? atoi(argv[1]) : 1000;
+  int32_t ticks = argc > 2 ? atoi(argv[2]) : 1000;
+  double limit = argc > 3 ? atof(argv[3]) : 4.0;
+  if (count > NET_CONNECTION_MAX - 2) count = NET_CONNECTION_MAX - 2;
+  GLOBALS["log.print"] = false;
+  auto time_manager = new TimeManager();
+  unique_move(TimeManager, time_manager, g_time_manager);
+  g_time_manager->init();
+  auto logger = new Logger();
+  unique_move(Logger, logger, g_logger);
+
+  pf_net::connection::manager::Listener listener;
+  if (!listener.init(static_cast<uint16_t>(count + 2), 0, "127.0.0.1")) {
+    printf("listener init failed\n");
+    return 1;
+  }
+  uint16_t port = listener.port();
+  std::vector<int32_t> clients;
+  for (int32_t i = 0; i < count; ++i) {
+    int32_t fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = inet_addr("127.0.0.1");
+    if (::connect(fd, reinterpret_cast<struct sockaddr *>(&address),
+                  sizeof(address)) != 0) {
+      printf("connect failed: %s\n", strerror(errno));
+      return 1;
+    }
+    clients.push_back(fd);
+    listener.tick(); //The listen backlog is small.
+  }
+  for (int32_t i = 0; i < 100 && listener.size() < count; ++i)
+    listener.tick();
+  printf("idle connections: %d/%d, ticks: %d\n", listener.size(), count, ticks);
+
+  g_counting = true;
+  auto start_us = pf_basic::Clock::now_us();
+  for (int32_t i = 0; i < ticks; ++i) listener.tick();
+  double seconds = seconds_since(start_us);
+  g_counting = false;
+
+  uint64_t socketcalls = g_getsockopt + g_recv + g_send;
+  double pertick = static_cast<double>(socketcalls) / ticks;
+  printf("  getsockopt: %" PRIu64 ", recv: %" PRIu64 ", send: %" PRIu64
+         ", epoll_wait: %" PRIu64 "\n",
+         g_getsockopt.load(), g_recv.load(), g_send.load(),
+         g_epoll_wait.load());
+  printf("  socket calls per tick: %.2f (max %.2f), us per tick: %.2f\n",
+         pertick, limit, seconds * 1000000 / ticks);
+  for (int32_t fd : clients) ::close(fd);
+  return pertick > limit ? 1 : 0;
+}
+
+#else
+
+int32_t main(int32_t, char **) {
+  printf("idle_bench only support unix\n");
+  return 0;
+}
+
+#endif
@@ -0,0 +1,414 @@
+#include <algorithm>
+#include "pf/basic/time_manager.h"
+#include "pf/basic/logger.h"
+#include "pf/basic/clock.h"
+#include "pf/net/connection/basic.h"
+#include "pf/net/connection/manager/listener.h"
+#include "pf/net/connection/manager/connector.h"
+#include "pf/net/packet/dynamic.h"
+#include "pf/net/packet/factorymanager.h"
+
+#if OS_UNIX
+#include <sys/resource.h>
+
+//Usage: load_bench [--scenario=idle|storm|large|broadcast]
+//                  [--connections=n] [--seconds=n] [--rate=n]
+//                  [--mode=echo|request|broadcast] [--size=bytes]
+//                  [--compress] [--encrypt] [--format=console|json]
+//The whole net path on the loopback: the clients(one Connector in the main
+//thread) send the Dynamic packets to a Listener ticked in the other thread,
+//the server executes them and replies(echo the packet, request a small
+//response, broadcast to all clients). The packets carry the send time, the
+//client records the latency when the reply executed.
+//The rate is the packets per second of all clients, 0 is as fast as the
+//window(the packets not replied of each client) allows.
+//The CPU and RSS are of the process(the server and the clients).
+
+enum {
+  kPacketIdEcho = 0xff10,     //Client to server.
+  kPacketIdRequest = 0xff11,
+  kPacketIdBroadcast = 0xff12,
+  kPacketIdReply = 0xff20,    //Server to client.
+};
+
+typedef struct option_struct {
+  std::string scenario;
+  std::string mode;
+  std::string format;
+  int32_t connections;
+  double seconds;
+  double rate;
+  uint32_t size;
+  bool compress;
+  bool encrypt;
+  option_struct() :
+    scenario{"storm"},
+    mode{"echo"},
+    format{"console"},
+    connections{100},
+    seconds{5},
+    rate{0},
+    size{32},
+    compress{false},
+    encrypt{false} {}
+} option_t;
+
+typedef struct client_struct {
+  int16_t id;
+  uint64_t sent;
+  uint64_t received;
+  client_struct() : id{ID_INVALID}, sent{0}, received{0} {}
+} client_t;
+
+static option_t g_option;
+static std::atomic<bool> g_running{true};
+static std::vector<client_t> g_clients;
+static std::map<int16_t, size_t> g_client_index;
+static std::vector<uint32_t> g_latencies;
+static uint64_t g_received_bytes{0};
+static std::atomic<uint64_t> g_server_packets{0};
+static std::atomic<uint64_t> g_disconnects{0};
+static pf_net::connection::manager::Listener *g_listener{nullptr};
+static std::vector<int16_t> g_server_connections; //The server thread only.
+
+static bool __stdcall is_dynamic_packet_id(uint16_t id) {
+  return id >= 0xff00;
+}
+
+static void connection_setup(pf_net::connection::Basic *connection) {
+  using namespace pf_net::connection;
+  if (g_option.compress) connection->compress_set_mode(kCompressModeAll);
+  if (g_option.encrypt) {
+    connection->encrypt_set_key("0123456789abcdef");
+    connection->encrypt_enable(true);
+  }
+}
+
+static uint32_t server_execute(pf_net::connection::Basic *connection,
+                               pf_net::packet::Dynamic *packet) {
+  using namespace pf_net::packet;
+  ++g_server_packets;
+  std::vector<char> data(packet->size());
+  if (data.size() > 0) packet->read(&data[0], packet->size());
+  Dynamic reply(kPacketIdReply);
+  if (kPacketIdRequest == packet->get_id()) {
+    reply.write(&data[0], sizeof(uint64_t)); //The send time.
+  } else {
+    reply.write(&data[0], static_cast<uint32_t>(data.size()));
+  }
+  if (kPacketIdBroadcast == packet->get_id()) {
+    for (int16_t id : g_server_connections) {
+      auto target = g_listener->get(id);
+      if (target && !target->is_disconnect()) target->send(&reply);
+    }
+  } else {
+    connection->send(&reply);
+  }
+  return kPacketExecuteStatusContinue;
+}
+
+static uint32_t client_execute(pf_net::connection::Basic *connection,
+                               pf_net::packet::Dynamic *packet) {
+  uint64_t sendtime{0};
+  if (packet->size() < sizeof(sendtime)) return kPacketExecuteStatusContinue;
+  packet->read(reinterpret_cast<char *>(&sendtime), sizeof(sendtime));
+  auto now = pf_basic::Clock::now_us();
+  g_latencies.push_back(static_cast<uint32_t>(now - sendtime));
+  g_received_bytes += packet->size();
+  auto it = g_client_index.find(connection->get_id());
+  if (it != g_client_index.end()) ++g_clients[it->second].received;
+  return kPacketExecuteStatusContinue;
+}
+
+static uint32_t __stdcall packet_execute(pf_net::connection::Basic *connection,
+                                         pf_net::packet::Interface *packet) {
+  auto dynamic = dynamic_cast<pf_net::packet::Dynamic *>(packet);
+  if (is_null(dynamic)) return kPacketExecuteStatusError;
+  dynamic->set_readable(true);
+  return dynamic->get_id() >= kPacketIdReply ?
+    client_execute(connection, dynamic) : server_execute(connection, dynamic);
+}
+
+static void server_run(pf_net::connection::manager::Listener *listener) {
+  while (g_running) listener->tick();
+}
+
+static bool parse(int32_t argc, char **argv) {
+  std::map<std::string, std::string> args;
+  for (int32_t i = 1; i < argc; ++i) {
+    std::string arg{argv[i]};
+    if (arg.size() < 3 || arg.compare(0, 2, "--") != 0) return false;
+    auto position = arg.find('=');
+    if (std::string::npos == position) {
+      args[arg.substr(2)] = "1";
+    } else {
+      args[arg.substr(2, position - 2)] = arg.substr(position + 1);
+    }
+  }
+  if (args.count("scenario")) g_option.scenario = args["scenario"];
+  //The scenario defaults.
+  if ("idle" == g_option.scenario) {
+    g_option.connections = 1000;
+    g_option.rate = 100;
+    g_option.mode = "request";
+  } else if ("storm" == g_option.scenario) {
+    g_option.connections = 100;
+    g_option.mode = "echo";
+  } else if ("large" == g_option.scenario) {
+    g_option.connections = 10;
+    g_option.mode = "echo";
+    g_option.size = 32 * 1024;
+  } else if ("broadcast" == g_option.scenario) {
+    g_option.connections = 200;
+    g_option.rate = 50;
+    g_option.mode = "broadcast";
+    g_option.size = 128;
+  } else {
+    return false;
+  }
+  for (auto &it : args) {
+    const std::string &name = it.first;
+    const char *value = it.second.c_str();
+    if ("scenario" == name) {
+      continue;
+    } else if ("connections" == name) {
+      g_option.connections = atoi(value);
+    } else if ("seconds" == name) {
+      g_option.seconds = atof(value);
+    } else if ("rate" == name) {
+      g_option.rate = atof(value);
+    } else if ("mode" == name) {
+      g_option.mode = value;
+    } else if ("size" == name) {
+      g_option.size = static_cast<uint32_t>(atoi(value));
+    } else if ("compress" == name) {
+      g_option.compress = true;
+    } else if ("encrypt" == name) {
+      g_option.encrypt = true;
+    } else if ("format" == name) {
+      g_option.format = value;
+    } else {
+      return false;
+    }
+  }
+  if (g_option.mode != "echo" &&
+      g_option.mode != "request" &&
+      g_option.mode != "broadcast") return false;
+  if (g_option.connections <= 0) g_option.connections = 1;
+  if (g_option.connections > NET_CONNECTION_MAX - 2)
+    g_option.connections = NET_CONNECTION_MAX - 2;
+  if (g_option.size < sizeof(uint64_t)) g_option.size = sizeof(uint64_t);
+  if (g_option.size > 64 * 1024) g_option.size = 64 * 1024;
+  return true;
+}
+
+static uint64_t rss_kb() {
+  std::ifstream file("/proc/self/status");
+  std::string line;
+  while (std::getline(file, line)) {
+    if (0 == line.compare(0, 6, "VmRSS:"))
+      return strtoull(line.c_str() + 6, nullptr, 10);
+  }
+  return 0;
+}
+
+static double cpu_seconds() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+//The seconds from the start(the microseconds of the monotonic clock).
+static double seconds_since(uint64_t start_us) {
+  return (pf_basic::Clock::now_us() - start_us) / 1000000.0;
+}
+
+static double mbps(uint64_t bytes, double seconds) {
+  return seconds > 0 ? bytes / seconds / (1024.0 * 1024.0) : 0;
+}
+
+//Get the percentile from the sorted values.
+static uint32_t percentile(const std::vector<uint32_t> &sorted, double p) {
+  if (sorted.empty()) return 0;
+  return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+}
+
+int32_t main(int32_t argc, char **argv) {
+  using namespace pf_basic;
+  using namespace pf_net;
+  if (!parse(argc, argv)) {
+    printf("usage: %s [--scenario=idle|storm|large|broadcast]"
+           " [--connections=n] [--seconds=n] [--rate=n]"
+           " [--mode=echo|request|broadcast] [--size=bytes]"
+           " [--compress] [--encrypt] [--format=console|json]\n",
+           argv[0]);
+    return 1;
+  }
+  GLOBALS["log.print"] = false;
+  auto time_manager = new TimeManager();
+  unique_move(TimeManager, time_manager, g_time_manager);
+  g_time_manager->init();
+  auto logger = new Logger();
+  unique_move(Logger, logger, g_logger);
+  auto factory_manager = new packet::FactoryManager();
+  unique_move(packet::FactoryManager, factory_manager, g_packetfactory_manager);
+  g_packetfactory_manager->set_size(1);
+  g_packetfactory_manager->set_function_is_valid_dynamic_packet_id(
+      is_dynamic_packet_id);
+  g_packetfactory_manager->set_function_packet_execute(packet_execute);
+  g_packetfactory_manager->init();
+
+  //The server.
+  auto count = static_cast<uint16_t>(g_option.connections + 2);
+  connection::manager::Listener listener;
+  if (!listener.init(count, 0, "127.0.0.1")) {
+    printf("listener init failed\n");
+    return 1;
+  }
+  g_listener = &listener;
+  listener.callback_connect([](connection::Basic *connection) {
+    connection_setup(connection);
+    g_server_connections.push_back(connection->get_id());
+  });
+  listener.callback_disconnect([](connection::Basic *connection) {
+    auto &ids = g_server_connections;
+    ids.erase(std::remove(ids.begin(), ids.end(), connection->get_id()),
+              ids.end());
+  });
+
+  //The clients, connect before the server thread(the listener not locked).
+  connection::manager::Connector connector;
+  if (!connector.init(count)) {
+    printf("connector init failed\n");
+    return 1;
+  }
+  connector.callback_disconnect([](connection::Basic *) { ++g_disconnects; });
+  for (int32_t i = 0; i < g_option.connections; ++i) {
+    auto connection = connector.connect("127.0.0.1", listener.port());
+    if (is_null(connection)) {
+      printf("connect failed at %d\n", i);
+      return 1;
+    }
+    connection_setup(connection);
+    client_t client;
+    client.id = connection->get_id();
+    g_client_index[client.id] = g_clients.size();
+    g_clients.push_back(client);
+    listener.tick(); //The listen backlog is small.
+  }
+  for (int32_t i = 0; i < 100 && listener.size() < g_option.connections; ++i)
+    listener.tick();
+  std::thread server(server_run, &listener);
+
+  uint16_t packet_id = "echo" == g_option.mode ? kPacketIdEcho :
+    ("request" == g_option.mode ? kPacketIdRequest : kPacketIdBroadcast);
+  //The replies not received of one client, keep the output under the max.
+  uint64_t window = NETOUTPUT_DISCONNECT_MAXSIZE / 2 / (g_option.size + 16);
+  if (window < 1) window = 1;
+  if (window > 8) window = 8;
+  std::vector<char> payload(g_option.size, 'x');
+  g_latencies.reserve(1024 * 1024);
+  uint64_t sent{0};
+  uint64_t broadcasts{0};
+  uint64_t blocked{0};
+  uint64_t ticks{0};
+  size_t next{0};
+  double cpu_start = cpu_seconds();
+  auto start_us = pf_basic::Clock::now_us();
+  for (;;) {
+    double elapsed = seconds_since(start_us);
+    if (elapsed >= g_option.seconds) break;
+    uint64_t due = g_option.rate > 0 ?
+      static_cast<uint64_t>(elapsed * g_option.rate) - sent :
+      g_clients.size();
+    bool idle{true};
+    for (uint64_t i = 0; i < due; ++i) {
+      auto &client = g_clients[next];
+      next = (next + 1) % g_clients.size();
+      //Each broadcast replies to all the clients.
+      uint64_t replies = kPacketIdBroadcast == packet_id ? 
+        broadcasts : client.sent;
+      if (replies - client.received >= window) {
+        ++blocked;
+        if (g_option.rate > 0) ++sent; //Not catch up later.
+        continue;
+      }
+      auto connection = connector.get(client.id);
+      if (is_null(connection) || connection->is_disconnect()) continue;
+      uint64_t now = Clock::now_us();
+      memcpy(&payload[0], &now, sizeof(now));
+      packet::Dynamic packet(packet_id);
+      packet.write(&payload[0], static_cast<uint32_t>(payload.size()));
+      connection->send(&packet);
+      ++client.sent;
+      ++sent;
+      if (kPacketIdBroadcast == packet_id) ++broadcasts;
+      idle = false;
+    }
+    connector.tick();
+    ++ticks;
+    if (idle) std::this_thread::yield(); //Let the server run(one cpu).
+  }
+  double seconds = seconds_since(start_us);
+  double cpu = cpu_seconds() - cpu_start;
+  g_running = false;
+  server.join();
+
+  std::sort(g_latencies.begin(), g_latencies.end());
+  uint64_t received = g_latencies.size();
+  double cpu_percent = seconds > 0 ? cpu * 100 / seconds : 0;
+  if ("json" == g_option.format) {
+    printf("{\"scenario\": \"%s\", \"mode\": \"%s\", \"connections\": %d,"
+           " \"size\": %u, \"compress\": %s, \"encrypt\": %s,"
+           " \"seconds\": %.2f, \"sent\": %" PRIu64 ", \"received\": %"
+           PRIu64 ", \"server_packets\": %" PRIu64 ", \"blocked\": %" PRIu64
+           ", \"disconnects\": %" PRIu64 ", \"packets_per_second\": %.0f,"
+           " \"mb_per_second\": %.3f, \"latency_us\": {\"p50\": %u,"
+           " \"p90\": %u, \"p99\": %u, \"p999\": %u, \"max\": %u},"
+           " \"cpu_percent\": %.1f, \"rss_kb\": %" PRIu64 "}\n",
+           g_option.scenario.c_str(), g_option.mode.c_str(),
+           g_option.connections, g_option.size,
+           g_option.compress ? "true" : "false",
+           g_option.encrypt ? "true" : "false",
+           seconds, sent, received, g_server_packets.load(), blocked,
+           g_disconnects.load(), received / seconds,
+           mbps(g_received_bytes, seconds),
+           percentile(g_latencies, 0.5),
+           percentile(g_latencies, 0.9),
+           percentile(g_latencies, 0.99),
+           percentile(g_latencies, 0.999),
+           g_latencies.empty() ? 0 : g_latencies.back(),
+           cpu_percent, rss_kb());
+    return 0;
+  }
+  printf("scenario: %s, mode: %s, connections: %d, size: %u,"
+         " compress: %d, encrypt: %d\n",
+         g_option.scenario.c_str(), g_option.mode.c_str(),
+         g_option.connections, g_option.size,
+         g_option.compress, g_option.encrypt);
+  printf("  seconds: %.2f, client ticks: %" PRIu64 ", sent: %" PRIu64
+         ", received: %" PRIu64 ", server packets: %" PRIu64 "\n",
+         seconds, ticks, sent, received, g_server_packets.load());
+  printf("  blocked by window: %" PRIu64 ", disconnects: %" PRIu64 "\n",
+         blocked, g_disconnects.load());
+  printf("  throughput: %.0f packets/s, %.2f MB/s\n",
+         received / seconds, mbps(g_received_bytes, seconds));
+  printf("  latency us: p50 %u, p90 %u, p99 %u, p99.9 %u, max %u\n",
+         percentile(g_latencies, 0.5),
+         percentile(g_latencies, 0.9),
+         percentile(g_latencies, 0.99),
+         percentile(g_latencies, 0.999),
+         g_latencies.empty() ? 0 : g_latencies.back());
+  printf("  cpu: %.1f%%, rss: %" PRIu64 " KB\n", cpu_percent, rss_kb());
+  return 0;
+}
+
+#else
+
+int32_t main(int32_t, char **) {
+  printf("load_bench only support unix\n");
+  return 0;
+}
+
+#endif
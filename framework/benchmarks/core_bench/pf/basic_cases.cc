@@ -0,0 +1,107 @@
+#include <benchmark/benchmark.h>
+#include "pf/basic/logger.h"
+#include "pf/basic/type/variable.h"
+#include "pf/util/compressor/minimanager.h"
+
+//The basic cases: the mini compressor, the fast log and the variable
+//conversions.
+
+using namespace pf_basic;
+
+//The packet like data(ids, names and small numbers).
+static std::vector<unsigned char> packet_data(uint32_t size) {
+  std::vector<unsigned char> result;
+  std::mt19937 engine(20171019);
+  auto rng = [&engine]() { return static_cast<uint32_t>(engine()); };
+  char line[128]{0};
+  while (result.size() < size) {
+    snprintf(line, sizeof(line), "player:%u pos(%u,%u) hp:%u;",
+             rng() % 1000, rng() % 1024, rng() % 1024, rng() % 100000);
+    result.insert(result.end(), line, line + strlen(line));
+  }
+  result.resize(size);
+  return result;
+}
+
+static pf_util::compressor::MiniManager &minimanager() {
+  static pf_util::compressor::MiniManager *result{nullptr};
+  if (is_null(result)) {
+    result = new pf_util::compressor::MiniManager();
+    result->init();
+  }
+  return *result;
+}
+
+static void minimanager_compress(benchmark::State &state) {
+  auto &manager = minimanager();
+  auto data = packet_data(4096);
+  std::vector<unsigned char> out(data.size() * 2);
+  for (auto _ : state) {
+    uint32_t size = static_cast<uint32_t>(out.size());
+    manager.compress(&data[0], static_cast<uint32_t>(data.size()),
+                     &out[0], size);
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(minimanager_compress);
+
+static void minimanager_decompress(benchmark::State &state) {
+  auto &manager = minimanager();
+  auto data = packet_data(4096);
+  std::vector<unsigned char> out(data.size() * 2);
+  std::vector<unsigned char> back(data.size());
+  uint32_t outsize = static_cast<uint32_t>(out.size());
+  if (!manager.compress(&data[0], static_cast<uint32_t>(data.size()),
+                        &out[0], outsize)) {
+    state.SkipWithError("compress failed");
+    return;
+  }
+  for (auto _ : state) {
+    uint32_t size = static_cast<uint32_t>(back.size());
+    manager.decompress(&out[0], outsize, &back[0], size);
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(minimanager_decompress);
+
+static void logger_fast(benchmark::State &state) {
+  uint64_t i{0};
+  for (auto _ : state) {
+    FAST_WRITELOG("pf_bench",
+                  "[bench] (logger_fast) player: %" PRIu64 ", value: %d",
+                  i,
+                  12345);
+    //Save to the file as the log thread does, not drop the full cache.
+    if (0 == ++i % 10000) LOGSYSTEM_POINTER->flush_log("pf_bench");
+  }
+  LOGSYSTEM_POINTER->flush_log("pf_bench");
+}
+BENCHMARK(logger_fast);
+
+//The binary mode is decided when the log registered.
+static void logger_fast_binary(benchmark::State &state) {
+  GLOBALS["log.binary"] = true;
+  uint64_t i{0};
+  for (auto _ : state) {
+    FAST_WRITELOG("pf_bench_binary",
+                  "[bench] (logger_fast) player: %" PRIu64 ", value: %d",
+                  i,
+                  12345);
+    ++i;
+  }
+  LOGSYSTEM_POINTER->flush_log("pf_bench_binary");
+  GLOBALS["log.binary"] = false;
+}
+BENCHMARK(logger_fast_binary);
+
+static void variable_convert(benchmark::State &state) {
+  int32_t i{0};
+  for (auto _ : state) {
+    type::variable_t number = i++;
+    type::variable_t text = number.c_str();
+    benchmark::DoNotOptimize(text.get<uint32_t>());
+    type::variable_t real = 1.5;
+    benchmark::DoNotOptimize(real.get<double>() + real.get<int32_t>());
+  }
+}
+BENCHMARK(variable_convert);
@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+#include "pf/sys/memory/sharemap.h"
+#include "pf/cache/db_store.h"
+
+//The cache cases: the share memory map and the db store(SysV share memory
+//keys 0xbe0001-0xbe0005, removed at the exit). The maps and the rows are
+//created once before the timed loops.
+
+#define BENCH_SHAREMAP_KEY (0xbe0001)
+#define BENCH_CACHE_KEY_MAP (0xbe0002)
+#define BENCH_CACHE_RECYCLE_MAP (0xbe0003)
+#define BENCH_CACHE_QUERY_MAP (0xbe0004)
+#define BENCH_CACHE_POOL (0xbe0005)
+#define BENCH_CACHE_ROWS (10000)
+
+static const char *kCacheConfig = "/tmp/pf_bench_cache.txt";
+
+//Remove the share memory at the exit(after the map and the store).
+static struct cleanup_struct {
+  ~cleanup_struct() {
+    using namespace pf_sys::memory::share;
+    for (uint32_t key = BENCH_SHAREMAP_KEY; key <= BENCH_CACHE_POOL; ++key) {
+      auto handle = api::open(key, 0, false);
+      if (handle != HANDLE_INVALID) api::close(handle);
+    }
+  }
+} g_cleanup;
+
+static pf_sys::memory::share::Map &sharemap() {
+  static std::unique_ptr<pf_sys::memory::share::Map> result{nullptr};
+  if (is_null(result)) {
+    result.reset(new pf_sys::memory::share::Map());
+    result->init(BENCH_SHAREMAP_KEY, 20000, 64, 64, true);
+  }
+  return *result;
+}
+
+static void sharemap_set(benchmark::State &state) {
+  auto &map = sharemap();
+  char key[64]{0};
+  char value[64]{0};
+  uint64_t i{0};
+  for (auto _ : state) {
+    snprintf(key, sizeof(key), "key_%" PRIu64, i % 10000);
+    snprintf(value, sizeof(value), "value_%" PRIu64, i);
+    map.set(key, value);
+    ++i;
+  }
+}
+BENCHMARK(sharemap_set);
+
+static void sharemap_get(benchmark::State &state) {
+  auto &map = sharemap();
+  char key[64]{0};
+  for (uint64_t i = 0; i < 10000; ++i) {
+    snprintf(key, sizeof(key), "key_%" PRIu64, i);
+    map.set(key, "value");
+  }
+  uint64_t i{0};
+  for (auto _ : state) {
+    snprintf(key, sizeof(key), "key_%" PRIu64, i % 10000);
+    benchmark::DoNotOptimize(map.get(key));
+    ++i;
+  }
+}
+BENCHMARK(sharemap_get);
+
+static pf_cache::DBStore &dbstore() {
+  static std::unique_ptr<pf_cache::DBStore> result{nullptr};
+  if (is_null(result)) {
+    FILE *fp = fopen(kCacheConfig, "w");
+    if (fp) {
+      fprintf(fp,
+              "STRING\tINT\tINT\tSTRING\tINT\tINT\tINT\tINT\tINT\tINT\n"
+              "index\tsize\tsame_columns\tsave_columns\tno_save\t"
+              "save_interval\tgroup_index\tshare_key\trecycle_size\t"
+              "data_size\n"
+              "t_player\t%d\t1\tid\t0\t0\t0\t%d\t100\t256\n",
+              BENCH_CACHE_ROWS * 2,
+              BENCH_CACHE_POOL);
+      fclose(fp);
+    }
+    result.reset(new pf_cache::DBStore());
+    result->set_key(
+        BENCH_CACHE_KEY_MAP, BENCH_CACHE_RECYCLE_MAP, BENCH_CACHE_QUERY_MAP);
+    result->set_service(true);
+    result->load_config(kCacheConfig);
+    result->init();
+  }
+  return *result;
+}
+
+static void dbstore_put_forget(benchmark::State &state) {
+  auto &store = dbstore();
+  char key[64]{0};
+  char value[256]{0};
+  snprintf(value, sizeof(value), "player data");
+  uint64_t i{0};
+  for (auto _ : state) {
+    snprintf(key, sizeof(key), "t_player#%" PRIu64,
+             BENCH_CACHE_ROWS + i % BENCH_CACHE_ROWS);
+    store.put(key, value, 0);
+    store.forget(key);
+    ++i;
+  }
+}
+BENCHMARK(dbstore_put_forget);
+
+static void dbstore_get(benchmark::State &state) {
+  auto &store = dbstore();
+  char key[64]{0};
+  char value[256]{0};
+  snprintf(value, sizeof(value), "player data");
+  for (uint64_t i = 0; i < BENCH_CACHE_ROWS; ++i) {
+    snprintf(key, sizeof(key), "t_player#%" PRIu64, i);
+    if (is_null(store.get(key))) store.put(key, value, 0);
+  }
+  uint64_t i{0};
+  for (auto _ : state) {
+    snprintf(key, sizeof(key), "t_player#%" PRIu64, i % BENCH_CACHE_ROWS);
+    benchmark::DoNotOptimize(store.get(key));
+    ++i;
+  }
+}
+BENCHMARK(dbstore_get);
@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+#include "pf/file/tab.h"
+#include "pf/db/connection.h"
+#include "pf/db/query/builder.h"
+#include "pf/db/query/grammars/mysql_grammar.h"
+
+//The data cases: the tab file load and the query builder compile.
+
+static std::string tab_content(uint32_t lines) {
+  std::string result{"INT\tINT\tFLOAT\tSTRING\tSTRING\n"
+                     "id\tlevel\texp\tname\tdesc\n"};
+  char line[256]{0};
+  for (uint32_t i = 0; i < lines; ++i) {
+    snprintf(line, sizeof(line), "%u\t%u\t%u.5\titem_%u\tthe item %u desc\n",
+             i + 1, i % 100, i, i, i);
+    result += line;
+  }
+  return result;
+}
+
+static void tab_load(benchmark::State &state) {
+  auto content = tab_content(1000);
+  for (auto _ : state) {
+    pf_file::Tab tab(0);
+    tab.open_from_memory(content.c_str(), content.c_str() + content.size() + 1);
+    benchmark::DoNotOptimize(tab.get_record_number());
+  }
+  state.SetBytesProcessed(state.iterations() * content.size());
+}
+BENCHMARK(tab_load);
+
+static void builder_compile(benchmark::State &state) {
+  using namespace pf_db::query;
+  pf_db::Connection connection(nullptr);
+  grammars::MysqlGrammar grammar;
+  for (auto _ : state) {
+    Builder builder(&connection, &grammar);
+    builder.select({"id", "name", "level"}).
+            from("t_player").
+            where("level", ">", 10).
+            where_in("guild", {1, 2, 3}).
+            order_by("id", "desc").
+            limit(20);
+    benchmark::DoNotOptimize(builder.to_sql());
+  }
+}
+BENCHMARK(builder_compile);
@@ -0,0 +1,139 @@
+#include <benchmark/benchmark.h>
+#include "pf/net/socket/basic.h"
+#include "pf/net/stream/input.h"
+#include "pf/net/stream/output.h"
+#include "pf/net/stream/encryptor.h"
+#include "pf/net/packet/factorymanager.h"
+#include "pf/cache/packet/db_query.h"
+
+//The net cases: streams over a socketpair, the encryptor and the packet
+//create/remove of the factory manager.
+
+using namespace pf_net;
+
+//The argument is the bytes of each write.
+static void stream_socketpair(benchmark::State &state) {
+  auto size = static_cast<uint32_t>(state.range(0));
+  int32_t fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    state.SkipWithError("socketpair failed");
+    return;
+  }
+  socket::Basic writer;
+  socket::Basic reader;
+  writer.set_id(fds[0]);
+  reader.set_id(fds[1]);
+  writer.set_nonblocking();
+  reader.set_nonblocking();
+  stream::Output ostream(&writer);
+  stream::Input istream(&reader);
+  ostream.init();
+  istream.init();
+  std::vector<char> data(size, 'x');
+  std::vector<char> back(size);
+  for (auto _ : state) {
+    ostream.write(&data[0], size);
+    while (ostream.size() > 0 || istream.size() < size) {
+      if (ostream.flush() < 0 || istream.fill() < 0) {
+        state.SkipWithError("stream broken");
+        return;
+      }
+    }
+    istream.read(&back[0], size);
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(stream_socketpair)->Arg(64)->Arg(1024)->Arg(16 * 1024);
+
+static void stream_values(benchmark::State &state) {
+  int32_t fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    state.SkipWithError("socketpair failed");
+    return;
+  }
+  socket::Basic writer;
+  socket::Basic reader;
+  writer.set_id(fds[0]);
+  reader.set_id(fds[1]);
+  writer.set_nonblocking();
+  reader.set_nonblocking();
+  stream::Output ostream(&writer);
+  stream::Input istream(&reader);
+  ostream.init();
+  istream.init();
+  //One packet like body each iteration.
+  const uint32_t size = 4 + 2 + 8 + 4 + 4;
+  uint64_t i{0};
+  for (auto _ : state) {
+    ostream.write_uint32(static_cast<uint32_t>(i));
+    ostream.write_int16(7);
+    ostream.write_uint64(i++);
+    ostream.write_string("name");
+    while (ostream.size() > 0 || istream.size() < size) {
+      if (ostream.flush() < 0 || istream.fill() < 0) {
+        state.SkipWithError("stream broken");
+        return;
+      }
+    }
+    istream.read_uint32();
+    istream.read_int16();
+    istream.read_uint64();
+    std::string name;
+    istream.read_string(name, 32);
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(stream_values);
+
+static void encryptor(benchmark::State &state) {
+  stream::Encryptor encryptor;
+  encryptor.setkey("0123456789abcdef");
+  encryptor.enable(true);
+  std::vector<char> data(4096, 'x');
+  std::vector<char> out(4096);
+  for (auto _ : state) {
+    encryptor.encrypt(&out[0], &data[0], static_cast<uint32_t>(data.size()));
+    encryptor.decrypt(&data[0], &out[0], static_cast<uint32_t>(out.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * data.size() * 2);
+}
+BENCHMARK(encryptor);
+
+static bool __stdcall is_dynamic_packet_id(uint16_t id) {
+  return id >= 0xff00;
+}
+
+static packet::FactoryManager &factory_manager() {
+  if (is_null(g_packetfactory_manager)) {
+    auto manager = new packet::FactoryManager();
+    unique_move(packet::FactoryManager, manager, g_packetfactory_manager);
+    g_packetfactory_manager->set_size(8);
+    g_packetfactory_manager->set_function_is_valid_dynamic_packet_id(
+        is_dynamic_packet_id);
+    g_packetfactory_manager->init();
+    auto factory = new pf_cache::packet::DBQueryFactory();
+    factory->set_id(1);
+    g_packetfactory_manager->add_factory(factory);
+  }
+  return *g_packetfactory_manager;
+}
+
+static void packet_create_remove(benchmark::State &state) {
+  auto &manager = factory_manager();
+  for (auto _ : state) {
+    auto packet = manager.packet_create(1);
+    packet->set_id(1); //As the protocol.
+    manager.packet_remove(packet);
+  }
+}
+BENCHMARK(packet_create_remove);
+
+static void packet_create_remove_dynamic(benchmark::State &state) {
+  auto &manager = factory_manager();
+  for (auto _ : state) {
+    auto packet = manager.packet_create(0xff01);
+    packet->set_id(0xff01);
+    manager.packet_remove(packet);
+  }
+}
+BENCHMARK(packet_create_remove_dynamic);
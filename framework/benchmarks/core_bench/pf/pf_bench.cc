@@ -0,0 +1,24 @@
+#include <benchmark/benchmark.h>
+#include "pf/basic/time_manager.h"
+#include "pf/basic/logger.h"
+#include "pf/basic/global.h"
+
+//Usage: pf_bench [--benchmark_filter=regex] [--benchmark_min_time=seconds]
+//                [--benchmark_format=console|csv|json]
+//The hot paths of the framework(google benchmark), one case each line. The
+//csv and json outputs are for comparing the results of the commits.
+
+int32_t main(int32_t argc, char **argv) {
+  using namespace pf_basic;
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  GLOBALS["log.print"] = false;
+  GLOBALS["log.directory"] = "/tmp";
+  auto time_manager = new TimeManager();
+  unique_move(TimeManager, time_manager, g_time_manager);
+  g_time_manager->init();
+  auto logger = new Logger();
+  unique_move(Logger, logger, g_logger);
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include "pf/sys/thread.h"
+#include "pf/sys/work_pool.h"
+#include "pf/basic/clock.h"
+
+//Usage: pool_bench [tasks] [max threads]
+//The tasks per second of the ThreadPool and the WorkPool(post, bulk and
+//parallel for), the thread count from 1 to the max(doubled each time).
+
+static std::atomic<uint64_t> g_done{0};
+
+static void wait_done(uint64_t count) {
+  while (g_done < count) std::this_thread::yield();
+}
+
+//The seconds from the start(the microseconds of the monotonic clock).
+static double seconds_since(uint64_t start_us) {
+  return (pf_basic::Clock::now_us() - start_us) / 1000000.0;
+}
+
+static double thread_pool(size_t threads, uint64_t tasks) {
+  g_done = 0;
+  pf_sys::ThreadPool pool(threads);
+  auto start_us = pf_basic::Clock::now_us();
+  for (uint64_t i = 0; i < tasks; ++i)
+    pool.enqueue([]() { ++g_done; });
+  wait_done(tasks);
+  return tasks / seconds_since(start_us);
+}
+
+static double work_pool_post(size_t threads, uint64_t tasks) {
+  g_done = 0;
+  pf_sys::WorkPool pool(threads);
+  auto start_us = pf_basic::Clock::now_us();
+  for (uint64_t i = 0; i < tasks; ++i)
+    pool.post([]() { ++g_done; });
+  wait_done(tasks);
+  return tasks / seconds_since(start_us);
+}
+
+static double work_pool_bulk(size_t threads, uint64_t tasks) {
+  g_done = 0;
+  pf_sys::WorkPool pool(threads);
+  std::vector< std::function<void()> > functions;
+  const uint64_t batch = 1024;
+  functions.assign(batch, []() { ++g_done; });
+  uint64_t total = 0;
+  auto start_us = pf_basic::Clock::now_us();
+  for (; total < tasks; total += batch)
+    pool.enqueue_bulk(functions.begin(), functions.end());
+  wait_done(total);
+  return total / seconds_since(start_us);
+}
+
+static double work_pool_for(size_t threads, uint64_t tasks) {
+  pf_sys::WorkPool pool(threads);
+  std::vector<uint64_t> values(tasks, 1);
+  auto start_us = pf_basic::Clock::now_us();
+  pool.parallel_for(0, values.size(), [&values](size_t i) {
+    values[i] = values[i] * 2 + 1;
+  });
+  return tasks / seconds_since(start_us);
+}
+
+int32_t main(int32_t argc, char **argv) {
+  uint64_t tasks = argc > 1 ? strtoull(argv[1], nullptr, 10) : 200000;
+  size_t threads_max = argc > 2 ? atoi(argv[2]) : 4;
+  if (0 == tasks) tasks = 1;
+  if (0 == threads_max) threads_max = 1;
+  printf("tasks: %" PRIu64 ", cpus: %u\n",
+         tasks, std::thread::hardware_concurrency());
+  printf("%8s %14s %14s %14s %14s\n",
+         "threads", "thread_pool", "work_post", "work_bulk", "parallel_for");
+  for (size_t threads = 1; threads <= threads_max; threads *= 2) {
+    printf("%8zu %14.0f %14.0f %14.0f %14.0f\n",
+           threads,
+           thread_pool(threads, tasks),
+           work_pool_post(threads, tasks),
+           work_pool_bulk(threads, tasks),
+           work_pool_for(threads, tasks));
+  }
+  return 0;
+}
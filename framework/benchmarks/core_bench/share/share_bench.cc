@@ -0,0 +1,127 @@
+#include "pf/basic/time_manager.h"
+#include "pf/basic/logger.h"
+#include "pf/sys/memory/share.h"
+#include "pf/basic/clock.h"
+
+//Usage: share_bench [megabytes] [accesses]
+//The init time and the random item access cost of a group pool segment on
+//each backend(sysv, posix shm, file) and page option(4k, huge advise and
+//huge tlb). The huge page rows fail when the system not reserve the pages.
+
+using namespace pf_sys::memory::share;
+
+typedef struct case_struct {
+  const char *name;
+  option_t option;
+} case_t;
+
+static const int16_t kGroupCount = 8;
+static const size_t kItemSize = 1024;
+
+static std::vector<group_item_t> make_group(size_t megabytes) {
+  size_t items = megabytes * 1024 * 1024 / kItemSize / kGroupCount;
+  if (0 == items) items = 1;
+  std::vector<group_item_t> group;
+  for (int16_t i = 0; i < kGroupCount; ++i) {
+    group_item_t item;
+    item.index = i;
+    item.size = items;
+    item.data_size = kItemSize;
+    group.push_back(item);
+  }
+  return group;
+}
+
+//The seconds from the start(the microseconds of the monotonic clock).
+static double seconds_since(uint64_t start_us) {
+  return (pf_basic::Clock::now_us() - start_us) / 1000000.0;
+}
+
+static void run(const case_t &test, 
+                uint32_t key, 
+                const std::vector<group_item_t> &group,
+                uint64_t accesses) {
+  set_option(key, test.option);
+  auto start_us = pf_basic::Clock::now_us();
+  bool result{false};
+  double init_ms{0}, access_ns{0};
+  uint64_t sum{0};
+  size_t size = sizeof(header_t) + sizeof(group_header_t);
+  {
+    GroupPool pool(key, group);
+    size += pool.size();
+    result = pool.init(true);
+    init_ms = seconds_since(start_us) * 1000;
+    if (result) {
+      std::mt19937 random(key);
+      auto items = static_cast<uint32_t>(group[0].size);
+      start_us = pf_basic::Clock::now_us();
+      for (uint64_t i = 0; i < accesses; ++i) {
+        auto index = static_cast<int16_t>(random() % kGroupCount);
+        auto data_index = static_cast<int32_t>(random() % items);
+        char *data = pool.item_data(index, data_index);
+        sum += static_cast<uint8_t>(data[random() % kItemSize]);
+        data[0] = static_cast<char>(i);
+      }
+      access_ns = seconds_since(start_us) * 1e9 / accesses;
+    }
+  }
+  if (result) {
+    printf("%-14s %12.2f %12.2f %8" PRIu64 "\n", 
+           test.name, init_ms, access_ns, sum % 10);
+  } else {
+    printf("%-14s %12s %12s\n", test.name, "failed", "-");
+  }
+  //Remove the segment(the pool not unmap it, so keep the size small).
+  Base base;
+  if (base.attach(key, size, false)) base.release();
+}
+
+int32_t main(int32_t argc, char **argv) {
+  using namespace pf_basic;
+  size_t megabytes = argc > 1 ? atoi(argv[1]) : 128;
+  uint64_t accesses = argc > 2 ? strtoull(argv[2], nullptr, 10) : 5000000;
+  if (0 == megabytes) megabytes = 1;
+  if (0 == accesses) accesses = 1;
+  GLOBALS["log.print"] = false;
+  auto time_manager = new TimeManager();
+  unique_move(TimeManager, time_manager, g_time_manager);
+  g_time_manager->init();
+  auto logger = new Logger();
+  unique_move(Logger, logger, g_logger);
+
+  std::vector<case_t> tests;
+  case_t test;
+  test.name = "sysv";
+  test.option.lazy_zero = false;
+  tests.push_back(test);
+  test.name = "sysv_lazy";
+  test.option.lazy_zero = true;
+  tests.push_back(test);
+  test.name = "sysv_tlb";
+  test.option.huge_page = kHugePageTLB;
+  tests.push_back(test);
+  test.name = "posix";
+  test.option = option_t();
+  test.option.backend = kBackendPosix;
+  tests.push_back(test);
+  test.name = "posix_populate";
+  test.option.populate = true;
+  tests.push_back(test);
+  test.name = "posix_advise";
+  test.option.populate = false;
+  test.option.huge_page = kHugePageAdvise;
+  tests.push_back(test);
+  test.name = "file_advise";
+  test.option.backend = kBackendFile;
+  tests.push_back(test);
+
+  auto group = make_group(megabytes);
+  printf("segment: %zu MB, accesses: %" PRIu64 "\n", 
+         group[0].size * kItemSize * kGroupCount / (1024 * 1024), accesses);
+  printf("%-14s %12s %12s %8s\n", "case", "init_ms", "access_ns", "check");
+  uint32_t key = 0x5f000000 + (static_cast<uint32_t>(getpid()) & 0xffff) * 16;
+  for (size_t i = 0; i < tests.size(); ++i)
+    run(tests[i], key + static_cast<uint32_t>(i), group, accesses);
+  return 0;
+}
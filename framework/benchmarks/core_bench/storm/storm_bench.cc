@@ -0,0 +1,104 @@
+#include "pf/basic/time_manager.h"
+#include "pf/basic/logger.h"
+#include "pf/net/connection/basic.h"
+#include "pf/net/connection/manager/listener.h"
+#include "pf/basic/clock.h"
+
+#if OS_UNIX
+
+//Usage: storm_bench [client threads] [seconds] [min accepts per second]
+//The local clients connect and close(RST, no TIME_WAIT) as fast as they can,
+//the main thread ticks the listener. Exit 1 if the accept rate is lower than
+//the min(default 20000).
+
+static std::atomic<bool> g_running{true};
+static std::atomic<uint64_t> g_connects{0};
+static std::atomic<uint64_t> g_failures{0};
+
+static void client_storm(uint16_t port) {
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = inet_addr("127.0.0.1");
+  struct linger reset;
+  reset.l_onoff = 1;
+  reset.l_linger = 0;
+  while (g_running) {
+    int32_t fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+      ++g_failures;
+      continue;
+    }
+    setsockopt(fd, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+    if (::connect(fd, reinterpret_cast<struct sockaddr *>(&address),
+                  sizeof(address)) != 0) {
+      ++g_failures;
+    } else {
+      ++g_connects;
+    }
+    ::close(fd);
+  }
+}
+
+//The seconds from the start(the microseconds of the monotonic clock).
+static double seconds_since(uint64_t start_us) {
+  return (pf_basic::Clock::now_us() - start_us) / 1000000.0;
+}
+
+int32_t main(int32_t argc, char **argv) {
+  using namespace pf_basic;
+  int32_t threads = argc > 1 ? atoi(argv[1]) : 2;
+  double duration = argc > 2 ? atof(argv[2]) : 3.0;
+  double limit = argc > 3 ? atof(argv[3]) : 20000.0;
+  if (threads <= 0) threads = 1;
+  GLOBALS["log.print"] = false;
+  auto time_manager = new TimeManager();
+  unique_move(TimeManager, time_manager, g_time_manager);
+  g_time_manager->init();
+  auto logger = new Logger();
+  unique_move(Logger, logger, g_logger);
+
+  pf_net::connection::manager::Listener listener;
+  if (!listener.init(NET_CONNECTION_MAX, 0, "127.0.0.1")) {
+    printf("listener init failed\n");
+    return 1;
+  }
+  listener.set_socket_option(pf_net::socket::option_lowlatency());
+  listener.set_onestep_accept(-1);
+  uint64_t accepts = 0;
+  listener.callback_connect([&accepts](pf_net::connection::Basic *) {
+    ++accepts;
+  });
+
+  std::vector<std::thread> clients;
+  for (int32_t i = 0; i < threads; ++i)
+    clients.push_back(std::thread(client_storm, listener.port()));
+  auto start_us = pf_basic::Clock::now_us();
+  uint64_t ticks = 0;
+  while (seconds_since(start_us) < duration) {
+    listener.tick();
+    ++ticks;
+  }
+  double seconds = seconds_since(start_us);
+  g_running = false;
+  for (auto &client : clients) client.join();
+
+  double rate = accepts / seconds;
+  printf("threads: %d, seconds: %.2f, ticks: %" PRIu64 "\n",
+         threads, seconds, ticks);
+  printf("  connects: %" PRIu64 ", failures: %" PRIu64 ", accepts: %" PRIu64
+         "\n", g_connects.load(), g_failures.load(), accepts);
+  printf("  accepts per second: %.0f (min %.0f), accepts per tick: %.2f\n",
+         rate, limit, ticks ? static_cast<double>(accepts) / ticks : 0);
+  return rate < limit ? 1 : 0;
+}
+
+#else
+
+int32_t main(int32_t, char **) {
+  printf("storm_bench only support unix\n");
+  return 0;
+}
+
+#endif
@@ -21,10 +21,13 @@
 #include "pf/basic/io.tcc"
 #include "pf/basic/logger.h"
 #include "pf/basic/md5.h"
+#include "pf/basic/metrics.h"
+#include "pf/basic/binary_log.h"
 #include "pf/basic/singleton.tcc"
 #include "pf/basic/string.h"
 #include "pf/basic/stringstream.h"
 #include "pf/basic/time_manager.h"
+#include "pf/basic/clock.h"
 #include "pf/basic/tinytimer.h"
 #include "pf/basic/util.h"
 
@@ -33,6 +36,7 @@
 #include "pf/cache/packet/db_result.h"
 #include "pf/cache/db_define.h"
 #include "pf/cache/db_store.h"
+#include "pf/cache/db_worker.h"
 #include "pf/cache/manager.h"
 #include "pf/cache/repository.h"
 #include "pf/cache/storeinterface.h"
@@ -46,11 +50,14 @@
 /* engine */
 #include "pf/engine/application.h"
 #include "pf/engine/kernel.h"
+#include "pf/engine/frame_scheduler.h"
+#include "pf/engine/sampler.h"
 
 /* file */
 #include "pf/file/api.h"
 #include "pf/file/ini.h"
 #include "pf/file/tab.h"
+#include "pf/file/tab_registry.h"
 #include "pf/file/library.h"
 
 /* net */
@@ -69,6 +76,7 @@
 #include "pf/net/packet/factorymanager.h"
 #include "pf/net/protocol/interface.h"
 #include "pf/net/protocol/basic.h"
+#include "pf/net/protocol/profiler.h"
 #include "pf/net/socket/api.h"
 #include "pf/net/socket/listener.h"
 #include "pf/net/socket/basic.h"
@@ -90,10 +98,13 @@
 #include "pf/sys/assert.h"
 #include "pf/sys/process.h"
 #include "pf/sys/thread.h"
+#include "pf/sys/work_pool.h"
 #include "pf/sys/util.h"
 
 /* util */
 #include "pf/util/compressor/assistant.h"
+#include "pf/util/compressor/codec.h"
+#include "pf/util/compressor/lz4.h"
 #include "pf/util/compressor/minimanager.h"
 #include "pf/util/bitflag.h"
 #include "pf/util/random.h"
@@ -0,0 +1,240 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id binary_log.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2026/10/19 22:30
+ * @uses The binary records of the fast log.
+ *       The format string is registered once for an id, a record is the
+ *       header(size, type, format id, wall seconds, thread, runtime) and the
+ *       raw arguments(a tag and the value), no text formatted in the caller.
+ *       The records are rendered to the text lines on the flush, or saved as
+ *       they are with the format records(a record type kFormatRecord defines
+ *       an id in the stream before it used) for the offline decoder.
+ */
+#ifndef PF_BASIC_BINARY_LOG_H_
+#define PF_BASIC_BINARY_LOG_H_
+
+#include <set>
+#include <type_traits>
+#include "pf/basic/config.h"
+
+namespace pf_basic {
+
+namespace binary_log {
+
+//The argument tags.
+enum {
+  kArgInt = 1,
+  kArgUint,
+  kArgDouble,
+  kArgString,
+  kArgPointer,
+};
+
+const uint8_t kFormatRecord = 0xff; //The record type of the format define.
+const uint32_t kFormatMax = 0xffff; //The registered formats.
+const uint16_t kStringMax = 1024; //The longer string fails the encode.
+const uint32_t kRecordMax = 4096;
+
+typedef struct header_struct {
+  uint16_t size;          //The record bytes with the header.
+  uint8_t type;           //The log type(0 1 2 3 9) or kFormatRecord.
+  uint8_t count;          //The arguments.
+  uint32_t format;        //The format id.
+  int64_t seconds;        //The wall time.
+  uint64_t thread;
+  uint64_t runtime;       //The milliseconds of the time manager run time.
+} header_t;
+
+//The id of the format, 0 if the registry is full.
+PF_API uint32_t format_id(const char *format);
+//The registered format, nullptr if not exists.
+PF_API const char *format(uint32_t id);
+//The header of a new record(without the size and count).
+PF_API void header(header_t &header, uint8_t type, uint32_t format);
+
+class Writer {
+
+ public:
+   Writer(char *buffer, size_t size) :
+     buffer_{buffer}, size_{size}, position_{0}, full_{false} {}
+
+ public:
+   template <typename T>
+   void put(uint8_t tag, T value) {
+     if (position_ + 1 + sizeof(value) > size_) {
+       full_ = true;
+       return;
+     }
+     buffer_[position_++] = static_cast<char>(tag);
+     memcpy(buffer_ + position_, &value, sizeof(value));
+     position_ += sizeof(value);
+   }
+   //Not cut, a string too long or not fit the rest is full(the caller save
+   //it as the text), the limit is kStringMax except the text record.
+   void put_string(const char *value, size_t limit = kStringMax) {
+     if (is_null(value)) value = "(null)";
+     size_t length = strlen(value);
+     if (length > limit ||
+         position_ + 1 + sizeof(uint16_t) + length > size_) {
+       full_ = true;
+       return;
+     }
+     auto size = static_cast<uint16_t>(length);
+     buffer_[position_++] = static_cast<char>(kArgString);
+     memcpy(buffer_ + position_, &size, sizeof(size));
+     position_ += sizeof(size);
+     memcpy(buffer_ + position_, value, length);
+     position_ += length;
+   }
+   size_t position() const { return position_; }
+   bool full() const { return full_; }
+
+ private:
+   char *buffer_;
+   size_t size_;
+   size_t position_;
+   bool full_;
+
+};
+
+template <typename T>
+inline typename std::enable_if<
+  std::is_integral<T>::value && std::is_signed<T>::value>::type
+put(Writer &writer, T value) {
+  writer.put(kArgInt, static_cast<int64_t>(value));
+}
+
+template <typename T>
+inline typename std::enable_if<
+  std::is_integral<T>::value && !std::is_signed<T>::value>::type
+put(Writer &writer, T value) {
+  writer.put(kArgUint, static_cast<uint64_t>(value));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_enum<T>::value>::type
+put(Writer &writer, T value) {
+  writer.put(kArgInt, static_cast<int64_t>(value));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value>::type
+put(Writer &writer, T value) {
+  writer.put(kArgDouble, static_cast<double>(value));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_pointer<T>::value>::type
+put(Writer &writer, T value) {
+  writer.put(kArgPointer, reinterpret_cast<uint64_t>(value));
+}
+
+inline void put(Writer &writer, const char *value) {
+  writer.put_string(value);
+}
+
+inline void put(Writer &writer, char *value) {
+  writer.put_string(value);
+}
+
+inline void put(Writer &writer, const unsigned char *value) {
+  writer.put_string(reinterpret_cast<const char *>(value));
+}
+
+inline void put(Writer &writer, unsigned char *value) {
+  writer.put_string(reinterpret_cast<const char *>(value));
+}
+
+inline void put(Writer &writer, const signed char *value) {
+  writer.put_string(reinterpret_cast<const char *>(value));
+}
+
+inline void put(Writer &writer, signed char *value) {
+  writer.put_string(reinterpret_cast<const char *>(value));
+}
+
+inline void put_all(Writer &) {}
+
+template <typename T, typename... Args>
+inline void put_all(Writer &writer, const T &value, const Args &... args) {
+  put(writer, value);
+  put_all(writer, args...);
+}
+
+//Encode a record to the buffer, the size of the record, 0 if failed(the
+//buffer too small or the format can't register).
+template <typename... Args>
+size_t encode(char *buffer,
+              size_t size,
+              uint8_t type,
+              const char *format,
+              const Args &... args) {
+  static_assert(sizeof...(Args) < 256, "binary log arguments too many");
+  if (size < sizeof(header_t)) return 0;
+  auto id = format_id(format);
+  if (0 == id) return 0;
+  header_t record;
+  header(record, type, id);
+  if (size > kRecordMax) size = kRecordMax;
+  Writer writer(buffer + sizeof(header_t), size - sizeof(header_t));
+  put_all(writer, args...);
+  if (writer.full()) return 0;
+  record.size = static_cast<uint16_t>(sizeof(header_t) + writer.position());
+  record.count = static_cast<uint8_t>(sizeof...(Args));
+  memcpy(buffer, &record, sizeof(record));
+  return record.size;
+}
+
+//The text of a record with the "%s"(the formatted arguments not encoded).
+const size_t kTextMax = kRecordMax - sizeof(header_t) - 1 - sizeof(uint16_t);
+
+//Encode the text as a "%s" record, 0 if failed.
+inline size_t encode_text(char *buffer,
+                          size_t size,
+                          uint8_t type,
+                          const char *text) {
+  if (size < sizeof(header_t)) return 0;
+  auto id = format_id("%s");
+  if (0 == id) return 0;
+  header_t record;
+  header(record, type, id);
+  if (size > kRecordMax) size = kRecordMax;
+  Writer writer(buffer + sizeof(header_t), size - sizeof(header_t));
+  writer.put_string(text, kTextMax);
+  if (writer.full()) return 0;
+  record.size = static_cast<uint16_t>(sizeof(header_t) + writer.position());
+  record.count = 1;
+  memcpy(buffer, &record, sizeof(record));
+  return record.size;
+}
+
+//Render the arguments of a record with the format(the integers narrowed to
+//the length modifiers of the format as the printf reads them).
+PF_API void render(const char *format,
+                   const char *args,
+                   size_t size,
+                   std::string &text);
+
+//Decode the records to the text lines as the text log, the formats of the
+//stream are used if not nullptr(the format records update it), else the
+//registered formats. The bytes decoded, a broken record stop it.
+PF_API size_t decode(const char *data,
+                     size_t size,
+                     std::string &text,
+                     std::map<uint32_t, std::string> *formats = nullptr);
+
+//Append the format records of the ids in the records not in the written.
+PF_API void define_formats(const char *data,
+                           size_t size,
+                           std::set<uint32_t> &written,
+                           std::string &out);
+
+} //namespace binary_log
+
+} //namespace pf_basic
+
+#endif //PF_BASIC_BINARY_LOG_H_
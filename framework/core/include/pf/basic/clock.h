@@ -0,0 +1,47 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id clock.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2026/10/19 19:30
+ * @uses The clock service for all threads.
+ *       The monotonic milliseconds are the coarse clock(no syscall on linux,
+ *       the precision is the kernel tick), the 64 bits values not wrap.
+ *       The wall time, local tm and the formatted strings are cached and
+ *       refreshed once a second by the first reader that sees the second
+ *       changed, the readers copy the cache with a sequence(no lock).
+ */
+#ifndef PF_BASIC_CLOCK_H_
+#define PF_BASIC_CLOCK_H_
+
+#include "pf/basic/config.h"
+
+namespace pf_basic {
+
+class PF_API Clock {
+
+ public:
+   //Monotonic milliseconds(coarse).
+   static uint64_t now_ms();
+   //Monotonic microseconds(precise).
+   static uint64_t now_us();
+   //The milliseconds from the process start.
+   static uint64_t uptime_ms();
+
+ public:
+   //The cached wall time(unix seconds).
+   static int64_t wall_seconds();
+   //The cached local time.
+   static void local_tm(tm &result);
+   //HH:MM:SS
+   static void format_time(char *buffer, size_t size);
+   //YYYY-mm-dd HH:MM:SS
+   static void format_date_time(char *buffer, size_t size);
+
+};
+
+} //namespace pf_basic
+
+#endif //PF_BASIC_CLOCK_H_
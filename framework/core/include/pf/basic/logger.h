@@ -14,6 +14,7 @@
 #include "pf/basic/config.h"
 #include "pf/basic/singleton.tcc"
 #include "pf/basic/hashmap/template.h"
+#include "pf/basic/binary_log.h"
 
 namespace pf_basic {
 
@@ -23,6 +24,13 @@ const uint32_t kLogBufferTemp = 4096;
 const uint32_t kLogNameTemp = 128;
 const uint32_t kDefaultLogCacheSize = 1024 * 1024 * 4;
 
+//The switches of the globals("log.fast", "log.print", "log.active").
+enum {
+  kLogSwitchFast = 0x1,
+  kLogSwitchPrint = 0x2,
+  kLogSwitchActive = 0x4,
+};
+
 class PF_API Logger : public Singleton<Logger> {
 
  public:
@@ -37,6 +45,19 @@ class PF_API Logger : public Singleton<Logger> {
    typedef pf_basic::hashmap::Template< int32_t, char * > 
      logcache_t;
    typedef pf_basic::hashmap::Template< int32_t, std::mutex * > loglock_t;
+   //The binary log file and the format ids written in it.
+   typedef struct binary_file_struct {
+     std::string filename;
+     std::set<uint32_t> formats;
+   } binary_file_t;
+   //The records copied out of the cache for the writer, the file is decided
+   //when copied(the writer not read the globals).
+   typedef struct binary_data_struct {
+     uint8_t logid;
+     bool raw;               //Save the records not the text lines.
+     std::string filename;
+     std::string data;
+   } binary_data_t;
 
  public:
    bool init(int32_t cache_size = kDefaultLogCacheSize);
@@ -55,18 +76,52 @@ class PF_API Logger : public Singleton<Logger> {
 
  public:
    //模板函数 type 0 普通日志 1 警告日志 2 错误日志 3 调试日志 9 只写日志
-   template <uint8_t type>
-   void fast_savelog(const char *logname, const char *format, ...);
+   //The arguments are saved raw(not formatted) if the log is binary.
+   template <uint8_t type, typename... Args>
+   void fast_savelog(const char *logname,
+                     const char *format,
+                     const Args &... args);
 
    //模板函数 type 0 普通日志 1 警告日志 2 错误日志 3 调试日志 9 只写日志
    template <uint8_t type>
    static void slow_savelog(const char *logname, const char *format, ...);
 
+ private:
+   static void format_log(char *buffer, size_t size, const char *format, ...);
+   static void print_log(uint8_t type, const char *buffer);
+   //Copy the data to the cache of the log, flush it if the cache full.
+   void save_fastlog(uint8_t logid,
+                     const char *logname,
+                     const char *data,
+                     int32_t length);
+   //Write the records and the records of the writer queue before them.
+   void flush_binarylog(uint8_t logid, const char *logname);
+   //Copy the records to the writer queue, the writer thread renders them.
+   void post_binarylog(uint8_t logid, const char *logname);
+   //Copy the records out and reset the cache(hold the queue lock).
+   void take_binarylog(uint8_t logid,
+                       const char *logname,
+                       std::vector<binary_data_t> &queue);
+   void write_binarylog(const binary_data_t &data);
+   void binary_writer();
+   //The globals read once a second, not look up them each binary log.
+   uint8_t get_switches();
+
  private:
    logids_t logids_;
    log_position_t log_position_;
    logcache_t logcache_;
    loglock_t loglock_;
+   log_position_t log_binary_; //1 if the log is binary.
+   std::map<int32_t, binary_file_t> binary_files_;
+   std::mutex binary_mutex_; //The writes of the binary logs in order.
+   std::mutex binary_queue_mutex_;
+   std::condition_variable binary_condition_;
+   std::vector<binary_data_t> binary_queue_;
+   std::thread binary_thread_;
+   bool binary_stop_;
+   std::atomic<int64_t> switches_time_;
+   std::atomic<uint8_t> switches_;
    int32_t cache_size_;
 
 };
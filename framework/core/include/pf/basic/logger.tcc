@@ -19,24 +19,39 @@
 
 namespace pf_basic {
 
-template <uint8_t type>
-void Logger::fast_savelog(const char *logname, const char *format, ...) {
+template <uint8_t type, typename... Args>
+void Logger::fast_savelog(const char *logname,
+                          const char *format,
+                          const Args &... args) {
   if (!logids_.isfind(logname) && !register_fastlog(logname)) {
     return;
   }
   uint8_t logid = static_cast<uint8_t>(logids_.get(logname));
-  char *cache = logcache_.get(logid);
-  if (is_null(cache)) return;
-  auto mutex = loglock_.get(logid);
-  if (is_null(mutex)) return;
-  uint32_t position = log_position_.get(logid);
+  auto switches = 1 == log_binary_.get(logid) ? get_switches() : 0;
+  if (switches & kLogSwitchFast) {
+    char record[binary_log::kRecordMax];
+    auto length =
+      binary_log::encode(record, sizeof(record), type, format, args...);
+    if (0 == length) { //Too long or the formats full, save as the text.
+      char temp[binary_log::kTextMax + 1]{0};
+      format_log(temp, sizeof(temp) - 1, format, args...);
+      length = binary_log::encode_text(record, sizeof(record), type, temp);
+      if (0 == length) return;
+    }
+    if (switches & kLogSwitchPrint) {
+      std::string text;
+      binary_log::decode(record, length, text);
+      if (!text.empty()) text.resize(text.size() - strlen(LF));
+      print_log(type, text.c_str());
+    }
+    if (!(switches & kLogSwitchActive)) return; //save log condition
+    save_fastlog(logid, logname, record, static_cast<int32_t>(length));
+    return;
+  }
   char buffer[4096]{0};
   char temp[4096]{0};
-  va_list argptr;
   try {
-    va_start(argptr, format);
-    vsnprintf(temp, sizeof(temp) - 1, format, argptr);
-    va_end(argptr);
+    format_log(temp, sizeof(temp) - 1, format, args...);
     if (GLOBALS["log.fast"] == false) { //disable fast log.
       char log_filename[FILENAME_MAX]{0};
       get_log_filename(logname, log_filename);
@@ -50,43 +65,15 @@ void Logger::fast_savelog(const char *logname, const char *format, ...) {
     Assert(false);
     return;
   }
-  if (GLOBALS["log.print"] == true) {
-    switch (type) {
-    case 1:
-      io_cwarn(buffer);
-      break;
-    case 2:
-      io_cerr(buffer);
-      break;
-    case 3:
-      io_cdebug(buffer);
-      break;
-    case 9:
-      break;
-    default:
-      printf("%s" LF "", buffer);
-      break;
-    }
-  }
+  if (GLOBALS["log.print"] == true) print_log(type, buffer);
   strncat(buffer, LF, sizeof(LF)); //add wrap
   if (GLOBALS["log.active"] == false) return; //save log condition
   int32_t length = static_cast<int32_t>(strlen(buffer));
-  if (length <= 0 || length + position > kDefaultLogCacheSize) return;
+  if (length <= 0) return;
   if (GLOBALS["log.singlefile"] == true) {
     //do nothing(one log file is not active now)
   }
-  {
-    std::unique_lock<std::mutex> autolock(*mutex);
-    try {
-      memcpy(cache + position, buffer, length);
-    } catch(...) {
-    //do nogthing
-    }
-    log_position_.set(logid, position + length);
-  }
-  if (position + length > (kDefaultLogCacheSize * 2) / 3) {
-    flush_log(logname);
-  }
+  save_fastlog(logid, logname, buffer, length);
 }
 
 //模板函数 type 0 普通日志 1 警告日志 2 错误日志 3 调试日志 9 只写日志
@@ -0,0 +1,245 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id metrics.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2026/10/19 21:10
+ * @uses The metrics registry(counters, gauges and histograms).
+ *       The metrics are created by name once and live until the process
+ *       exit, keep the reference and update it in the hot path. The counters
+ *       and histograms are sharded by thread(relaxed atomics, no lock), the
+ *       values are summed when read.
+ *       The histograms are log linear(4 buckets each power of 2), record the
+ *       microseconds for the latencies.
+ *       The families are the metrics by a label(like the packet id).
+ */
+#ifndef PF_BASIC_METRICS_H_
+#define PF_BASIC_METRICS_H_
+
+#include "pf/basic/config.h"
+
+//The shards of one metric.
+#define METRICS_SHARDS (8)
+
+//The histogram buckets: [0, 8) one each, then 4 each power of 2 to 2^40.
+#define METRICS_HISTOGRAM_BUCKETS (8 + 38 * 4)
+
+namespace pf_basic {
+
+namespace metrics {
+
+typedef enum {
+  kTypeCounter = 0,
+  kTypeGauge,
+  kTypeHistogram,
+} type_t;
+
+//The shard index of the current thread.
+PF_API size_t shard();
+
+class PF_API Counter {
+
+ public:
+   Counter();
+
+ public:
+   void add(uint64_t count = 1) {
+     shards_[shard()].value.fetch_add(count, std::memory_order_relaxed);
+   }
+   uint64_t value() const;
+
+ private:
+   typedef struct shard_struct {
+     std::atomic<uint64_t> value;
+     char pad[64 - sizeof(std::atomic<uint64_t>)];
+   } shard_t;
+
+ private:
+   shard_t shards_[METRICS_SHARDS];
+
+};
+
+class PF_API Gauge {
+
+ public:
+   Gauge() : value_{0} {}
+
+ public:
+   void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+   void add(int64_t value) { value_.fetch_add(value, std::memory_order_relaxed); }
+   int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+   std::atomic<int64_t> value_;
+
+};
+
+typedef struct histogram_snapshot_struct {
+  uint64_t count;
+  uint64_t sum;
+  uint64_t max;
+  uint64_t buckets[METRICS_HISTOGRAM_BUCKETS];
+  histogram_snapshot_struct() : count{0}, sum{0}, max{0}, buckets{0} {}
+  //The value of the percentile(0-1), the upper bound of the bucket.
+  uint64_t percentile(double p) const;
+} histogram_snapshot_t;
+
+class PF_API Histogram {
+
+ public:
+   Histogram();
+
+ public:
+   void record(uint64_t value);
+   void snapshot(histogram_snapshot_t &result) const;
+
+ public:
+   static size_t bucket(uint64_t value);
+   static uint64_t bucket_upper(size_t index);
+
+ private:
+   typedef struct shard_struct {
+     std::atomic<uint64_t> count;
+     std::atomic<uint64_t> sum;
+     std::atomic<uint64_t> max;
+     std::atomic<uint64_t> buckets[METRICS_HISTOGRAM_BUCKETS];
+   } shard_t;
+
+ private:
+   std::unique_ptr<shard_t[]> shards_;
+
+};
+
+//The metrics by the 16 bits label, created when first used.
+template <typename T>
+class Family {
+
+ public:
+   Family() {
+     for (auto &page : pages_) page = nullptr;
+   }
+   ~Family();
+
+ public:
+   T &get(uint16_t label);
+   //Call f(label, metric) for each created.
+   template <typename F>
+   void each(F &&f) const;
+
+ private:
+   typedef struct page_struct {
+     std::atomic<T *> slots[256];
+   } page_t;
+
+ private:
+   std::atomic<page_t *> pages_[256];
+
+};
+
+typedef struct sample_struct {
+  std::string name;
+  int32_t label; //-1 is not in a family.
+  type_t type;
+  int64_t value; //The counter or the gauge value.
+  histogram_snapshot_t histogram;
+  sample_struct() : name{""}, label{-1}, type{kTypeCounter}, value{0} {}
+} sample_t;
+
+//The registry, the same name returns the same metric.
+PF_API Counter &counter(const std::string &name);
+PF_API Gauge &gauge(const std::string &name);
+PF_API Histogram &histogram(const std::string &name);
+PF_API Family<Counter> &counter_family(const std::string &name);
+PF_API Family<Histogram> &histogram_family(const std::string &name);
+
+//Read all metrics.
+PF_API void snapshot(std::vector<sample_t> &samples);
+
+//One line each metric:
+//name value
+//name{label} count=n sum=n p50=n p90=n p99=n max=n
+PF_API std::string text();
+
+//Save the text lines to the log.
+PF_API void log(const char *logname);
+
+template <typename T>
+Family<T>::~Family() {
+  for (auto &page : pages_) {
+    auto p = page.load();
+    if (is_null(p)) continue;
+    for (auto &slot : p->slots) delete slot.load();
+    delete p;
+  }
+}
+
+template <typename T>
+T &Family<T>::get(uint16_t label) {
+  auto &page = pages_[label >> 8];
+  auto p = page.load(std::memory_order_acquire);
+  if (is_null(p)) {
+    std::unique_ptr<page_t> created(new page_t);
+    for (auto &slot : created->slots) slot = nullptr;
+    page_t *expected{nullptr};
+    if (page.compare_exchange_strong(expected, created.get())) {
+      p = created.release();
+    } else {
+      p = expected;
+    }
+  }
+  auto &slot = p->slots[label & 0xff];
+  auto metric = slot.load(std::memory_order_acquire);
+  if (is_null(metric)) {
+    std::unique_ptr<T> created(new T);
+    T *expected{nullptr};
+    if (slot.compare_exchange_strong(expected, created.get())) {
+      metric = created.release();
+    } else {
+      metric = expected;
+    }
+  }
+  return *metric;
+}
+
+template <typename T>
+template <typename F>
+void Family<T>::each(F &&f) const {
+  for (size_t i = 0; i < 256; ++i) {
+    auto p = pages_[i].load(std::memory_order_acquire);
+    if (is_null(p)) continue;
+    for (size_t j = 0; j < 256; ++j) {
+      auto metric = p->slots[j].load(std::memory_order_acquire);
+      if (metric) f(static_cast<uint16_t>((i << 8) | j), *metric);
+    }
+  }
+}
+
+//Record the microseconds from the construction to the destruction.
+class ScopedTimer {
+
+ public:
+   explicit ScopedTimer(Histogram &histogram) :
+     histogram_{histogram}, start_{std::chrono::steady_clock::now()} {}
+   ~ScopedTimer() {
+     histogram_.record(static_cast<uint64_t>(
+       std::chrono::duration_cast<std::chrono::microseconds>(
+         std::chrono::steady_clock::now() - start_).count()));
+   }
+
+ private:
+   ScopedTimer(const ScopedTimer &) = delete;
+   ScopedTimer &operator = (const ScopedTimer &) = delete;
+
+ private:
+   Histogram &histogram_;
+   std::chrono::steady_clock::time_point start_;
+
+};
+
+} //namespace metrics
+
+} //namespace pf_basic
+
+#endif //PF_BASIC_METRICS_H_
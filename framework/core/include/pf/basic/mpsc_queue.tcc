@@ -0,0 +1,76 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id mpsc_queue.tcc
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2026/10/19 17:20
+ * @uses The lock free queue of multi producers and single consumer.
+ *       Any thread can push, only one thread can pop(and check empty).
+ *       The producers exchange the head node, the consumer owns the tail.
+ */
+#ifndef PF_BASIC_MPSC_QUEUE_TCC_
+#define PF_BASIC_MPSC_QUEUE_TCC_
+
+#include "pf/basic/config.h"
+
+namespace pf_basic {
+
+template <typename T>
+class MPSCQueue {
+
+ public:
+   MPSCQueue() : head_{nullptr}, tail_{nullptr} {
+     auto stub = new node_t;
+     head_.store(stub, std::memory_order_relaxed);
+     tail_ = stub;
+   }
+   ~MPSCQueue() {
+     T value;
+     while (pop(value)) {}
+     delete tail_;
+   }
+   MPSCQueue(const MPSCQueue &) = delete;
+   MPSCQueue &operator = (const MPSCQueue &) = delete;
+
+ public:
+   void push(T &&value) {
+     auto node = new node_t;
+     node->value = std::move(value);
+     auto prev = head_.exchange(node, std::memory_order_acq_rel);
+     //Sequential, then a producer checks a waiting flag after the push and a
+     //consumer checks empty after setting the flag can't miss each other.
+     prev->next.store(node, std::memory_order_seq_cst);
+   }
+   //Consumer only.
+   bool pop(T &value) {
+     auto tail = tail_;
+     auto next = tail->next.load(std::memory_order_acquire);
+     if (is_null(next)) return false;
+     value = std::move(next->value);
+     tail_ = next; //The next node is the stub now.
+     delete tail;
+     return true;
+   }
+   //Consumer only, a push in progress may not be seen yet.
+   bool empty() const {
+     return is_null(tail_->next.load(std::memory_order_seq_cst));
+   }
+
+ private:
+   struct node_t {
+     std::atomic<node_t *> next;
+     T value;
+     node_t() : next{nullptr}, value{} {}
+   };
+
+ private:
+   std::atomic<node_t *> head_;
+   node_t *tail_;
+
+};
+
+} //namespace pf_basic
+
+#endif //PF_BASIC_MPSC_QUEUE_TCC_
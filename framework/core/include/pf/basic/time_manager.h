@@ -39,6 +39,8 @@ class PF_API TimeManager : public Singleton<TimeManager> {
  public:
    bool init();
    uint32_t get_tickcount(); //获取从程序启动到现在经历的时间(ms)
+   uint64_t get_tickcount64(); //The same but not wrap(ms).
+   uint64_t get_tickcount_us(); //The same but microseconds.
    uint32_t get_saved_time() const;
    uint32_t get_start_time() const;
    static TimeManager &getsingleton();
@@ -71,6 +73,10 @@ class PF_API TimeManager : public Singleton<TimeManager> {
    uint32_t get_hours(); //12723表示本年度第127天的5(23/4)点的第3(23%4)刻钟时间
    uint32_t get_weeks(); //取得以周为单位的时间值, 千位数代表年份，其他三位代表时间（周数）
 
+ private:
+   uint64_t start_ms_; //The clock at init.
+   uint64_t start_us_;
+
 };
 
 } //namespace pf_basic
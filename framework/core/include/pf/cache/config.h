@@ -17,6 +17,7 @@
 #define CACHE_SHARE_DEFAULT_MINUTES (10)            //默认缓存的分钟数
 #define CACHE_MODULENAME "cache"
 #define CACHE_WORKERS_DEFAULT (4)                   //Default workers.
+#define CACHE_DB_INFLIGHT_DEFAULT (64)              //每个连接未完成的查询上限
 
 namespace pf_cache {
 
@@ -24,6 +25,7 @@ class StoreInterface;
 class Repository;
 class DBStore;
 class Manager;
+class DBWorker;
 
 }
 
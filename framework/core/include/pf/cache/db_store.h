@@ -65,26 +65,26 @@ class SharePool : public pf_sys::memory::share::GroupPool {
  public:
    
    //Get the base table data.
-   inline db_table_base_t *table_base(int16_t index, int16_t data_index) {
+   inline db_table_base_t *table_base(int16_t index, int32_t data_index) {
      char *data = item_data_header(index, data_index);
      return reinterpret_cast< db_table_base_t * >(data);
    };
    
    //Get the columus and types of table.
-   inline db_table_info_t *table_info(int16_t index, int16_t data_index) {
+   inline db_table_info_t *table_info(int16_t index, int32_t data_index) {
      char *data = item_data_header(index, data_index);
      size_t exculde = sizeof(db_table_base_t);
      return reinterpret_cast< db_table_info_t * >(data + exculde);
    };
 
    //Get the item data.
-   inline db_item_t *item(int16_t index, int16_t data_index) {
+   inline db_item_t *item(int16_t index, int32_t data_index) {
      char *data = item_data(index, data_index);
      return reinterpret_cast< db_item_t * >(data);
    };
 
    //Get real data.
-   inline char *real_data(int16_t index, int16_t data_index) {
+   inline char *real_data(int16_t index, int32_t data_index) {
      char *data = item_data(index, data_index);
      return data + sizeof(db_item_t);
    }
@@ -236,9 +236,24 @@ class PF_API DBStore : public StoreInterface {
             const std::string &columns, 
             const std::string &rows);
 
+   //Set the cache by the result of a net query, the failed or truncated
+   //result(not complete) is not cached and the cache marked error.
+   bool set_result(const std::string &key, 
+                   bool complete,
+                   const std::string &columns, 
+                   const std::string &rows);
+
    //Free the recycle as you want size(0 mean free full as possible)
    size_t recycle_free(int32_t key, size_t size = 0);
 
+   //Save the share pools and the maps to the file(the writers not stopped,
+   //each table and row is locked only while copying it).
+   bool snapshot(const std::string &filename);
+
+   //Load the snapshot into the empty cache after init, the changed rows are
+   //queried to the db again.
+   bool restore(const std::string &filename);
+
    pf_sys::memory::share::Map *get_keymap() {
      return &key_map_;
    }
@@ -276,6 +291,18 @@ class PF_API DBStore : public StoreInterface {
    //Check the cache if in recycle.
    bool recycle_find(int32_t key, int32_t index);
 
+ private:
+
+   //Drop the keys not match the restored rows and save the dirty rows.
+   void restore_check();
+
+   //Drop the recycle entries whose keys were dropped or moved, return the
+   //dropped count.
+   size_t restore_check_recycle();
+
+   //The keys of the only key leave the recycle(the index set -1).
+   void recycle_unlink(int32_t key, const std::string &only_key);
+
  private:
    
    //The key index hash map, for share memory 
@@ -352,7 +379,7 @@ class PF_API DBStore : public StoreInterface {
    get_db_connection_func get_db_connection_func_;
 
    //The workers for tick.
-   std::unique_ptr<pf_sys::ThreadPool> workers_;
+   std::unique_ptr<pf_sys::WorkPool> workers_;
 
    //The cache last check time.
    uint32_t cache_last_check_time_;
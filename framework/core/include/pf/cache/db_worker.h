@@ -0,0 +1,92 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id db_worker.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2026/10/19 16:10
+ * @uses The db workers of the cache query packets.
+ *       The net thread post the query packet, a worker execute it with a free
+ *       db env(each worker one env so the queries are parallel), then the
+ *       packet back to the cache of the manager owned the connection and send
+ *       the result in the net thread, dropped if the connection generation
+ *       changed(the pooled id reused).
+ */
+#ifndef PF_CACHE_DB_WORKER_H_
+#define PF_CACHE_DB_WORKER_H_
+
+#include "pf/cache/config.h"
+#include "pf/db/config.h"
+#include "pf/sys/work_pool.h"
+#include "pf/net/connection/config.h"
+#include "pf/net/connection/manager/config.h"
+
+namespace pf_cache {
+
+namespace packet {
+class DBQuery;
+}
+
+class PF_API DBWorker {
+
+ public:
+   DBWorker(const std::vector<pf_db::Interface *> &envs,
+            uint32_t inflight_max = CACHE_DB_INFLIGHT_DEFAULT);
+   ~DBWorker();
+
+ public:
+   //Call in the net thread, false if the connection in flight is full or
+   //not in a manager.
+   bool post(pf_net::connection::Basic *connection, packet::DBQuery *query);
+   //The query back to the net thread, the generation is the posted.
+   void finish(pf_net::connection::Basic *connection, uint32_t generation);
+
+ public:
+   uint32_t inflight(pf_net::connection::Basic *connection);
+   uint32_t get_inflight_max() const { return inflight_max_; }
+   void set_inflight_max(uint32_t max) { inflight_max_ = max; }
+   //The queries wait for a worker.
+   uint32_t queue_depth() const { return queue_depth_; }
+   uint32_t queue_depth_max() const { return queue_depth_max_; }
+   uint64_t posted() const { return posted_; }
+   uint64_t rejected() const { return rejected_; }
+
+ private:
+   void run(pf_net::connection::manager::Interface *manager,
+            int16_t connection_id,
+            packet::DBQuery *query);
+   pf_db::Interface *env_acquire();
+   void env_release(pf_db::Interface *env);
+
+ private:
+   //The in flight count of a connection generation.
+   typedef struct inflight_struct {
+     uint32_t generation;
+     uint32_t count;
+     inflight_struct() : generation{0}, count{0} {}
+   } inflight_t;
+   //Get it with the inflight mutex, reset if the generation changed.
+   inflight_t &get_inflight(pf_net::connection::Basic *connection);
+
+ private:
+   std::unique_ptr<pf_sys::WorkPool> workers_;
+   std::vector<pf_db::Interface *> envs_; //The free envs.
+   size_t env_count_;
+   std::mutex mutex_;
+   std::condition_variable condition_;
+   std::mutex inflight_mutex_; //The managers may in the different threads.
+   //Index by the connection id of each manager.
+   std::map<pf_net::connection::manager::Interface *, 
+            std::vector<inflight_t> > inflight_;
+   uint32_t inflight_max_;
+   std::atomic<uint32_t> queue_depth_;
+   std::atomic<uint32_t> queue_depth_max_;
+   uint64_t posted_;
+   uint64_t rejected_;
+
+};
+
+} //namespace pf_cache
+
+#endif //PF_CACHE_DB_WORKER_H_
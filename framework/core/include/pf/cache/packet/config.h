@@ -13,4 +13,8 @@
 
 #include "pf/cache/config.h"
 
+//The packets hold the used bytes only, the max just limit the input.
+#define CACHE_PACKET_KEY_LENGTH_MAX (127)
+#define CACHE_PACKET_ROWS_SIZE_MAX (100 * 1024)
+
 #endif //PF_CACHE_PACKET_CONFIG_H_
@@ -16,6 +16,7 @@
 #include "pf/net/packet/interface.h"
 #include "pf/net/packet/factory.h"
 #include "pf/db/config.h"
+#include "pf/cache/packet/db_result.h"
 
 namespace pf_cache {
 
@@ -27,9 +28,12 @@ class DBQuery : public pf_net::packet::Interface {
    DBQuery() : id_{0},
      type_{0},
      operate_{0},
-     key_{0},
-     sql_str_{0} {}
-   virtual ~DBQuery() {}
+     request_id_{0},
+     generation_{0},
+     key_{""},
+     sql_str_{""},
+     result_{nullptr} {}
+   virtual ~DBQuery();
 
  public:
    virtual bool read(pf_net::stream::Input &);
@@ -43,18 +47,42 @@ class DBQuery : public pf_net::packet::Interface {
    void set_type(int8_t type) { type_ = type; }
    int8_t get_type() const { return type_; }
    void set_sql_str(const std::string &str) {
-     pf_basic::string::safecopy(sql_str_, str.c_str(), sizeof(sql_str_ - 1));
+     sql_str_ = str.size() < SQL_LENGTH_MAX ? 
+                str : str.substr(0, SQL_LENGTH_MAX - 1);
    }
    const char *get_sql_str() {
-     return sql_str_;
+     return sql_str_.c_str();
    }
+   //The request id is returned in the result, so the results can be
+   //correlated when the queries are executed in the db workers.
+   void set_request_id(uint32_t id) { request_id_ = id; }
+   uint32_t get_request_id() const { return request_id_; }
+   void set_key(const std::string &key) {
+     key_ = key.size() <= CACHE_PACKET_KEY_LENGTH_MAX ? 
+            key : key.substr(0, CACHE_PACKET_KEY_LENGTH_MAX);
+   }
+   const char *get_key() const { return key_.c_str(); }
+   //The connection generation when posted to the db workers.
+   void set_generation(uint32_t generation) { generation_ = generation; }
+   uint32_t get_generation() const { return generation_; }
+
+ public:
+   //Execute the sql with the env and keep the result(the db workers call it).
+   void query(pf_db::Interface *env);
+
+ private:
+   void result_init(DBResult &result) const;
+   void query(pf_db::Interface *env, DBResult &result);
 
  private:
    uint16_t id_;
    int8_t type_;
    int8_t operate_;
-   char key_[128];
-   char sql_str_[SQL_LENGTH_MAX];
+   uint32_t request_id_;
+   uint32_t generation_;
+   std::string key_;
+   std::string sql_str_; //The size is the sql length, not the max.
+   std::unique_ptr<DBResult> result_; //The worker result.
 
 };
 
@@ -16,6 +16,7 @@
 #include "pf/net/packet/interface.h"
 #include "pf/net/packet/factory.h"
 #include "pf/db/config.h"
+#include "pf/cache/db_define.h"
 
 namespace pf_cache {
 
@@ -28,13 +29,15 @@ class DBResult : public pf_net::packet::Interface {
      : id_{0},
        result_{kResultFailed},
        operate_{-1},
-       key_{0} { data_size_ = get_data_size(); }
+       request_id_{0},
+       key_{""} {}
    virtual ~DBResult() {}
 
  public:
    enum {
      kResultFailed = -1,
      kResultSuccess,
+     kResultTruncated, //The rows are cut to the packet max on a row boundary.
    };
 
  public:
@@ -47,23 +50,25 @@ class DBResult : public pf_net::packet::Interface {
    void set_operate(int8_t operate) { operate_ = operate; }
    int8_t get_operate() const { return operate_; }
    void set_key(const std::string &key) {
-     pf_basic::string::safecopy(key_, key.c_str(), sizeof(key_) - 1);
+     key_ = key.size() <= CACHE_PACKET_KEY_LENGTH_MAX ? 
+            key : key.substr(0, CACHE_PACKET_KEY_LENGTH_MAX);
    }
-   const char *get_key() { return key_; }
+   const char *get_key() { return key_.c_str(); }
+   void set_request_id(uint32_t id) { request_id_ = id; }
+   uint32_t get_request_id() const { return request_id_; }
    void set_result(int8_t result) { result_ = result; }
    int8_t get_result() const { return result_; }
    void set_columns(const std::string &columns) { columns_ = columns; }
+   void set_columns(std::string &&columns) { columns_ = std::move(columns); }
    void set_rows(const std::string &rows) { rows_ = rows; }
-
- private:
-   uint32_t get_data_size() const;
+   void set_rows(std::string &&rows) { rows_ = std::move(rows); }
 
  private:
    uint16_t id_;
    int8_t result_;
    int8_t operate_;
-   int32_t data_size_;
-   char key_[128];
+   uint32_t request_id_;
+   std::string key_;
    std::string columns_;
    std::string rows_;
 
@@ -86,7 +91,9 @@ class DBResultFactory : public pf_net::packet::Factory {
      return id_;
    }
    virtual uint32_t packet_max_size() const {
-     return SQL_LENGTH_MAX;
+     return sizeof(int8_t) * 2 + sizeof(uint32_t) * 4 + 
+            CACHE_PACKET_KEY_LENGTH_MAX + CACHE_DB_TABLE_COLUMNS_SIZE + 
+            CACHE_PACKET_ROWS_SIZE_MAX;
    }
 
  private:
@@ -60,11 +60,25 @@ class PF_API Query {
  public:
    bool query();
    bool fetcharray(db_fetch_array_t &db_fetch_array);
+   //The fetch functions return false if no result or the rows more than the
+   //size, the rows are cut on the row boundary(the count is the rows kept).
    bool fetch(char *str, size_t size);
    bool fetch(char *columns, size_t columns_size, char *rows, size_t rows_size);
+   //The same format, the buffers grow on demand and hold the used bytes only,
+   //the truncated is set if the rows cut.
+   bool fetch(std::string &columns, 
+              std::string &rows, 
+              size_t rows_max, 
+              bool *truncated = nullptr);
    void get_sql(std::string &sql) { sql = sql_; };
    void set_sql(const std::string &sql) { sql_ = sql; }
 
+ private:
+   //The one serializer of the fetch functions, the columns fetch the first
+   //row and the rows continue from it.
+   bool serialize_columns(std::string &columns);
+   bool serialize_rows(std::string &rows, size_t rows_max, bool &truncated);
+
  private:
    char tablename_[DB_TABLENAME_LENGTH];
    Interface *env_;
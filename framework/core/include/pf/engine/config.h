@@ -16,8 +16,43 @@
 namespace pf_engine {
   class Application;
   class Kernel;
+  class FrameScheduler;
+  class Sampler;
 }
 
 #define ENGINE_MODULENAME "engine"
 
+namespace pf_engine {
+
+//The frame thread option, the frame and spin 0 are the globals.
+typedef struct frame_option_struct {
+  std::string name;
+  uint32_t frame;   //Frames per second.
+  uint32_t spin;    //Microseconds.
+} frame_option_t;
+
+//The statistics of a frame thread, the times are microseconds.
+typedef struct frame_stat_struct {
+  std::string name;
+  int32_t threadid;       //The kernel thread id, 0 if not started.
+  uint32_t frame;
+  uint64_t frames;
+  uint64_t overruns;      //The frames finish after the deadline.
+  uint64_t dropped;       //The frames late more than a period.
+  uint64_t overrun_max;
+  uint64_t overrun_total;
+  uint64_t work_max;
+  frame_stat_struct() : 
+    threadid{0},
+    frame{0},
+    frames{0},
+    overruns{0},
+    dropped{0},
+    overrun_max{0},
+    overrun_total{0},
+    work_max{0} {}
+} frame_stat_t;
+
+} //namespace pf_engine
+
 #endif //PF_ENGINE_CONFIG_H_
@@ -0,0 +1,65 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id frame_scheduler.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2026/10/19 18:05
+ * @uses The frame scheduler of the engine threads.
+ *       The deadlines are on the steady clock and advance by the period(not
+ *       from the wake time), so the frames not drift. A late frame starts the
+ *       next at once to catch up, a frame late more than a period is dropped.
+ *       The spin(microseconds) yield the last part before the deadline
+ *       instead of sleep, for the loops need a small jitter.
+ */
+#ifndef PF_ENGINE_FRAME_SCHEDULER_H_
+#define PF_ENGINE_FRAME_SCHEDULER_H_
+
+#include "pf/engine/config.h"
+
+namespace pf_engine {
+
+class PF_API FrameScheduler {
+
+ public:
+   //The frame and spin 0 are the globals.
+   FrameScheduler(const std::string &name, uint32_t frame = 0, uint32_t spin = 0);
+   ~FrameScheduler() {}
+
+ public:
+   //Call it before the first frame in the thread.
+   void start();
+   //Wait the next frame deadline, false if the frame is overrun.
+   bool wait();
+
+ public:
+   const std::string &name() const { return name_; }
+   void set_frame(uint32_t frame);
+   uint32_t get_frame() const { return frame_; }
+   void set_spin(uint32_t spin) { spin_ = spin; }
+   uint32_t get_spin() const { return spin_; }
+   void stop() { stop_ = true; }
+   bool is_stopping() const { return stop_; }
+   frame_stat_t stat() const;
+
+ private:
+   std::string name_;
+   std::atomic<uint32_t> frame_;
+   std::atomic<uint32_t> spin_;
+   std::atomic<bool> stop_;
+   std::atomic<int32_t> threadid_;
+   std::chrono::steady_clock::time_point deadline_;
+   std::chrono::steady_clock::time_point frame_start_;
+   std::atomic<uint64_t> frames_;
+   std::atomic<uint64_t> overruns_;
+   std::atomic<uint64_t> dropped_;
+   std::atomic<uint64_t> overrun_max_;
+   std::atomic<uint64_t> overrun_total_;
+   std::atomic<uint64_t> work_max_;
+
+};
+
+} //namespace pf_engine
+
+#endif //PF_ENGINE_FRAME_SCHEDULER_H_
@@ -12,11 +12,13 @@
 #define PF_ENGINE_KERNEL_H_
 
 #include "pf/engine/config.h"
+#include "pf/engine/sampler.h"
 #include "pf/db/config.h"
 #include "pf/script/config.h"
 #include "pf/net/connection/manager/config.h"
 #include "pf/cache/manager.h"
 #include "pf/basic/type/variable.h"
+#include "pf/basic/mpsc_queue.tcc"
 
 namespace pf_engine {
 
@@ -40,6 +42,8 @@ class PF_API Kernel : public pf_basic::Singleton< Kernel > {
      return net_.get();
    };
    pf_db::Interface *get_db();
+   //The db workers of the cache query packets, nullptr if not open.
+   pf_cache::DBWorker *get_db_worker() { return db_worker_.get(); }
    pf_cache::Manager *get_cache() {
      return cache_.get();
    };
@@ -54,8 +58,19 @@ class PF_API Kernel : public pf_basic::Singleton< Kernel > {
    -> std::future<typename std::result_of<F(Args...)>::type>;
 
  public:
+   //The thread call the function each frame(the default engine frame), it
+   //stopped if the function return false.
    template<class F, class... Args>
    std::thread::id newthread(F&& f, Args&&... args);
+   //The same but with the thread name and frame.
+   template<class F, class... Args>
+   std::thread::id newthread_frame(const frame_option_t &option, 
+                                   F&& f, 
+                                   Args&&... args);
+   //The frame statistics of the threads.
+   std::vector<frame_stat_t> get_frame_stats();
+   //The process resource sampler, nullptr if not open.
+   Sampler *get_sampler() { return sampler_.get(); }
 
  public:
    void add_libraryload(const std::string &name, 
@@ -75,20 +90,45 @@ class PF_API Kernel : public pf_basic::Singleton< Kernel > {
    std::unique_ptr<pf_db::Factory> db_factory_;
    pf_db::eid_t db_eid_;
    std::unique_ptr<pf_cache::Manager> cache_;
+   std::unique_ptr<pf_cache::DBWorker> db_worker_;
    std::unique_ptr<pf_script::Factory> script_factory_;
    pf_script::eid_t script_eid_;
    std::vector< std::thread > thread_workers_;
+   std::vector< std::shared_ptr<FrameScheduler> > thread_schedulers_;
+   std::unique_ptr<Sampler> sampler_;
    bool isinit_;
 
  private:
    void loop();
+   //Run the tasks until the queue is empty or the budget(ms) used up.
+   uint32_t work_tasks(uint32_t budget);
+   //Sleep the rest of the frame, a enqueue wakes up it at once.
+   void wait_tasks(uint32_t starttime);
+   void wakeup();
+   //Save the cache to the default.cache.snapshot file if it is set.
+   void snapshot_cache();
+   //Read the loop options from the GLOBALS once a second.
+   void refresh_options();
+
+ private:
+   typedef struct loop_option_struct {
+     uint32_t budget; //The time(ms) of the tasks in a frame.
+     int32_t frametime; //The time(ms) of a frame.
+     uint64_t metrics; //The metrics log interval(seconds).
+     uint64_t snapshot; //The cache snapshot interval(seconds).
+   } loop_option_t;
 
  private:
    std::map<std::string, pf_basic::type::variable_array_t> library_load_;
-   std::queue< std::function<void()> > tasks_;
+   pf_basic::MPSCQueue< std::function<void()> > tasks_;
    std::vector< std::function<void()> > thread_tasks_;
    std::mutex queue_mutex_;
-   bool stop_;
+   std::mutex wait_mutex_;
+   std::condition_variable wait_condition_;
+   std::atomic<bool> waiting_; //The loop is waiting the tasks.
+   std::atomic<bool> stop_;
+   loop_option_t loop_option_;
+   int64_t loop_option_time_;
 
 };
 
@@ -14,6 +14,9 @@
 #include "pf/sys/thread.h"
 #include "pf/basic/util.h"
 #include "pf/basic/time_manager.h"
+#include "pf/basic/logger.h"
+#include "pf/basic/metrics.h"
+#include "pf/engine/frame_scheduler.h"
 #include "pf/engine/kernel.h"
 
 namespace pf_engine {
@@ -34,17 +37,61 @@ auto Kernel::enqueue(F&& f, Args&&... args)
   std::bind(std::forward<F>(f), std::forward<Args>(args)...)
   );
   std::future<return_type> res = task->get_future();
-  {
-    std::unique_lock<std::mutex> lock(queue_mutex_);
-    if (stop_)
-       throw std::runtime_error("enqueue on stopped Kernel");
-    tasks_.emplace([task](){ (*task)(); });
+  if (stop_)
+     throw std::runtime_error("enqueue on stopped Kernel");
+  tasks_.push([task](){ (*task)(); });
+  if (waiting_) wakeup();
+  return res;
+}
+
+//The task of the thread threw, the thread keep running.
+inline void frame_exception(const std::string &name, const char *what) {
+  static auto &exceptions = 
+    pf_basic::metrics::counter("engine.frame_exceptions");
+  exceptions.add();
+  SLOW_ERRORLOG(ENGINE_MODULENAME,
+                "[%s] frame_continue thread(%s) task exception: %s",
+                ENGINE_MODULENAME,
+                name.c_str(),
+                what);
+}
+
+//The task result, false stop the thread.
+template <typename T>
+inline bool frame_continue(std::future<T> &result, const std::string &name) {
+  try {
+    result.get();
+  } catch(const std::exception &e) {
+    frame_exception(name, e.what());
+  } catch(...) {
+    frame_exception(name, "unknown");
+  }
+  return true;
+}
+
+inline bool frame_continue(std::future<bool> &result, 
+                           const std::string &name) {
+  try {
+    return result.get();
+  } catch(const std::exception &e) {
+    frame_exception(name, e.what());
+  } catch(...) {
+    frame_exception(name, "unknown");
   }
- return res;
+  return true;
 }
 
 template<class F, class... Args>
 std::thread::id Kernel::newthread(F&& f, Args&&... args) {
+  frame_option_t option{"", 0, 0};
+  return newthread_frame(
+      option, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+template<class F, class... Args>
+std::thread::id Kernel::newthread_frame(const frame_option_t &option, 
+                                        F&& f, 
+                                        Args&&... args) {
   using return_type = typename std::result_of<F(Args...)>::type;
   std::thread::id res;
   {
@@ -54,19 +101,23 @@ std::thread::id Kernel::newthread(F&& f, Args&&... args) {
     auto task = std::make_shared< std::packaged_task<return_type()> >(
         std::bind(std::forward<F>(f), std::forward<Args>(args)...)
       );
-    thread_workers_.emplace_back([task](){ 
+    auto scheduler = 
+      std::make_shared<FrameScheduler>(option.name, option.frame, option.spin);
+    thread_schedulers_.push_back(scheduler);
+    thread_workers_.emplace_back([task, scheduler](){ 
       pf_sys::thread::start();
       pf_sys::ThreadCollect tc;
-      std::future<return_type> task_res = task->get_future();
+      scheduler->start();
       for (;;) {
-        if (pf_sys::thread::is_stopping()) break;
-        auto starttime = TIME_MANAGER_POINTER->get_tickcount();
+        if (scheduler->is_stopping()) break;
+        std::future<return_type> task_res = task->get_future();
         (*task)(); 
-        if (std::is_same<decltype(task_res), bool>::value && !task_res.get())
-          pf_sys::thread::stop();
-        worksleep(starttime);
+        auto keep = frame_continue(task_res, scheduler->name());
         (*task).reset(); //Remeber it, the packaged_task reset then can call again.
+        if (!keep) break;
+        scheduler->wait();
       }
+      pf_sys::thread::stop();
     });
     res = thread_workers_[thread_workers_.size() - 1].get_id();
   }
@@ -0,0 +1,120 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id sampler.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2026/10/19 21:10
+ * @uses The process resource sampler of the engine.
+ *       A thread reads the process usage(/proc/self) and the scheduler
+ *       statistics of the engine threads each interval into a ring, sets
+ *       them to the "process.*" and "thread.*" gauges and warns when the
+ *       thresholds are crossed(or the swap grows), with the frame overruns
+ *       of the interval.
+ */
+#ifndef PF_ENGINE_SAMPLER_H_
+#define PF_ENGINE_SAMPLER_H_
+
+#include "pf/engine/config.h"
+#include "pf/sys/process.h"
+
+namespace pf_engine {
+
+//The times are microseconds of the interval.
+typedef struct thread_sample_struct {
+  std::string name;
+  int32_t threadid;
+  uint64_t run;           //On the cpu.
+  uint64_t delay;         //Runnable but waiting on the run queue.
+  uint64_t overruns;      //The frame overruns.
+  thread_sample_struct() : threadid{0}, run{0}, delay{0}, overruns{0} {}
+} thread_sample_t;
+
+//The counts are the deltas of the interval, the memory are KB.
+typedef struct sample_struct {
+  uint64_t time;          //Milliseconds.
+  uint64_t interval;      //Milliseconds since the last sample.
+  uint32_t cpu;           //Percent, more than 100 with many cpus.
+  uint32_t steal;         //Percent of the system cpu stolen.
+  uint64_t rss;
+  uint64_t swap;
+  uint64_t fds;
+  uint64_t threads;
+  uint64_t majflt;
+  uint64_t voluntary_switches;
+  uint64_t involuntary_switches;
+  std::vector<thread_sample_t> thread_samples;
+  sample_struct() :
+    time{0},
+    interval{0},
+    cpu{0},
+    steal{0},
+    rss{0},
+    swap{0},
+    fds{0},
+    threads{0},
+    majflt{0},
+    voluntary_switches{0},
+    involuntary_switches{0} {}
+} sample_t;
+
+//The warning thresholds, 0 is off.
+typedef struct sampler_threshold_struct {
+  uint32_t cpu;           //Percent.
+  uint64_t rss;           //MB.
+  uint64_t fds;
+  uint32_t delay;         //Percent of the interval a thread waited.
+  uint32_t steal;         //Percent.
+  sampler_threshold_struct() : cpu{0}, rss{0}, fds{0}, delay{0}, steal{0} {}
+} sampler_threshold_t;
+
+class PF_API Sampler {
+
+ public:
+   //The interval is milliseconds, the size is the samples kept in the ring.
+   Sampler(Kernel *kernel, uint32_t interval, size_t size = 60);
+   ~Sampler();
+
+ public:
+   //Start the thread, the caller thread is sampled as "main".
+   void start();
+   void stop();
+
+ public:
+   void set_threshold(const sampler_threshold_t &threshold) {
+     threshold_ = threshold;
+   }
+   const sampler_threshold_t &get_threshold() const { return threshold_; }
+   uint32_t get_interval() const { return interval_; }
+   //The samples in the ring, the oldest first.
+   void samples(std::vector<sample_t> &samples);
+   bool last(sample_t &sample);
+
+ private:
+   void sample();
+   void check(const sample_t &sample);
+
+ private:
+   Kernel *kernel_;
+   uint32_t interval_;
+   size_t size_;
+   sampler_threshold_t threshold_;
+   std::vector<sample_t> ring_;
+   size_t next_;
+   std::mutex mutex_;
+   std::condition_variable condition_;
+   std::atomic<bool> stop_;
+   std::thread thread_;
+   int32_t main_threadid_;
+   uint64_t last_time_;
+   pf_sys::process::usage_t usage_;
+   std::map<int32_t, pf_sys::process::schedstat_t> schedstats_;
+   std::map<int32_t, uint64_t> overruns_;
+   std::map<std::string, bool> warned_; //The thresholds crossed.
+
+};
+
+} //namespace pf_engine
+
+#endif //PF_ENGINE_SAMPLER_H_
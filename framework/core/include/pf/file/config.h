@@ -17,5 +17,7 @@
 #define FILE_DATABASE_CONVERT_GBK_TO_UTF8
 //文件数据标识，只有该类型的二进制文件才会认为正确
 #define FILE_DATABASE_INDENTIFY 0XDDBBCC00 
+//文件数据库二级索引最多可组合的列数
+#define FILE_DATABASE_INDEX_COLUMN_MAX (4)
 
 #endif //PF_FILE_CONFIG_H_
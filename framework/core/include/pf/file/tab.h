@@ -58,6 +58,22 @@ class PF_API Tab {
 
    typedef std::vector<field_data> data_buffer;
 
+   //二级索引的键，组合索引按创建时列的顺序填写
+   typedef struct index_key_struct {
+     field_data values[FILE_DATABASE_INDEX_COLUMN_MAX];
+     int32_t count;
+     index_key_struct() : count{0} {}
+     index_key_struct(const field_data &value) : count{1} {
+       values[0] = value;
+     }
+     index_key_struct &add(const field_data &value) {
+       if (count < FILE_DATABASE_INDEX_COLUMN_MAX) values[count++] = value;
+       return *this;
+     }
+   } index_key_t;
+
+   typedef std::vector<const field_data *> record_list; //行首地址列表
+
  public:
    explicit Tab(uint32_t id);
    virtual ~Tab();
@@ -76,12 +92,32 @@ class PF_API Tab {
    uint32_t get_id() const; //获得ID
    int32_t get_field_number() const;
    int32_t get_record_number() const;
-   const char *get_fieldname(int32_t index);
-   int32_t get_fieldindex(const char *name);
-   const field_data *get_fielddata(int32_t line, const char *name);
-   uint8_t get_fieldtype(int32_t index);
+   const char *get_fieldname(int32_t index) const;
+   int32_t get_fieldindex(const char *name) const;
+   const field_data *get_fielddata(int32_t line, const char *name) const;
+   uint8_t get_fieldtype(int32_t index) const;
    void create_index(int32_t column = 0, const char *filename = 0);
 
+ public:
+   //Secondary indexes, the return value is the index id(INDEX_INVALID failed).
+   int32_t create_index(const char *name, 
+                        const std::vector<int32_t> &columns, 
+                        bool unique = false);
+   int32_t create_sorted_index(const char *name, int32_t column);
+   int32_t get_indexid(const char *name) const;
+   //The key count must be the index columns, else nothing found.
+   const field_data *search_unique(int32_t id, const index_key_t &key) const;
+   int32_t search_multi(int32_t id, 
+                        const index_key_t &key, 
+                        record_list &records) const;
+   //Sorted index only, the records in [low, high] with key order.
+   int32_t search_range(int32_t id, 
+                        const field_data &low, 
+                        const field_data &high, 
+                        record_list &records) const;
+   //Sorted index only, the last record which key not greater than value.
+   const field_data *search_floor(int32_t id, const field_data &value) const;
+
  public:
    static const char *get_line_from_memory(char *str, 
                                            int32_t size, 
@@ -90,6 +126,10 @@ class PF_API Tab {
    static bool field_equal(field_type_enum type, 
                            const field_data &a, 
                            const field_data &b);
+   static bool field_less(field_type_enum type, 
+                          const field_data &a, 
+                          const field_data &b);
+   static size_t field_hash(field_type_enum type, const field_data &value);
 
  public:
    bool save_tobinary(const char *filename);
@@ -109,6 +149,32 @@ class PF_API Tab {
    field_hashmap hash_index_;
    int32_t index_column_;
 
+ protected:
+   struct index_hash {
+     std::vector<field_type_enum> types;
+     size_t operator()(const index_key_t &key) const;
+   };
+   struct index_equal {
+     std::vector<field_type_enum> types;
+     bool operator()(const index_key_t &a, const index_key_t &b) const;
+   };
+   typedef std::unordered_multimap<
+     index_key_t, const field_data *, index_hash, index_equal> index_hashmap;
+   typedef std::vector< 
+     std::pair<field_data, const field_data *> > index_sorted;
+   typedef struct index_struct {
+     std::vector<int32_t> columns;
+     bool unique;
+     bool sorted;
+     std::unique_ptr<index_hashmap> hash;
+     index_sorted sorted_list;
+     index_struct() : unique{false}, sorted{false} {}
+   } index_t;
+   std::unordered_map<std::string, int32_t> fieldindex_map_; //列名->列索引
+   std::vector< std::unique_ptr<index_t> > indexes_;
+   std::unordered_map<std::string, int32_t> indexname_map_;
+   std::vector<int32_t> column_index_; //单列散列索引，列->索引ID
+
  protected:
    bool open_from_memory_text(const char *memory, 
                               const char *end, 
@@ -116,6 +182,10 @@ class PF_API Tab {
    bool open_from_memory_binary(const char *memory, 
                                 const char *end, 
                                 const char *filename = nullptr);
+   void build_fieldindex();
+   void clear_indexes();
+   const index_t *get_index(int32_t id) const;
+   index_key_t make_key(const index_t &index, const field_data *record) const;
 
 };
 
@@ -0,0 +1,104 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id tab_registry.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2026/10/19 10:21
+ * @uses The tab file registry, load tables in parallel and hot reload them.
+ *       Every table is published as an immutable snapshot, the readers hold
+ *       the snapshot(shared_ptr) and never block by the reload, the old
+ *       version will be freed when the last reader released it.
+ */
+#ifndef PF_FILE_TAB_REGISTRY_H_
+#define PF_FILE_TAB_REGISTRY_H_
+
+#include "pf/file/config.h"
+#include "pf/basic/hashmap/config.h"
+#include "pf/sys/config.h"
+#include "pf/file/tab.h"
+
+namespace pf_file {
+
+class PF_API TabRegistry {
+
+ public:
+   typedef std::shared_ptr<const Tab> snapshot_t;
+   //Called on the loader thread before a table published(like create index).
+   typedef std::function<void(const std::string &name, Tab &tab)> prepare_t;
+
+ public:
+   //If the pool is null will create one with the hardware thread count.
+   explicit TabRegistry(pf_sys::ThreadPool *pool = nullptr);
+   ~TabRegistry();
+
+ public:
+
+   //Load all the files with the suffix in the directory, the file name
+   //without suffix as the table name.
+   bool load_directory(const std::string &path,
+                       const std::string &suffix = ".txt");
+
+   //Load the files in parallel, if wait is false then return immediately.
+   bool load(const std::vector<
+             std::pair<std::string, std::string> > &files, // name - filename
+             bool wait = true);
+
+   //Reload from the file which loaded before.
+   bool reload(const std::string &name, bool wait = true);
+
+   //Reload the tables which file modified time changed, return the count.
+   //The missing files and the failed loads are not retried until the file
+   //modified time changed.
+   int32_t reload_modified(bool wait = true);
+
+   //Get the current snapshot, keep it as long as need(lock free).
+   snapshot_t get(const std::string &name) const;
+   uint32_t get_version(const std::string &name) const;
+   bool has(const std::string &name) const;
+   //The loads submitted after it use the new one(the running keep theirs).
+   void set_prepare(prepare_t prepare);
+
+ private:
+   typedef struct slot_struct {
+     snapshot_t tab;
+     std::string filename;
+     std::atomic<uint32_t> version;
+     std::atomic<int64_t> modified;
+     std::atomic<uint64_t> generation; //The loads submitted.
+     uint64_t published; //The generation of the tab(under the mutex).
+     std::mutex mutex;
+     slot_struct() : version{0}, modified{0}, generation{0}, published{0} {}
+   } slot_t;
+   typedef std::unordered_map< std::string, std::shared_ptr<slot_t> >
+     slot_map_t;
+
+ private:
+   std::shared_ptr<slot_t> get_slot(const std::string &name) const;
+   std::shared_ptr<slot_t> add_slot(const std::string &name,
+                                    const std::string &filename);
+   //The load of an older generation not publish over a newer one.
+   bool load_slot(const std::string &name,
+                  std::shared_ptr<slot_t> slot,
+                  uint64_t generation,
+                  const prepare_t &prepare);
+   prepare_t get_prepare();
+   static int64_t get_modified(const std::string &filename);
+
+ private:
+   std::shared_ptr<const slot_map_t> slots_; //Copy on write by writers.
+   std::mutex mutex_; //Only for writers(and the prepare).
+   std::unique_ptr<pf_sys::ThreadPool> own_pool_;
+   pf_sys::ThreadPool *pool_;
+   prepare_t prepare_;
+   std::atomic<uint32_t> tab_id_;
+   std::atomic<int32_t> pending_; //The loading tasks in the pool.
+   std::mutex pending_mutex_;
+   std::condition_variable pending_condition_; //Signalled when pending 0.
+
+};
+
+} //namespace pf_file
+
+#endif //PF_FILE_TAB_REGISTRY_H_
@@ -16,6 +16,7 @@
 #define PF_NET_CONNECTION_BASE_H_
 
 #include "pf/net/connection/config.h"
+#include "pf/net/connection/manager/config.h"
 #include "pf/net/packet/interface.h"
 #include "pf/net/socket/basic.h"
 #include "pf/net/protocol/interface.h"
@@ -60,6 +61,7 @@ class PF_API Basic {
 
  public:
    virtual bool process_input();
+   bool input_pending() const; //The socket not drained by the last input.
    virtual bool process_output();
    virtual bool process_command();
    virtual bool heartbeat(uint32_t time = 0, uint32_t flag = 0);
@@ -70,6 +72,12 @@ class PF_API Basic {
    void set_id(int16_t id) { id_ = id; };
    int16_t get_managerid() const { return managerid_; };
    void set_managerid(int16_t managerid) { managerid_ = managerid; };
+   //The manager added it, nullptr if not in a manager.
+   manager::Interface *get_manager() const { return manager_; };
+   void set_manager(manager::Interface *manager) { manager_ = manager; };
+   //Changed when the connection cleared, the pooled id is reused by the
+   //others then the async results check it.
+   uint32_t get_generation() const { return generation_; };
    socket::Basic *socket() { return socket_.get(); };
 
  public:
@@ -88,10 +96,22 @@ class PF_API Basic {
    };
    void set_status(uint8_t status) { status_ = status; };
    uint8_t get_status() const { return status_; };
+   //The first packet executed, or set by the application handshake.
+   bool is_handshake() const { return handshake_; };
+   void set_handshake(bool handshake = true) { handshake_ = handshake; };
 
  public:
    void compress_set_mode(compress_mode_t mode);
    compress_mode_t compress_get_mode() const { return compress_mode_; };
+   //Codec negotiation: send compress_codecs() in the handshake packet, and
+   //call compress_negotiate with the remote codecs on both sides.
+   uint32_t compress_codecs() const;
+   uint8_t compress_negotiate(uint32_t remote_codecs);
+   bool compress_set_codec(uint8_t codec);
+   uint8_t compress_get_codec() const;
+   //The output compress policy, default off(the fixed 20KB threshold).
+   void compress_adaptive_enable(bool enable);
+   pf_util::compressor::Assistant::stat_t compress_stat() const;
    void encrypt_enable(bool enable);
    void encrypt_set_key(const char *key);
    uint32_t get_receive_bytes();
@@ -112,6 +132,8 @@ class PF_API Basic {
  private:
    int16_t id_;
    int16_t managerid_;
+   manager::Interface *manager_;
+   uint32_t generation_;
    std::unique_ptr<socket::Basic> socket_;
    std::unique_ptr<stream::Input> istream_;
    std::unique_ptr<stream::Input> istream_compress_;
@@ -136,6 +158,7 @@ class PF_API Basic {
    int8_t packet_index_;
    uint8_t execute_count_pretick_;
    uint8_t status_;
+   bool handshake_;
 
 };
 
@@ -17,7 +17,9 @@
 #define NET_CONNECTION_MAX 1024
 #define NET_CONNECTION_CACHESIZE_MAX 1024
 #define NET_CONNECTION_KICKTIME 6000000 //超过该时间则断开连接
-#define NET_CONNECTION_INCOME_KICKTIME 60000
+#define NET_CONNECTION_INCOME_KICKTIME 60000 //未完成握手则断开连接
+#define NET_CONNECTION_WRITE_KICKTIME 60000 //发送阻塞超过该时间则断开连接
+#define NET_CONNECTION_HEARTBEAT_INTERVAL 1000 //连接心跳的调用间隔
 #define NET_CONNECTION_POOL_SIZE_DEFAULT 1280 //连接池默认大小
 
 namespace pf_net {
@@ -32,6 +34,15 @@ typedef enum {
   kCompressModeAll = 3,     //无论是输入流还是输出流都压缩
 } compress_mode_t;
 
+//The reason of the timeout kick.
+typedef enum {
+  kKickReasonNone = 0,
+  kKickReasonIdle = 1,        //No data received in the kick time.
+  kKickReasonHandshake = 2,   //Not handshake in the income kick time.
+  kKickReasonWriteStall = 3,  //The output can't send in the write kick time.
+  kKickReasonHeartbeat = 4,   //The connection heartbeat returned false.
+} kick_reason_t;
+
 class Basic;
 class Pool;
 
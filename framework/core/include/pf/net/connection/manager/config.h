@@ -14,12 +14,17 @@
 #include "pf/net/connection/config.h"
 #include "pf/net/packet/config.h"
 
+#define NET_CONNECTOR_CONNECT_TIMEOUT 5000 //非阻塞连接的超时(毫秒)
+#define NET_CONNECTOR_BACKOFF_MIN 500 //重连的最小间隔(毫秒)
+#define NET_CONNECTOR_BACKOFF_MAX 30000 //重连的最大间隔(毫秒)
+
 namespace pf_net {
 
 namespace connection {
 
 namespace manager {
 
+class Interface;
 class Basic;
 class Listener;
 class Connector;
@@ -27,6 +32,19 @@ class Epool;
 class Iocp;
 class Select;
 
+//The state of the connector link.
+typedef enum {
+  kConnectStateNone = 0,        //Not connected, wait for the retry time.
+  kConnectStateConnecting = 1,  //Nonblocking connect is progress.
+  kConnectStateReady = 2,       //Connected and added to the manager.
+} connect_state_t;
+
+//How to select one link from the group.
+typedef enum {
+  kGroupSelectLeastLoaded = 0,  //The least output data.
+  kGroupSelectHash = 1,         //The same key to the same link if ready.
+} group_select_t;
+
 typedef PF_API struct cache_struct cache_t;
 struct cache_struct {
   packet::queue_t *queue;
@@ -24,14 +24,90 @@ namespace manager {
 class PF_API Connector : public Basic {
 
  public:
-   Connector() {};
+   Connector();
    virtual ~Connector() {};
 
+ public:
+   //The outbound link, connect nonblocking and reconnect when lost.
+   typedef struct link_struct {
+     std::string ip;
+     uint16_t port;
+     std::string group;
+     int8_t state;
+     int16_t connection_id;
+     bool reconnect;
+     bool registered;      //In the poll set, or check it in the tick.
+     uint32_t deadline;    //The connect timeout time.
+     uint32_t retry_time;  //The next connect time when not connected.
+     uint32_t backoff;
+     uint32_t attempts;    //The failed times from last ready.
+     link_struct() :
+       port{0},
+       state{kConnectStateNone},
+       connection_id{ID_INVALID},
+       reconnect{false},
+       registered{false},
+       deadline{0},
+       retry_time{0},
+       backoff{0},
+       attempts{0} {
+     }
+   } link_t;
+
  public:
    bool init(uint16_t max_size = NET_CONNECTION_MAX);
+   virtual void tick();
+   //Blocking connect, don't call them in the loop(use link).
    virtual connection::Basic *connect(const char *ip, uint16_t port);
    virtual connection::Basic *group_connect(const char *ip, uint16_t port);
 
+ public: //Links, the connect never block the loop.
+   //Return the link id, -1 if failed.
+   int32_t link(const char *ip, 
+                uint16_t port, 
+                const std::string &group = "", 
+                bool reconnect = true);
+   void unlink(int32_t id);
+   const link_t *get_link(int32_t id) const;
+   connection::Basic *link_connection(int32_t id);
+   //Select one ready connection of the group, nullptr if no one.
+   connection::Basic *group_select(const std::string &group, 
+                                   int8_t type = kGroupSelectLeastLoaded,
+                                   uint64_t key = 0);
+   uint16_t group_ready(const std::string &group) const;
+   void set_connect_timeout(uint32_t timeout) { connect_timeout_ = timeout; }
+   void set_reconnect_backoff(uint32_t min, uint32_t max) {
+     backoff_min_ = min; backoff_max_ = max;
+   }
+   //Called when the link connected and added to the manager.
+   void callback_ready(
+       std::function<void (connection::Basic *, int32_t)> callback) {
+     callback_ready_ = callback;
+   }
+
+ public:
+   virtual bool connecting_event(int16_t connection_id, bool error);
+   using Basic::remove;
+   virtual bool remove(int16_t id);
+
+ private:
+   void link_connect(int32_t id, uint32_t now);
+   void link_ready(int32_t id);
+   void link_failed(int32_t id, uint32_t now, const char *reason);
+   void link_free(int32_t id);
+   void link_poll();
+   int32_t link_of(int16_t connection_id) const;
+   uint32_t now() const;
+
+ private:
+   std::vector<link_t> links_;
+   std::vector<int32_t> connection_links_; //Index by the connection id.
+   std::map< std::string, std::vector<int32_t> > groups_;
+   uint32_t connect_timeout_;
+   uint32_t backoff_min_;
+   uint32_t backoff_max_;
+   std::function<void (connection::Basic *, int32_t)> callback_ready_;
+
 };
 
 } //namespace manager
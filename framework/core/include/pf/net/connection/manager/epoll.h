@@ -41,12 +41,17 @@ class PF_API Epoll : public Interface {
    virtual bool socket_add(int32_t socketid, int16_t connectionid);
    //将拥有fd句柄的玩家(服务器)数据从当前系统中清除
    virtual bool socket_remove(int32_t socketid);
+   virtual bool socket_add_connecting(int32_t socketid, int16_t connectionid);
 
  public:
    bool poll_set_max_size(uint16_t max_size);
 
+ private:
+   void connection_input(connection::Basic *connection);
+
  private:
    polldata_t polldata_;
+   std::vector<int16_t> pending_input_; //Edge trigger, read again next tick.
 
 };
 
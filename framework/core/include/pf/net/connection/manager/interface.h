@@ -19,6 +19,7 @@
 #include "pf/net/protocol/basic.h"
 #include "pf/net/connection/basic.h"
 #include "pf/net/connection/pool.h"
+#include "pf/net/connection/manager/timer_wheel.h"
 
 namespace pf_net {
 
@@ -51,6 +52,11 @@ class PF_API Interface {
    virtual bool destroy();
    virtual bool socket_add(int32_t socketid, int16_t connectionid) = 0;
    virtual bool socket_remove(int32_t socketid) = 0;
+   //The nonblocking connecting socket, only wait the writable event. False
+   //if not support(the connector check it self).
+   virtual bool socket_add_connecting(int32_t, int16_t) { return false; }
+   //The connecting socket writable or error, false if not connecting.
+   virtual bool connecting_event(int16_t, bool) { return false; }
    virtual bool is_service() const { return false; }
 
  public:
@@ -87,6 +93,26 @@ class PF_API Interface {
      callback_connect_ = callback;
    }
 
+   //Called before the timeout connection removed.
+   void callback_kick(
+       std::function<void (connection::Basic *, kick_reason_t)> callback) {
+     callback_kick_ = callback;
+   }
+
+ public: //Timeouts, the kick time is millisecond and 0 is disable.
+   void set_kicktime(uint32_t idle, uint32_t income, uint32_t write) {
+     kicktime_ = idle; income_kicktime_ = income; write_kicktime_ = write;
+   }
+   //The connection::Basic::heartbeat called in the interval(0 is disable),
+   //the connection is kicked if it returned false.
+   void set_heartbeat_interval(uint32_t interval) {
+     heartbeat_interval_ = interval;
+   }
+   //Receive data, just update the time(O(1), no wheel operation).
+   void timeout_receive(connection::Basic *connection);
+   //Output has data but nothing sent, or the sending is progress.
+   void timeout_write(connection::Basic *connection, bool stalled);
+
  public:
    bool checkpool(bool log = true);
 
@@ -133,6 +159,36 @@ class PF_API Interface {
    cache_t cache_;
    std::mutex mutex_;
 
+ protected:
+   typedef struct timeout_struct {
+     uint32_t receive_time;
+     uint32_t handshake_deadline; //0 is not need(the connector).
+     uint32_t write_deadline; //0 is not stalled.
+     uint32_t heartbeat_time; //The last connection heartbeat.
+     timeout_struct() : 
+       receive_time{0}, 
+       handshake_deadline{0}, 
+       write_deadline{0}, 
+       heartbeat_time{0} {}
+   } timeout_t;
+
+ protected:
+   void timeout_add(connection::Basic *connection, uint32_t now);
+   uint32_t timeout_deadline(connection::Basic *connection, 
+                             kick_reason_t &reason) const;
+   void timeout_expire(uint32_t now);
+
+ protected:
+   std::function<void (connection::Basic *, kick_reason_t)> callback_kick_;
+   TimerWheel timer_wheel_;
+   std::vector<timeout_t> timeouts_; //Index by the connection id.
+   std::vector<int16_t> expired_;
+   uint32_t kicktime_;
+   uint32_t income_kicktime_;
+   uint32_t write_kicktime_;
+   uint32_t heartbeat_interval_;
+   uint32_t now_; //The tick time of the heartbeat.
+
  private:
    std::thread::id thread_id_;
 
@@ -39,6 +39,9 @@ class PF_API Listener : public Basic {
      return listener_socket_ ? listener_socket_->host() : "";
    }
    virtual connection::Basic *accept(); //新连接接受处理
+   //The options of the accepted sockets, default is linger off.
+   void set_socket_option(const socket::option_t &option);
+   const socket::option_t &get_socket_option() const { return socket_option_; }
    int32_t listener_socket_id() const {
      return listener_socket_ ? listener_socket_->get_id() : SOCKET_INVALID;
    }
@@ -46,6 +49,7 @@ class PF_API Listener : public Basic {
  private:
    std::unique_ptr<socket::Listener> listener_socket_;
    bool ready_;
+   socket::option_t socket_option_;
 
 };
 
@@ -0,0 +1,78 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id timer_wheel.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2026/10/19 17:05
+ * @uses The hashed timing wheel of the connection timeouts, the entries
+ *       indexed by the connection id(no memory alloc when schedule), the
+ *       schedule and cancel are O(1) and advance only visit the passed slots.
+ *       The deadline far than one round stay in the slot until it expired.
+ */
+#ifndef PF_NET_CONNECTION_MANAGER_TIMER_WHEEL_H_
+#define PF_NET_CONNECTION_MANAGER_TIMER_WHEEL_H_
+
+#include "pf/net/connection/manager/config.h"
+
+#define NET_CONNECTION_TIMER_WHEEL_SLOT_TIME 100 //ms
+#define NET_CONNECTION_TIMER_WHEEL_SLOT_COUNT 512
+
+namespace pf_net {
+
+namespace connection {
+
+namespace manager {
+
+class PF_API TimerWheel {
+
+ public:
+   TimerWheel();
+   ~TimerWheel();
+
+ public:
+   bool init(uint16_t size, 
+             uint32_t now,
+             uint32_t slot_time = NET_CONNECTION_TIMER_WHEEL_SLOT_TIME,
+             uint32_t slot_count = NET_CONNECTION_TIMER_WHEEL_SLOT_COUNT);
+   void resize(uint16_t size); //The id must less than the size.
+   void schedule(int16_t id, uint32_t deadline);
+   void cancel(int16_t id);
+   bool is_scheduled(int16_t id) const;
+   uint32_t get_deadline(int16_t id) const;
+   uint32_t size() const { return count_; }
+
+   //Pop the expired ids to the list, return the count.
+   uint32_t advance(uint32_t now, std::vector<int16_t> &expired);
+
+ private:
+   typedef struct entry_struct {
+     uint32_t deadline;
+     int32_t slot;
+     int16_t prev;
+     int16_t next;
+     entry_struct() : 
+       deadline{0}, slot{INDEX_INVALID}, prev{ID_INVALID}, next{ID_INVALID} {}
+   } entry_t;
+
+ private:
+   void unlink(int16_t id);
+
+ private:
+   std::vector<entry_t> entries_;
+   std::vector<int16_t> slots_; //The list head of the slot.
+   uint32_t slot_time_;
+   uint32_t time_; //The time of the current slot(the slots relative to it).
+   uint32_t current_; //The slot processed.
+   uint32_t count_;
+
+};
+
+} //namespace manager
+
+} //namespace connection
+
+} //namespace pf_net
+
+#endif //PF_NET_CONNECTION_MANAGER_TIMER_WHEEL_H_
@@ -0,0 +1,72 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id profiler.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2026/10/19 22:05
+ * @uses The packet execute profiler(off default).
+ *       When enabled the protocol records the bytes and the execute time of
+ *       each packet id into the metrics families, the execute slower than
+ *       the threshold is saved to the log with the connection and the size.
+ *       The report is the packet ids sorted by the total execute time.
+ */
+#ifndef PF_NET_PROTOCOL_PROFILER_H_
+#define PF_NET_PROTOCOL_PROFILER_H_
+
+#include "pf/net/protocol/config.h"
+#include "pf/net/connection/config.h"
+
+namespace pf_net {
+
+namespace protocol {
+
+typedef struct profile_struct {
+  uint16_t id;
+  uint64_t count;
+  uint64_t bytes;
+  uint64_t total; //Microseconds.
+  uint64_t max;
+  uint64_t p99;
+  profile_struct() : id{0}, count{0}, bytes{0}, total{0}, max{0}, p99{0} {}
+} profile_t;
+
+class PF_API Profiler {
+
+ public:
+   static void set_enable(bool enable);
+   static bool enable() { return enable_.load(std::memory_order_relaxed); }
+   //The slow threshold(microseconds), 0 not log the slow packets.
+   static void set_slow(uint64_t slow) { slow_ = slow; }
+   static uint64_t slow() { return slow_.load(std::memory_order_relaxed); }
+
+ public:
+   static void record(connection::Basic *connection, 
+                      uint16_t id, 
+                      uint32_t size, 
+                      uint64_t time);
+   //The top packet ids by the total time, 0 is all.
+   static void report(std::vector<profile_t> &result, size_t top = 0);
+   static std::string report_text(size_t top = 0);
+   static void log(size_t top = 0);
+
+ public:
+   //Safe in the signal handler, the kernel loop logs the report.
+   static void request_report() { report_requested_ = true; }
+   static bool report_requested() { 
+     return report_requested_.exchange(false); 
+   }
+
+ private:
+   static std::atomic<bool> enable_;
+   static std::atomic<uint64_t> slow_;
+   static std::atomic<bool> report_requested_;
+
+};
+
+} //namespace protocol
+
+} //namespace pf_net
+
+#endif //PF_NET_PROTOCOL_PROFILER_H_
@@ -15,9 +15,11 @@
 
 #if OS_UNIX
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #elif OS_WIN
 #include <winsock.h>
 #endif
@@ -85,6 +87,14 @@ PF_API int32_t recvex(int32_t socketid,
                       uint32_t length, 
                       uint32_t flag);
 
+//Receive into two buffers with one call(readv), like the free segments of
+//a ring buffer, the length2 can be 0.
+PF_API int32_t recvvex(int32_t socketid, 
+                       void *buffer1, 
+                       uint32_t length1, 
+                       void *buffer2, 
+                       uint32_t length2);
+
 PF_API int32_t recvfrom_ex(int32_t socketid, 
                            void *buffer, 
                            int32_t length, 
@@ -92,6 +102,11 @@ PF_API int32_t recvfrom_ex(int32_t socketid,
                            struct sockaddr* from, 
                            uint32_t *fromlength);
 
+//Accept a nonblocking socket with one call if can(accept4 on linux).
+PF_API int32_t accept_nonblocking_ex(int32_t socketid, 
+                                     struct sockaddr *addr, 
+                                     uint32_t *addrlength);
+
 PF_API bool closeex(int32_t socketid);
 
 PF_API bool ioctlex(int32_t socketid, int64_t cmd, uint64_t *argp);
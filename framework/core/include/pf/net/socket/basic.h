@@ -33,8 +33,13 @@ class PF_API Basic {
    bool reconnect(const char *host, uint16_t port);
    int32_t send(const void *buffer, uint32_t length, uint32_t flag = 0);
    int32_t receive(void *buffer, uint32_t length, uint32_t flag = 0);
+   int32_t receivev(void *buffer1, 
+                    uint32_t length1, 
+                    void *buffer2, 
+                    uint32_t length2);
    uint32_t available() const;
-   int32_t accept(struct sockaddr_in *accept_sockaddr_in = nullptr);
+   int32_t accept(struct sockaddr_in *accept_sockaddr_in = nullptr,
+                  bool nonblocking = false);
    bool bind(const char *ip = nullptr);
    bool bind(uint16_t port, const char *ip = nullptr);
    bool listen(uint32_t backlog);
@@ -51,13 +56,21 @@ class PF_API Basic {
    bool set_reuseaddr(bool on = true);
    uint32_t get_last_error_code() const;
    void get_last_error_message(char *buffer, uint16_t length) const;
-   bool error() const; //socket if has error
+   //The error state is cached, updated by the failed send/receive and the
+   //poll events(call check_error), so no syscall when nothing failed.
+   bool error() const { return error_ != 0; }
+   int32_t get_error() const { return error_; }
+   void set_error(int32_t code) { error_ = code; }
+   bool check_error(); //Query the kernel(SO_ERROR) and cache it.
    bool is_nonblocking() const;
    bool set_nonblocking(bool on = true);
    uint32_t get_receive_buffer_size() const;
    bool set_receive_buffer_size(uint32_t size);
    uint32_t get_send_buffer_size() const;
    bool set_send_buffer_size(uint32_t size);
+   bool set_nodelay(bool on = true);
+   bool set_keepalive(bool on = true);
+   bool apply_option(const option_t &option);
    uint16_t port() const { return port_; };
    uint64_t uint64host() const;
    const char *host() { return host_; };
@@ -65,16 +78,20 @@ class PF_API Basic {
    int32_t get_id() const { return id_; };
    
  public:
-   void set_id(int32_t id) { id_ = id; };
+   void set_id(int32_t id) { id_ = id; error_ = 0; };
    void set_host(const char *_host) { 
      pf_basic::string::safecopy(host_, _host, sizeof(host_));
    };
    void set_port(uint16_t _port) { port_ = _port; };
 
+ private:
+   int32_t last_error() const;
+
  private:
    int32_t id_;
    char host_[IP_SIZE]; //两层含义，连接时则为目的IP，接受时为客户IP
    uint16_t port_;
+   int32_t error_;
 
 };
 
@@ -36,6 +36,7 @@
 #define SOCKET_WOULD_BLOCK EWOULDBLOCK //api use SOCKET_ERROR_WOULD_BLOCK
 #define SOCKET_CONNECT_ERROR EINPROGRESS
 #define SOCKET_CONNECT_TIMEOUT 10
+#define SOCKET_LISTEN_BACKLOG_DEFAULT 1024 //The kernel limit it to somaxconn.
 
 namespace pf_net {
 
@@ -59,6 +60,47 @@ typedef struct streamdata_struct {
   }
 } streamdata_t;
 
+//The socket options template, apply once to the listener then the accepted
+//sockets inherit them(linux), the negative value is not set.
+typedef struct option_struct {
+  int8_t nodelay;               //TCP_NODELAY
+  int8_t keepalive;             //SO_KEEPALIVE
+  int32_t linger;               //SO_LINGER seconds, 0 is off.
+  int32_t send_buffer_size;     //SO_SNDBUF
+  int32_t receive_buffer_size;  //SO_RCVBUF
+  option_struct() :
+    nodelay{-1},
+    keepalive{-1},
+    linger{-1},
+    send_buffer_size{-1},
+    receive_buffer_size{-1} {
+  }
+} option_t;
+
+//The presets.
+inline option_t option_default() {
+  return option_t();
+}
+
+//The interactive connections(like the game client), send the small packet
+//immediately.
+inline option_t option_lowlatency() {
+  option_t option;
+  option.nodelay = 1;
+  option.keepalive = 1;
+  return option;
+}
+
+//The servers connections, big buffers for the throughput.
+inline option_t option_bulk() {
+  option_t option;
+  option.nodelay = 0;
+  option.keepalive = 1;
+  option.send_buffer_size = 256 * 1024;
+  option.receive_buffer_size = 256 * 1024;
+  return option;
+}
+
 } //namespace socket
 
 } //namespace pf_net
@@ -20,12 +20,15 @@ namespace socket {
 class PF_API Listener {
 
  public:
-   Listener(uint16_t port, const std::string &ip = "", uint32_t backlog = 5);
+   Listener(uint16_t port, 
+            const std::string &ip = "", 
+            uint32_t backlog = SOCKET_LISTEN_BACKLOG_DEFAULT);
    ~Listener();
 
  public:
    void close();
-   bool accept(pf_net::socket::Basic *socket);
+   //The nonblocking socket accept with one call(accept4) if can.
+   bool accept(pf_net::socket::Basic *socket, bool nonblocking = false);
    uint32_t get_linger() const;
    bool set_linger(uint32_t lingertime);
    bool is_nonblocking() const;
@@ -34,6 +37,10 @@ class PF_API Listener {
    bool set_receive_buffer_size(uint32_t size);
    uint32_t get_send_buffer_size() const;
    bool set_send_buffer_size(uint32_t size);
+   //Apply to the listen socket, the accepted sockets inherit them on linux.
+   bool apply_option(const option_t &option) {
+     return socket_ ? socket_->apply_option(option) : false;
+   };
    int32_t get_id() const { 
      return socket_ ? socket_->get_id() : SOCKET_INVALID; 
    };
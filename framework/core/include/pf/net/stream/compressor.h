@@ -18,13 +18,23 @@
 #include "pf/net/stream/config.h"
 #include "pf/net/stream/encryptor.h"
 #include "pf/util/compressor/assistant.h"
+#include "pf/util/compressor/codec.h"
 
+//The frame header is the size with the top bit, if the size not less than
+//0x7FFF then the header is 0xFFFF and follow the uint32_t size.
 #define NET_STREAM_COMPRESSOR_HEADER_SIZE 2
-#define NET_STREAM_COMPRESSOR_IN_SIZE (1024 * 20)
+#define NET_STREAM_COMPRESSOR_HEADER_SIZE_MAX 6
+#define NET_STREAM_COMPRESSOR_IN_SIZE (1024 * 20) //The min if not adaptive.
+#define NET_STREAM_COMPRESSOR_FRAME_MAX (256 * 1024) //The uncompressed max.
+//The out buffer of a frame, the codecs worst(lzo) expansion and the header.
+#define NET_STREAM_COMPRESSOR_OUT_BOUND(size) \
+  ((size) + (size)/16 + 64 + 3 + NET_STREAM_COMPRESSOR_HEADER_SIZE_MAX)
+//The out buffer allocated when enable, grow to the max on the first frame
+//larger than the in size.
 #define NET_STREAM_COMPRESSOR_OUT_SIZE \
-  (NET_STREAM_COMPRESSOR_IN_SIZE + \
-   NET_STREAM_COMPRESSOR_IN_SIZE/16 + 64 + 3 + \
-   NET_STREAM_COMPRESSOR_HEADER_SIZE)
+  NET_STREAM_COMPRESSOR_OUT_BOUND(NET_STREAM_COMPRESSOR_IN_SIZE)
+#define NET_STREAM_COMPRESSOR_OUT_SIZE_MAX \
+  NET_STREAM_COMPRESSOR_OUT_BOUND(NET_STREAM_COMPRESSOR_FRAME_MAX)
 #define NET_STREAM_COMPRESSOR_SIZE_MIN 100
 
 namespace pf_net {
@@ -39,11 +49,24 @@ class PF_API Compressor {
 
  public:
    bool compress(const char *in, uint32_t insize, char *out, uint32_t &outsize);
+   //The in is the frame data without header, outsize is the out capacity.
    bool decompress(const char *in, uint32_t insize, char *out, uint32_t &outsize);
 
+ public:
+   bool set_codec(uint8_t codec);
+   uint8_t get_codec() const { return codec_->id(); }
+   //Clear the stream context(dictionary), when the connection reused.
+   void resetcontext() { context_.reset(); }
+   //Return the header size and get the frame size, 0 if not enough.
+   static uint32_t read_header(const char *buffer, 
+                               uint32_t size, 
+                               uint32_t &framesize);
+
  public:
    void clear();
    bool alloc(uint32_t size);
+   //Grow the buffer for the frame of the in size, only when it empty.
+   bool reserve(uint32_t insize);
    char *getbuffer();
    char *getheader();
    uint32_t getsize() const;
@@ -68,6 +91,8 @@ class PF_API Compressor {
    uint32_t maxsize_;
    Encryptor *encryptor_;
    pf_util::compressor::Assistant assistant_;
+   pf_util::compressor::Codec *codec_;
+   std::unique_ptr<pf_util::compressor::CodecContext> context_;
 
 };
 
@@ -15,6 +15,7 @@
 
 #define NETINPUT_BUFFERSIZE_DEFAULT (64*1024) //default size
 #define NETINPUT_DISCONNECT_MAXSIZE (96*1024) //if buffer more than it, disconnet.
+#define NETINPUT_FILL_BUDGET_DEFAULT (256*1024) //The max bytes of one fill.
 #define NETOUTPUT_BUFFERSIZE_DEFAULT (8*1024)
 #define NETOUTPUT_DISCONNECT_MAXSIZE (100*1024)
 
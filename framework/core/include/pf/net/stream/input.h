@@ -25,7 +25,10 @@ class PF_API Input : public Basic {
        socket::Basic *_socket, 
        uint32_t bufferlength = NETINPUT_BUFFERSIZE_DEFAULT, 
        uint32_t bufferlength_max = NETINPUT_DISCONNECT_MAXSIZE)
-     : Basic(_socket, bufferlength, bufferlength_max) {};
+     : Basic(_socket, bufferlength, bufferlength_max),
+     fill_budget_{NETINPUT_FILL_BUDGET_DEFAULT},
+     pending_{false},
+     eof_{false} {};
    virtual ~Input() {};
    
  public:
@@ -34,6 +37,11 @@ class PF_API Input : public Basic {
    bool peek(char *buffer, uint32_t length);
    bool skip(uint32_t length);
    int32_t fill();
+   //The socket may has more data after fill(edge trigger), fill it again.
+   bool pending() const { return pending_; }
+   void set_fill_budget(uint32_t budget) { fill_budget_ = budget; }
+   uint32_t get_fill_budget() const { return fill_budget_; }
+   void clear() { Basic::clear(); pending_ = eof_ = false; }
 
  public:
    int8_t read_int8();
@@ -45,6 +53,8 @@ class PF_API Input : public Basic {
    int64_t read_int64();
    uint64_t read_uint64();
    void read_string(char *buffer, size_t size);
+   //Read the exact bytes(binary safe), false if the length bigger than max.
+   bool read_string(std::string &value, size_t max);
    float read_float();
    double read_double();
 
@@ -91,13 +101,10 @@ class PF_API Input : public Basic {
      read(var, _size);
      return *this;
    };
-   Input &operator >> (std::string &var) { //Need optimize
+   Input &operator >> (std::string &var) {
      uint32_t _size = read_uint32();
-     auto temp = new char[_size];
-     memset(temp, 0, _size);
-     read(temp, _size);
-     var = temp;
-     safe_delete(temp);
+     var.resize(_size);
+     if (_size > 0) read(&var[0], _size);
      return *this;
    };
 
@@ -106,6 +113,11 @@ class PF_API Input : public Basic {
    uint32_t write(const char *buffer, uint32_t length); //why? not receive just copy from memory
                                                         //outputstream have same name function
 
+ private:
+   uint32_t fill_budget_;
+   bool pending_;
+   bool eof_; //Peer closed, disconnect after the data handled.
+
 };
 
 } //namespace socket
@@ -17,12 +17,21 @@ namespace pf_sys {
 
 class ThreadCollect;
 class ThreadPool;
+class WorkPool;
 
 enum {
   kThreadStatusStop = 0,
   kThreadStatusRun,
 };
 
+//The work pool task lanes, the higher priority tasks run first.
+typedef enum {
+  kTaskPriorityHigh = 0,
+  kTaskPriorityNormal = 1,
+  kTaskPriorityLow = 2,
+  kTaskPriorityCount,
+} task_priority_t;
+
 } //namespace pf_sys
 
 #endif //PF_SYS_CONFIG_H_
@@ -52,6 +52,37 @@ enum {
   kUseFreeEx = 4,
 }; // 共享内存的使用状态
 
+//The segment backend.
+typedef enum {
+  kBackendSysV = 0,   //shmget by the key.
+  kBackendPosix = 1,  //shm_open("/pf_share_<key>").
+  kBackendFile = 2,   //The file "<path>/pf_share_<key>"(hugetlbfs or any).
+} backend_t;
+
+typedef enum {
+  kHugePageNone = 0,
+  kHugePageAdvise = 1,  //Transparent huge pages(madvise).
+  kHugePageTLB = 2,     //The reserved huge pages(SysV SHM_HUGETLB, a file
+                        //backend must be on hugetlbfs).
+} huge_page_t;
+
+//The segment option of a share key.
+typedef struct option_struct {
+  backend_t backend;
+  huge_page_t huge_page;
+  bool populate;        //Fault in all the pages when mapped.
+  int32_t numa_node;    //Bind the pages to the node, -1 not bind.
+  bool lazy_zero;       //Not clear the new segment(the new pages are zero).
+  std::string path;     //The directory of the file backend.
+  option_struct() :
+    backend{kBackendSysV},
+    huge_page{kHugePageNone},
+    populate{false},
+    numa_node{-1},
+    lazy_zero{true},
+    path{"/dev/shm"} {}
+} option_t;
+
 class MapPool;
 class Map;
 
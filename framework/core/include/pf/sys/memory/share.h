@@ -31,7 +31,8 @@ typedef bool (__stdcall *function_node_save)(void *, void *);
 namespace api {
 
 #if OS_UNIX
-PF_API int32_t create(uint32_t key, size_t size);
+//The flag is the extra flag of shmget(like SHM_HUGETLB).
+PF_API int32_t create(uint32_t key, size_t size, int32_t flag = 0);
 PF_API int32_t open(uint32_t key, size_t size, bool errorlog = true);
 PF_API void close(int32_t handle);
 PF_API char *map(int32_t handle);
@@ -45,6 +46,11 @@ PF_API void unmap(char *pointer);
 
 } //namespace api
 
+//The segment option by the share key(key 0 is the default of all keys), set
+//it before the pools init.
+PF_API void set_option(uint32_t key, const option_t &option);
+PF_API option_t get_option(uint32_t key);
+
 class PF_API Base {
 
  public:
@@ -61,11 +67,23 @@ class PF_API Base {
    bool dump(const char *filename);
    bool merge(const char *filename);
    size_t size() const { return size_; };
+   //Created by this and the option is lazy zero, the pages are zero.
+   bool zeroed() const { return zeroed_; }
+   const option_t &option() const { return option_; }
+
+ private:
+   bool map_create(uint32_t key, size_t size);
+   bool map_attach(uint32_t key, size_t size);
+   void map_release();
+   void map_advise();
 
  private:
    size_t size_;
    char *data_;
    char *header_;
+   option_t option_;
+   size_t map_size_; //The mapped size(huge pages aligned).
+   bool zeroed_;
 #if OS_UNIX
    int32_t handle_;
 #elif OS_WIN
@@ -89,6 +107,8 @@ struct PF_API header_struct {
 
 PF_API void lock(mutex_t &mutex, int8_t type);
 PF_API void unlock(mutex_t &mutex, int8_t type);
+//Lock it if free, not wait.
+PF_API bool try_lock(mutex_t &mutex, int8_t type);
 
 template <typename T>
 class unique_lock {
@@ -206,13 +226,14 @@ class UnitPool {
 //One item size:
 //same_header: sizeof(group_item_header_t) + header_size + size * data_size;
 //not same_header: sizeof(group_item_header_t) + (header_size + data_size) * size;
+//The data address: item start + data_offset + stride * data_index.
 struct group_item_struct {
   
   int16_t index;
   
   size_t size; //Data count.
 
-  uint32_t position;
+  size_t position; //From the group header.
 
   size_t header_size;
 
@@ -222,6 +243,10 @@ struct group_item_struct {
 
   std::string name; //The group item name.
 
+  size_t stride; //The bytes of one data(with the header if not same).
+
+  size_t data_offset; //The first data from the item start.
+
   group_item_struct() : 
     index{0},
     size{0},
@@ -229,7 +254,9 @@ struct group_item_struct {
     header_size{0},
     data_size{0},
     same_header{true},
-    name{""} {}
+    name{""},
+    stride{0},
+    data_offset{0} {}
 };
 
 struct group_header_struct {
@@ -243,7 +270,11 @@ struct group_header_struct {
 struct group_item_header_struct {
 
   //The item memory position.
-  int16_t pool_position;
+  int32_t pool_position;
+
+  //The layout(check it when attach).
+  uint32_t size;
+  uint32_t stride;
 
   //Lock.
   mutex_t mutex;
@@ -270,6 +301,8 @@ struct group_item_header_struct {
 
   group_item_header_struct() :
     pool_position{0},
+    size{0},
+    stride{0},
     mutex{kFlagFree},
     version{0},
     status{0} {}
@@ -292,25 +325,41 @@ class GroupPool {
    uint32_t key() const { return key_; };
    size_t size() const { return size_; };
    group_item_header_t *item_header(int16_t index);
-   char *item_data_header(int16_t index, int16_t data_index);
-   char *item_data(int16_t index, int16_t data_index);
-   int32_t item_data_postion(int16_t index, int16_t data_index);
+   char *item_data_header(int16_t index, int32_t data_index);
+   char *item_data(int16_t index, int32_t data_index);
+   int64_t item_data_postion(int16_t index, int32_t data_index);
+   //The layout of the item, nullptr if the index not exists.
+   const group_item_t *item_conf(int16_t index) const {
+     return is_valid_index(index) ? &group_conf_[index] : nullptr;
+   }
 
  public:
    //Free all.
    void free();
 
  public:  //分配与归还内存块，根据每组数据实现
-   char *alloc(int16_t index, int16_t &data_index);
-   int16_t free(int16_t index, int16_t data_index); //return swap index.
+   char *alloc(int16_t index, int32_t &data_index);
+   int32_t free(int16_t index, int32_t data_index); //return swap index.
+   //The same, but the swap row(the last, its data is T with the mutex) is
+   //locked with the flag while moved, the caller holds the lock of the data
+   //index row with the same flag, so a reader locked a row not copy it half.
+   template <typename T>
+   int32_t free(int16_t index, int32_t data_index, int8_t flag);
+
+ private:
+   void move_row(int16_t index, int32_t from, int32_t to);
 
  private:
-   bool is_valid_index(int16_t index) {
-     return group_conf_.find(index) != group_conf_.end();
+   bool is_valid_index(int16_t index) const {
+     return index >= 0 && 
+            static_cast<size_t>(index) < group_conf_.size() &&
+            group_conf_[index].index == index;
    };
+   bool check_layout(); //The attached segment has the same layout.
 
  private:
-   std::map< int16_t, group_item_t > group_conf_;
+   std::vector< group_item_t > group_conf_; //Dense by the index.
+   std::vector< char * > group_data_; //The item start of each index.
    std::unique_ptr< Base > ref_obj_pointer_;
    uint32_t key_;
    size_t size_; //Full memory size.
@@ -81,7 +81,7 @@ bool UnitPool<T>::init(uint32_t _key, size_t _size, uint8_t type) {
                    (sizeof(T) + data_extend_size_ ) * _size;
   result = ref_obj_pointer_->attach(_key, full_size, false);
   if (kSmptDefault == type && !result) {
-    result = ref_obj_pointer_->create(key, full_size);
+    result = ref_obj_pointer_->create(_key, full_size);
     need_init = true;
   } else if (!result) {
     return false;
@@ -102,7 +102,7 @@ bool UnitPool<T>::init(uint32_t _key, size_t _size, uint8_t type) {
   for (decltype(size_) i = 0; i < size_; ++i) {
     auto objsize = static_cast<uint32_t>(sizeof(T) + data_extend_size_);
     char *data = ref_obj_pointer_->get(objsize, i);
-    if (data_extend_size_ > 0 && need_init) {
+    if (data_extend_size_ > 0 && need_init && !ref_obj_pointer_->zeroed()) {
       memset(&data[sizeof(T)], 0, data_extend_size_);
     }
     objs_[i] = reinterpret_cast<T *>(data);
@@ -358,6 +358,34 @@ void Node<T>::set_minutes(uint32_t index, uint32_t minutes) {
   }
 }
 
+template <typename T>
+int32_t GroupPool::free(int16_t index, int32_t data_index, int8_t flag) {
+  group_item_header_t *_header = item_header(index);
+  Assert(_header);
+  if (is_null(_header)) return INDEX_INVALID;
+  for (;;) {
+    {
+      unique_lock<group_item_header_t> auto_lock(*_header, kFlagMixedWrite);
+      auto last = _header->pool_position - 1;
+      if (last < 0) return INDEX_INVALID;
+      if (data_index >= last) {
+        _header->pool_position = last;
+        return INDEX_INVALID;
+      }
+      //The swap row may be locked by a thread waiting the header(freeing the
+      //last row), so not wait it with the header locked.
+      auto swap = reinterpret_cast<T *>(item_data(index, last));
+      if (try_lock(swap->mutex, flag)) {
+        _header->pool_position = last;
+        move_row(index, last, data_index);
+        unlock(swap->mutex, flag);
+        return last;
+      }
+    }
+    std::this_thread::yield();
+  }
+}
+
 inline void clear(int32_t key) {
 #if OS_UNIX
   char cmd[256]{0}; char result[512]{0};
@@ -25,6 +25,46 @@ typedef struct {
   uint64_t RSS;
 } info_t;
 
+//The resource usage of the current process read from /proc(linux only), the
+//cpu times are clock ticks and the memory are KB.
+typedef struct usage_struct {
+  uint64_t utime;
+  uint64_t stime;
+  uint64_t minflt;
+  uint64_t majflt;
+  uint64_t threads;
+  uint64_t vsz;
+  uint64_t rss;
+  uint64_t swap;
+  uint64_t fds;
+  uint64_t voluntary_switches;
+  uint64_t involuntary_switches;
+  uint64_t system_total;        //The ticks of all cpus(/proc/stat).
+  uint64_t system_steal;        //The ticks stolen by the hypervisor.
+  usage_struct() :
+    utime{0},
+    stime{0},
+    minflt{0},
+    majflt{0},
+    threads{0},
+    vsz{0},
+    rss{0},
+    swap{0},
+    fds{0},
+    voluntary_switches{0},
+    involuntary_switches{0},
+    system_total{0},
+    system_steal{0} {}
+} usage_t;
+
+//The scheduler statistics of a thread, the times are nanoseconds.
+typedef struct schedstat_struct {
+  uint64_t run;                 //On the cpu.
+  uint64_t delay;               //Runnable but waiting on the run queue.
+  uint64_t timeslices;
+  schedstat_struct() : run{0}, delay{0}, timeslices{0} {}
+} schedstat_t;
+
 PF_API int32_t getid();
 PF_API int32_t getid(const char *filename);
 PF_API bool writeid(const char *filename);
@@ -35,6 +75,13 @@ PF_API float get_cpu_usage(int32_t id);
 PF_API uint64_t get_virtualmemory_usage(int32_t id);
 PF_API uint64_t get_physicalmemory_usage(int32_t id);
 PF_API bool daemon();
+//Read the files not fork the commands, it can call frequently.
+PF_API bool get_usage(usage_t &usage);
+PF_API bool get_schedstat(int32_t threadid, schedstat_t &stat);
+//The kernel id of the current thread(not the std::thread::id).
+PF_API int32_t get_threadid();
+//The clock ticks per second of the cpu times.
+PF_API int64_t get_clockticks();
 
 inline void print_curinfo() {
   pf_basic::io_cdebug("cpu: %.1f%% VSZ: %dk RSS: %dk",
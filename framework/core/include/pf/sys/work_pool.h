@@ -0,0 +1,243 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id work_pool.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2026/10/19 18:50
+ * @uses The work stealing thread pool.
+ *       Each worker has own queue(one lane each priority), the tasks posted
+ *       from a worker go to its queue, others are spread to the queues. A
+ *       worker runs own tasks and steals from the others when empty, so the
+ *       threads not contend on one lock like the ThreadPool.
+ *       The small functions are stored in the task(no heap allocation).
+ */
+#ifndef PF_SYS_WORK_POOL_H_
+#define PF_SYS_WORK_POOL_H_
+
+#include "pf/sys/config.h"
+#include <cstddef>
+#include <deque>
+#include <exception>
+
+//The functions not bigger than it are stored in the task.
+#define SYS_TASK_STORAGE_SIZE (48)
+
+namespace pf_sys {
+
+template <typename F>
+struct task_is_small : std::integral_constant<bool, 
+  sizeof(F) <= SYS_TASK_STORAGE_SIZE &&
+  alignof(F) <= alignof(std::max_align_t) &&
+  std::is_nothrow_move_constructible<F>::value> {};
+
+//The move only function of the work pool.
+class Task {
+
+ public:
+   Task() : invoke_{nullptr}, manage_{nullptr} {}
+   template <typename F,
+             typename = typename std::enable_if<!std::is_same<
+               typename std::decay<F>::type, Task>::value>::type>
+   Task(F &&f) : invoke_{nullptr}, manage_{nullptr} {
+     using function_t = typename std::decay<F>::type;
+     store<function_t>(std::forward<F>(f), task_is_small<function_t>());
+   }
+   Task(Task &&other) noexcept : invoke_{nullptr}, manage_{nullptr} {
+     move(other);
+   }
+   Task &operator = (Task &&other) noexcept {
+     if (this != &other) {
+       reset();
+       move(other);
+     }
+     return *this;
+   }
+   ~Task() { reset(); }
+   Task(const Task &) = delete;
+   Task &operator = (const Task &) = delete;
+
+ public:
+   void operator()() { invoke_(&storage_); }
+   explicit operator bool() const { return !is_null(invoke_); }
+   void reset() {
+     if (manage_) manage_(&storage_, nullptr);
+     invoke_ = nullptr;
+     manage_ = nullptr;
+   }
+
+ private:
+   typedef void (*invoke_t)(void *);
+   //Move the src to dst and destroy the src, or destroy the dst if no src.
+   typedef void (*manage_t)(void *dst, void *src);
+
+ private:
+   template <typename F, typename T>
+   void store(T &&f, std::true_type) {
+     new (&storage_) F(std::forward<T>(f));
+     invoke_ = [](void *p) { (*static_cast<F *>(p))(); };
+     manage_ = [](void *dst, void *src) {
+       if (src) {
+         new (dst) F(std::move(*static_cast<F *>(src)));
+         static_cast<F *>(src)->~F();
+       } else {
+         static_cast<F *>(dst)->~F();
+       }
+     };
+   }
+   template <typename F, typename T>
+   void store(T &&f, std::false_type) {
+     *reinterpret_cast<F **>(&storage_) = new F(std::forward<T>(f));
+     invoke_ = [](void *p) { (**static_cast<F **>(p))(); };
+     manage_ = [](void *dst, void *src) {
+       if (src) {
+         *static_cast<F **>(dst) = *static_cast<F **>(src);
+       } else {
+         delete *static_cast<F **>(dst);
+       }
+     };
+   }
+   void move(Task &other) {
+     if (is_null(other.invoke_)) return;
+     other.manage_(&storage_, &other.storage_);
+     invoke_ = other.invoke_;
+     manage_ = other.manage_;
+     other.invoke_ = nullptr;
+     other.manage_ = nullptr;
+   }
+
+ private:
+   typename std::aligned_storage<
+     SYS_TASK_STORAGE_SIZE, alignof(std::max_align_t)>::type storage_;
+   invoke_t invoke_;
+   manage_t manage_;
+
+};
+
+class PF_API WorkPool {
+
+ public:
+   explicit WorkPool(size_t threads);
+   ~WorkPool(); //Run the rest tasks then join the workers.
+
+ public:
+   //Post a task without result.
+   template <class F>
+   void post(F &&f, task_priority_t priority = kTaskPriorityNormal) {
+     push(Task(std::forward<F>(f)), priority);
+   }
+   //The same as ThreadPool::enqueue.
+   template <class F, class... Args>
+   auto enqueue(F&& f, Args&&... args)
+   -> std::future<typename std::result_of<F(Args...)>::type>;
+   //Post the functions of the range, spread to the workers at once.
+   template <class Iterator>
+   void enqueue_bulk(Iterator first,
+                     Iterator last,
+                     task_priority_t priority = kTaskPriorityNormal);
+   //Call f(i) for each i in [begin, end) with the workers and the caller,
+   //return after all finished. The grain is the count of each task(0 auto).
+   //The first exception of f is rethrown after all the chunks finished.
+   template <class F>
+   void parallel_for(size_t begin, size_t end, F &&f, size_t grain = 0);
+
+ public:
+   //Run one pending task in the caller thread, false if nothing.
+   bool run_one();
+   size_t size() const { return workers_.size(); }
+   size_t pending() const { return pending_; }
+   uint64_t steals() const { return steals_; }
+
+ private:
+   typedef struct queue_struct {
+     std::mutex mutex;
+     std::deque<Task> lanes[kTaskPriorityCount];
+   } queue_t;
+
+ private:
+   void push(Task &&task, task_priority_t priority);
+   void push_bulk(std::vector<Task> &tasks, task_priority_t priority);
+   bool pop(size_t index, Task &task);
+   bool pop_lane(size_t index, int32_t lane, bool steal, Task &task);
+   void work(size_t index);
+   void execute(Task &task); //The exception is logged, not leave the worker.
+   void notify(size_t count);
+   size_t current() const; //The worker index of the caller or the size.
+
+ private:
+   std::vector< std::unique_ptr<queue_t> > queues_;
+   std::vector< std::thread > workers_;
+   std::mutex mutex_;
+   std::condition_variable condition_;
+   std::atomic<size_t> pending_;
+   std::atomic<size_t> lane_pending_[kTaskPriorityCount];
+   std::atomic<size_t> sleeping_;
+   std::atomic<size_t> next_;
+   std::atomic<uint64_t> steals_;
+   std::atomic<bool> stop_;
+
+};
+
+template <class F, class... Args>
+auto WorkPool::enqueue(F&& f, Args&&... args)
+-> std::future<typename std::result_of<F(Args...)>::type> {
+  using return_type = typename std::result_of<F(Args...)>::type;
+  auto task = std::make_shared< std::packaged_task<return_type()> >(
+      std::bind(std::forward<F>(f), std::forward<Args>(args)...)
+    );
+  std::future<return_type> res = task->get_future();
+  if (stop_) throw std::runtime_error("enqueue on stopped WorkPool");
+  push(Task([task](){ (*task)(); }), kTaskPriorityNormal);
+  return res;
+}
+
+template <class Iterator>
+void WorkPool::enqueue_bulk(Iterator first,
+                            Iterator last,
+                            task_priority_t priority) {
+  std::vector<Task> tasks;
+  for (; first != last; ++first) tasks.emplace_back(Task(*first));
+  push_bulk(tasks, priority);
+}
+
+template <class F>
+void WorkPool::parallel_for(size_t begin, size_t end, F &&f, size_t grain) {
+  if (end <= begin) return;
+  auto count = end - begin;
+  if (0 == grain) {
+    grain = count / ((workers_.size() + 1) * 4);
+    if (0 == grain) grain = 1;
+  }
+  auto chunks = (count + grain - 1) / grain;
+  std::atomic<size_t> remaining{chunks};
+  std::exception_ptr error{nullptr};
+  std::mutex error_mutex;
+  //The chunks reference the locals, so they must finish even if f throws.
+  auto chunk = [&f, &remaining, &error, &error_mutex](size_t from, size_t to) {
+    try {
+      for (size_t i = from; i < to; ++i) f(i);
+    } catch (...) {
+      std::unique_lock<std::mutex> lock(error_mutex);
+      if (!error) error = std::current_exception();
+    }
+    --remaining;
+  };
+  std::vector<Task> tasks;
+  tasks.reserve(chunks - 1);
+  for (size_t i = 1; i < chunks; ++i) {
+    auto from = begin + i * grain;
+    auto to = from + grain > end ? end : from + grain;
+    tasks.emplace_back(Task([chunk, from, to]() { chunk(from, to); }));
+  }
+  push_bulk(tasks, kTaskPriorityHigh);
+  chunk(begin, begin + grain > end ? end : begin + grain);
+  while (remaining > 0) {
+    if (!run_one()) std::this_thread::yield();
+  }
+  if (error) std::rethrow_exception(error);
+}
+
+} //namespace pf_sys
+
+#endif //PF_SYS_WORK_POOL_H_
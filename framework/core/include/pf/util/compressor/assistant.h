@@ -13,12 +13,45 @@
 
 #include "pf/util/compressor/config.h"
 
+//The adaptive policy defaults, the frame min tuned in [MIN, MAX].
+#define UTIL_COMPRESSOR_ASSISTANT_FRAME_MIN (128)
+#define UTIL_COMPRESSOR_ASSISTANT_FRAME_MAX (64 * 1024)
+#define UTIL_COMPRESSOR_ASSISTANT_RATIO_MAX (0.9) //Worse than it is useless.
+#define UTIL_COMPRESSOR_ASSISTANT_COST_MAX (20.0) //ns per saved byte.
+#define UTIL_COMPRESSOR_ASSISTANT_PROBE_MIN (16) //Frames skip when off.
+#define UTIL_COMPRESSOR_ASSISTANT_PROBE_MAX (4096)
+
 namespace pf_util {
 
 namespace compressor {
 
 class PF_API Assistant {
 
+ public:
+   typedef struct stat_struct {
+     uint64_t frames;            //Try to compress.
+     uint64_t success;           //Smaller than the input.
+     uint64_t skipped;           //Skipped by the policy.
+     uint64_t probes;            //Tried when the compression is off.
+     uint64_t bytes_in;
+     uint64_t bytes_out;
+     double ratio;               //Rolling out/in.
+     double cpu_per_byte;        //Rolling nanoseconds per input byte.
+     uint32_t frame_min;
+     bool active;                //Compress is on by the policy.
+     stat_struct() :
+       frames{0},
+       success{0},
+       skipped{0},
+       probes{0},
+       bytes_in{0},
+       bytes_out{0},
+       ratio{0.0},
+       cpu_per_byte{0.0},
+       frame_min{0},
+       active{false} {}
+   } stat_t;
+
  public:
    Assistant();
    ~Assistant();
@@ -30,19 +63,52 @@ class PF_API Assistant {
    void enable(bool enable, uint64_t threadid = 0);
    bool log_isenable() const { return log_isenable_; };
    void log_enable(bool _enable) { log_isenable_ = _enable; };
-   void compressframe_inc() { ++compressframe_success_; };
+   void compressframe_inc() { ++compressframe_; };
    uint32_t get_compressframe() const { return compressframe_; };
    void compressframe_successinc() { ++compressframe_success_; };
    uint32_t get_success_compressframe() const { 
      return compressframe_success_; 
    };
 
+ public:
+   //The adaptive policy: the rolling ratio and cpu cost of the stream decide
+   //the compression on or off and the frame min size, when it is off still
+   //probe one frame after some skipped frames(the interval doubles).
+   void adaptive_enable(bool enable) { adaptive_ = enable; };
+   bool adaptive_isenable() const { return adaptive_; };
+   void set_frame_min(uint32_t size) { frame_min_ = size; };
+   uint32_t get_frame_min() const { return frame_min_; };
+   void set_ratio_max(double ratio) { ratio_max_ = ratio; };
+   void set_cost_max(double nanoseconds) { cost_max_ = nanoseconds; };
+   bool should_compress(uint32_t insize);
+   void feedback(uint32_t insize, uint32_t outsize, uint64_t nanoseconds);
+   stat_t get_stat() const;
+   void reset(); //Reset the policy and the stat, not the setting.
+
+ private:
+   bool worth() const;
+   void tune_frame_min(uint32_t insize, bool good);
+
  private:
    void *workmemory_;
    bool isenable_;
    bool log_isenable_;
    uint32_t compressframe_;
    uint32_t compressframe_success_;
+   bool adaptive_;
+   bool active_;
+   uint32_t frame_min_;
+   double ratio_max_;
+   double cost_max_;
+   double ratio_;
+   double cpu_per_byte_;
+   uint32_t probe_interval_;
+   uint32_t probe_countdown_;
+   int32_t small_score_; //The small frames result, + good and - bad.
+   uint64_t skipped_;
+   uint64_t probes_;
+   uint64_t bytes_in_;
+   uint64_t bytes_out_;
 
 };
 
@@ -0,0 +1,83 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id codec.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2026/10/19 14:32
+ * @uses The compress codec interface, the net stream compressor use it.
+ *       The codec is stateless and shared, the state of one stream(like the
+ *       dictionary of a connection) keep in the context.
+ */
+#ifndef PF_UTIL_COMPRESSOR_CODEC_H_
+#define PF_UTIL_COMPRESSOR_CODEC_H_
+
+#include "pf/util/compressor/config.h"
+
+#define UTIL_COMPRESSOR_CODEC_MAX 32 //The id must less than it(mask bits).
+
+namespace pf_util {
+
+namespace compressor {
+
+typedef enum {
+  kCodecNone = 0,
+  kCodecLzo = 1,            //minilzo, the default.
+  kCodecLz4 = 2,            //lz4 block, stateless.
+  kCodecLz4Stream = 3,      //lz4 block with the connection dictionary.
+} codec_t;
+
+class PF_API CodecContext {
+
+ public:
+   virtual ~CodecContext() {}
+
+};
+
+class PF_API Codec {
+
+ public:
+   virtual ~Codec() {}
+
+ public:
+   virtual uint8_t id() const = 0;
+   virtual const char *name() const = 0;
+   virtual uint32_t bound(uint32_t insize) const = 0;
+
+   //The context of one stream, nullptr if the codec is stateless.
+   virtual CodecContext *create_context(uint32_t) const { return nullptr; }
+
+   //The outsize is the out capacity when call, and the result size when
+   //return. Failed if the result not smaller than input.
+   virtual bool compress(CodecContext *context,
+                         const unsigned char *in,
+                         uint32_t insize,
+                         unsigned char *out,
+                         uint32_t &outsize) const = 0;
+   virtual bool decompress(CodecContext *context,
+                           const unsigned char *in,
+                           uint32_t insize,
+                           unsigned char *out,
+                           uint32_t &outsize) const = 0;
+
+};
+
+namespace codec {
+
+//The built in codecs are registered at first get, the custom codec can be
+//add before the connections created.
+PF_API void add(Codec *codec);
+PF_API Codec *get(uint8_t id);
+PF_API uint32_t mask(); //All the supported codecs as bits.
+
+//Get the best codec both sides supported, kCodecNone if no one.
+PF_API uint8_t negotiate(uint32_t local_mask, uint32_t remote_mask);
+
+} //namespace codec
+
+} //namespace compressor
+
+} //namespace pf_util
+
+#endif //PF_UTIL_COMPRESSOR_CODEC_H_
@@ -0,0 +1,82 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id lz4.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2026/10/19 14:10
+ * @uses The lz4 block format compressor(https://github.com/lz4/lz4),
+ *       the output can be decoded by the lz4 library and the reverse.
+ *       The stream keep the last window bytes as the dictionary, so the
+ *       small frames of one connection can reference the before frames.
+ *       cn:
+ *       流模式下两端必须按相同顺序处理帧，未提交的帧不能进入字典。
+ */
+#ifndef PF_UTIL_COMPRESSOR_LZ4_H_
+#define PF_UTIL_COMPRESSOR_LZ4_H_
+
+#include "pf/util/compressor/config.h"
+
+#define UTIL_COMPRESSOR_LZ4_HASHLOG 12
+#define UTIL_COMPRESSOR_LZ4_HASH_SIZE (1 << UTIL_COMPRESSOR_LZ4_HASHLOG)
+#define UTIL_COMPRESSOR_LZ4_WINDOW (64 * 1024) //The max match distance.
+#define UTIL_COMPRESSOR_LZ4_GET_OUTLENGTH(in) ((in) + (in) / 255 + 16)
+
+namespace pf_util {
+
+namespace compressor {
+
+namespace lz4 {
+
+//Return the compressed size, 0 is failed(the out not enough).
+PF_API uint32_t compress(const unsigned char *in,
+                         uint32_t insize,
+                         unsigned char *out,
+                         uint32_t outcapacity);
+
+//Return the decompressed size, -1 is failed(the input is corrupt).
+PF_API int32_t decompress(const unsigned char *in,
+                          uint32_t insize,
+                          unsigned char *out,
+                          uint32_t outcapacity);
+
+class PF_API Stream {
+
+ public:
+   explicit Stream(uint32_t frame_max);
+   ~Stream();
+
+ public:
+   void reset();
+   uint32_t get_frame_max() const { return frame_max_; }
+
+   //The compressed frame will not be the dictionary until commit.
+   uint32_t compress(const unsigned char *in,
+                     uint32_t insize,
+                     unsigned char *out,
+                     uint32_t outcapacity);
+   void commit(uint32_t insize);
+   int32_t decompress(const unsigned char *in,
+                      uint32_t insize,
+                      unsigned char *out,
+                      uint32_t outcapacity);
+
+ private:
+   void slide();
+
+ private:
+   uint32_t frame_max_;
+   std::vector<unsigned char> buffer_; //window * 2 + frame
+   std::vector<uint32_t> table_;
+   uint32_t position_;
+
+};
+
+} //namespace lz4
+
+} //namespace compressor
+
+} //namespace pf_util
+
+#endif //PF_UTIL_COMPRESSOR_LZ4_H_
@@ -30,9 +30,10 @@
 #define OS_UNIX !(OS_WIN)
 #endif
 
-#define UTIL_COMPRESSOR_MINI_MANAGER_THREAD_SIZEMAX 1024
 #define UTIL_COMPRESSOR_MINI_MANAGER_WORK_MEMORY_SIZE \
   ((LZO1X_1_MEM_COMPRESS + sizeof(lzo_align_t) - 1) / sizeof(lzo_align_t))
+//The statistics shards, threads hash into them to avoid one hot cache line.
+#define UTIL_COMPRESSOR_MINI_MANAGER_STAT_SHARDS 64
 
 namespace pf_util {
 
@@ -48,55 +49,67 @@ class PF_API MiniManager : public pf_basic::Singleton<MiniManager> {
    static MiniManager &getsingleton();
 
  public:
-   typedef struct workmemory_struct {
-     void *pointer;
-     uint64_t threadid;
-   } workmemory_t;
+   typedef struct stat_struct {
+     uint64_t compress_size;
+     uint64_t uncompress_size;
+     uint64_t compress_count;
+     stat_struct() : compress_size{0}, uncompress_size{0}, compress_count{0} {}
+   } stat_t;
 
  public:
    bool init();
    void destory();
-   void *alloc(uint64_t threadid);
+   //The work memory of the current thread, threadid is not used any more.
+   static void *alloc(uint64_t threadid = 0);
    bool compress(const unsigned char *in,
                  uint32_t insize,
                  unsigned char *out,
                  uint32_t &outsize,
-                 void *workmemory);
+                 void *workmemory = nullptr);
    int32_t decompress(const unsigned char *in,
                       uint32_t insize,
                       unsigned char *out,
                       uint32_t &outsize);
    void add_uncompress_datasize(uint64_t size) {
-     std::unique_lock<std::mutex> autolock(mutex_);
-     uncompress_size_ += size;
+     getshard().uncompress_size.fetch_add(size, std::memory_order_relaxed);
    };
    void add_compress_datasize(uint64_t size) {
-     std::unique_lock<std::mutex> autolock(mutex_);
-     compress_size_ += size;
+     stat_shard_t &shard = getshard();
+     shard.compress_size.fetch_add(size, std::memory_order_relaxed);
+     shard.compress_count.fetch_add(1, std::memory_order_relaxed);
    };
-   uint64_t get_uncompress_datasize() { 
-     std::unique_lock<std::mutex> autolock(mutex_);
-     return uncompress_size_; 
+   uint64_t get_uncompress_datasize() const { 
+     return snapshot().uncompress_size; 
    };
-   uint64_t get_compress_datasize() { 
-     std::unique_lock<std::mutex> autolock(mutex_);
-     return workmemory_size_; 
+   uint64_t get_compress_datasize() const { 
+     return snapshot().compress_size; 
    };
+   //The totals of all threads, not a atomic view but each value is exact.
+   stat_t snapshot() const;
    void log_enable(bool enable) {
-     std::unique_lock<std::mutex> autolock(mutex_);
-     log_isenable_ = enable;
+     log_isenable_.store(enable, std::memory_order_relaxed);
    };
    bool log_isenable() const { 
-     return log_isenable_; 
+     return log_isenable_.load(std::memory_order_relaxed); 
    };
 
  private:
-   bool log_isenable_;
-   workmemory_t workmemory_[UTIL_COMPRESSOR_MINI_MANAGER_THREAD_SIZEMAX];
-   uint32_t workmemory_size_;
-   uint64_t uncompress_size_;
-   uint64_t compress_size_;
-   std::mutex mutex_;
+   typedef struct stat_shard_struct {
+     std::atomic<uint64_t> compress_size;
+     std::atomic<uint64_t> uncompress_size;
+     std::atomic<uint64_t> compress_count;
+     char padding[64 - sizeof(std::atomic<uint64_t>) * 3]; //One cache line.
+     stat_shard_struct() 
+       : compress_size{0}, uncompress_size{0}, compress_count{0} {}
+   } stat_shard_t;
+
+ private:
+   stat_shard_t &getshard();
+
+ private:
+   std::atomic<bool> log_isenable_;
+   stat_shard_t stat_shards_[UTIL_COMPRESSOR_MINI_MANAGER_STAT_SHARDS];
+   std::atomic<uint32_t> shard_index_;
 
 };
 
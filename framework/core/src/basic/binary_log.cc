@@ -0,0 +1,411 @@
+#include <unordered_map>
+#include "pf/basic/clock.h"
+#include "pf/basic/time_manager.h"
+#include "pf/sys/thread.h"
+#include "pf/basic/binary_log.h"
+
+namespace pf_basic {
+
+namespace binary_log {
+
+namespace {
+
+//The formats are copied and never freed, the readers not lock.
+std::atomic<const char *> g_formats[kFormatMax + 1];
+std::atomic<uint32_t> g_format_count{0};
+std::mutex g_format_mutex;
+
+std::unordered_map<std::string, uint32_t> &format_ids() {
+  static auto result = new std::unordered_map<std::string, uint32_t>;
+  return *result;
+}
+
+uint32_t register_format(const char *format) {
+  std::unique_lock<std::mutex> lock(g_format_mutex);
+  auto &ids = format_ids();
+  auto it = ids.find(format);
+  if (it != ids.end()) return it->second;
+  auto id = g_format_count.load(std::memory_order_relaxed) + 1;
+  if (id > kFormatMax) return 0;
+  auto length = strlen(format);
+  auto copy = new char[length + 1];
+  memcpy(copy, format, length + 1);
+  g_formats[id].store(copy, std::memory_order_release);
+  g_format_count.store(id, std::memory_order_release);
+  ids[format] = id;
+  return id;
+}
+
+typedef struct arg_struct {
+  uint8_t tag;
+  int64_t i;
+  uint64_t u;
+  double d;
+  const char *s;          //Not terminated, in the record.
+  uint16_t length;
+  arg_struct() : tag{0}, i{0}, u{0}, d{0.0}, s{nullptr}, length{0} {}
+} arg_t;
+
+class Reader {
+
+ public:
+   Reader(const char *data, size_t size) :
+     data_{data}, size_{size}, position_{0} {}
+
+ public:
+   //Read the next argument, false if no more.
+   bool next(arg_t &arg) {
+     if (position_ >= size_) return false;
+     arg.tag = static_cast<uint8_t>(data_[position_++]);
+     switch (arg.tag) {
+       case kArgString:
+         if (!read(&arg.length, sizeof(arg.length)) ||
+             position_ + arg.length > size_) return false;
+         arg.s = data_ + position_;
+         position_ += arg.length;
+         return true;
+       case kArgInt:
+         return read(&arg.i, sizeof(arg.i));
+       case kArgUint:
+       case kArgPointer:
+         return read(&arg.u, sizeof(arg.u));
+       case kArgDouble:
+         return read(&arg.d, sizeof(arg.d));
+       default:
+         return false;
+     }
+   }
+
+ private:
+   bool read(void *value, size_t size) {
+     if (position_ + size > size_) return false;
+     memcpy(value, data_ + position_, size);
+     position_ += size;
+     return true;
+   }
+
+ private:
+   const char *data_;
+   size_t size_;
+   size_t position_;
+
+};
+
+int64_t as_int(const arg_t &arg) {
+  switch (arg.tag) {
+    case kArgInt: return arg.i;
+    case kArgDouble: return static_cast<int64_t>(arg.d);
+    case kArgString:
+      return strtoll(std::string(arg.s, arg.length).c_str(), nullptr, 10);
+    default: return static_cast<int64_t>(arg.u);
+  }
+}
+
+double as_double(const arg_t &arg) {
+  switch (arg.tag) {
+    case kArgInt: return static_cast<double>(arg.i);
+    case kArgDouble: return arg.d;
+    case kArgString: return atof(std::string(arg.s, arg.length).c_str());
+    default: return static_cast<double>(arg.u);
+  }
+}
+
+std::string as_string(const arg_t &arg) {
+  switch (arg.tag) {
+    case kArgInt: return std::to_string(arg.i);
+    case kArgDouble: return std::to_string(arg.d);
+    case kArgString: return std::string(arg.s, arg.length);
+    default: return std::to_string(arg.u);
+  }
+}
+
+//The integer cut to the bytes and extended back as the printf reads it.
+uint64_t narrow_unsigned(int64_t value, size_t bytes) {
+  auto result = static_cast<uint64_t>(value);
+  if (bytes >= sizeof(result)) return result;
+  return result & ((1ULL << (bytes * 8)) - 1);
+}
+
+int64_t narrow_signed(int64_t value, size_t bytes) {
+  auto result = narrow_unsigned(value, bytes);
+  if (bytes >= sizeof(result)) return value;
+  auto sign = 1ULL << (bytes * 8 - 1);
+  return static_cast<int64_t>(result ^ sign) - static_cast<int64_t>(sign);
+}
+
+//The bytes of the integer conversion with the length modifier.
+size_t modifier_bytes(const char *modifier) {
+  switch (modifier[0]) {
+    case 'h': return 'h' == modifier[1] ? sizeof(char) : sizeof(short);
+    case 'l': return 'l' == modifier[1] ? sizeof(long long) : sizeof(long);
+    case 'q': return sizeof(long long);
+    case 'j': return sizeof(intmax_t);
+    case 'z': return sizeof(size_t);
+    case 't': return sizeof(ptrdiff_t);
+    default: return sizeof(int);
+  }
+}
+
+//The local time string of the last seconds.
+typedef struct timestr_struct {
+  int64_t seconds;
+  char time[16];
+  timestr_struct() : seconds{-1}, time{0} {}
+} timestr_t;
+
+//The "HH:MM:SS (thread runtime) " as Logger::get_log_timestr.
+void render_prefix(const header_t &header,
+                   timestr_t &timestr,
+                   std::string &text) {
+  if (header.seconds != timestr.seconds) {
+    time_t seconds = static_cast<time_t>(header.seconds);
+    tm local;
+#if OS_WIN
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    strftime(timestr.time, sizeof(timestr.time), "%H:%M:%S", &local);
+    timestr.seconds = header.seconds;
+  }
+  char prefix[128]{0};
+  auto length = snprintf(prefix,
+                         sizeof(prefix),
+                         "%s (%" PRIu64 " %.4f) ",
+                         timestr.time,
+                         header.thread,
+                         static_cast<float>(header.runtime) / 1000);
+  if (length > 0) text.append(prefix, length);
+}
+
+} //namespace
+
+uint32_t format_id(const char *format) {
+  if (is_null(format)) return 0;
+  //The formats are the literals almost, cache the pointers in the thread and
+  //compare the content for the reused buffers.
+  static thread_local std::unordered_map<const char *, uint32_t> cache;
+  auto it = cache.find(format);
+  if (it != cache.end()) {
+    auto registered = g_formats[it->second].load(std::memory_order_acquire);
+    if (0 == strcmp(registered, format)) return it->second;
+  }
+  auto id = register_format(format);
+  if (id != 0) cache[format] = id;
+  return id;
+}
+
+const char *format(uint32_t id) {
+  if (0 == id || id > g_format_count.load(std::memory_order_acquire))
+    return nullptr;
+  return g_formats[id].load(std::memory_order_acquire);
+}
+
+void header(header_t &header, uint8_t type, uint32_t format) {
+  static thread_local uint64_t thread{
+    strtoull(pf_sys::thread::get_id().c_str(), nullptr, 10)};
+  header.size = 0;
+  header.type = type;
+  header.count = 0;
+  header.format = format;
+  header.seconds = Clock::wall_seconds();
+  header.thread = thread;
+  header.runtime = TIME_MANAGER_POINTER ?
+    TIME_MANAGER_POINTER->get_run_time() : 0;
+}
+
+void render(const char *format,
+            const char *args,
+            size_t size,
+            std::string &text) {
+  Reader reader(args, size);
+  char buffer[kStringMax + 128]{0};
+  char spec[64]{0};
+  const char *p = format;
+  while (*p != '\0') {
+    if (*p != '%') {
+      auto next = strchr(p, '%');
+      if (is_null(next)) {
+        text.append(p);
+        break;
+      }
+      text.append(p, next - p);
+      p = next;
+      continue;
+    }
+    if ('%' == p[1]) {
+      text += '%';
+      p += 2;
+      continue;
+    }
+    //The flags, width and precision are kept, the integers are narrowed to
+    //the length modifier(int without it) and printed as 64 bits, the same
+    //text as the printf of the arguments.
+    const char *start = p++;
+    size_t length{0};
+    spec[length++] = '%';
+    auto keep = [&spec, &length](char c) {
+      if (length < sizeof(spec) - 4) spec[length++] = c;
+    };
+    while (*p != '\0' && strchr("-+ #0", *p)) keep(*p++);
+    for (int32_t i = 0; i < 2; ++i) { //The width and the precision.
+      if (1 == i) {
+        if (*p != '.') break;
+        keep(*p++);
+      }
+      if ('*' == *p) {
+        arg_t arg;
+        if (reader.next(arg)) {
+          auto value = std::to_string(as_int(arg));
+          for (auto c : value) keep(c);
+        }
+        ++p;
+      }
+      while (*p >= '0' && *p <= '9') keep(*p++);
+    }
+    auto bytes = modifier_bytes(p);
+    while (*p != '\0' && strchr("hlLqjzt", *p)) ++p;
+    char conversion = *p;
+    if ('\0' == conversion) {
+      text.append(start);
+      break;
+    }
+    ++p;
+    arg_t arg;
+    if (!reader.next(arg)) {
+      text.append(start, p - start);
+      continue;
+    }
+    int32_t result{0};
+    switch (conversion) {
+      case 'n': //Not write back.
+        break;
+      case 'd':
+      case 'i':
+        spec[length++] = 'l';
+        spec[length++] = 'l';
+        spec[length++] = 'd';
+        spec[length] = '\0';
+        result = snprintf(buffer, sizeof(buffer), spec,
+                          static_cast<long long>(
+                            narrow_signed(as_int(arg), bytes)));
+        break;
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+        spec[length++] = 'l';
+        spec[length++] = 'l';
+        spec[length++] = conversion;
+        spec[length] = '\0';
+        result = snprintf(buffer, sizeof(buffer), spec,
+                          static_cast<unsigned long long>(
+                            narrow_unsigned(as_int(arg), bytes)));
+        break;
+      case 'c':
+        spec[length++] = conversion;
+        spec[length] = '\0';
+        result = snprintf(buffer, sizeof(buffer), spec,
+                          static_cast<int>(as_int(arg)));
+        break;
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'F':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        spec[length++] = conversion;
+        spec[length] = '\0';
+        result = snprintf(buffer, sizeof(buffer), spec, as_double(arg));
+        break;
+      case 'p':
+        spec[length++] = conversion;
+        spec[length] = '\0';
+        result = snprintf(buffer, sizeof(buffer), spec,
+                          reinterpret_cast<void *>(
+                            static_cast<uintptr_t>(as_int(arg))));
+        break;
+      default: //The 's' and the unknowns.
+        if (kArgString == arg.tag && 1 == length) { //The plain "%s".
+          text.append(arg.s, arg.length);
+          break;
+        }
+        spec[length++] = 's';
+        spec[length] = '\0';
+        result = snprintf(buffer, sizeof(buffer), spec, as_string(arg).c_str());
+        break;
+    }
+    if (result > 0) {
+      size_t count = static_cast<size_t>(result);
+      text.append(buffer, count < sizeof(buffer) ? count : sizeof(buffer) - 1);
+    }
+  }
+}
+
+size_t decode(const char *data,
+              size_t size,
+              std::string &text,
+              std::map<uint32_t, std::string> *formats) {
+  size_t position{0};
+  timestr_t timestr;
+  while (position + sizeof(header_t) <= size) {
+    header_t record;
+    memcpy(&record, data + position, sizeof(record));
+    if (record.size < sizeof(header_t) || position + record.size > size)
+      break;
+    auto args = data + position + sizeof(header_t);
+    auto args_size = record.size - sizeof(header_t);
+    position += record.size;
+    if (kFormatRecord == record.type) {
+      if (formats) (*formats)[record.format].assign(args, args_size);
+      continue;
+    }
+    const char *format_string{nullptr};
+    if (formats) {
+      auto it = formats->find(record.format);
+      if (it != formats->end()) format_string = it->second.c_str();
+    } else {
+      format_string = format(record.format);
+    }
+    render_prefix(record, timestr, text);
+    if (is_null(format_string)) {
+      text += "(unknown format " + std::to_string(record.format) + ")";
+    } else {
+      render(format_string, args, args_size, text);
+    }
+    text += LF;
+  }
+  return position;
+}
+
+void define_formats(const char *data,
+                    size_t size,
+                    std::set<uint32_t> &written,
+                    std::string &out) {
+  size_t position{0};
+  while (position + sizeof(header_t) <= size) {
+    header_t record;
+    memcpy(&record, data + position, sizeof(record));
+    if (record.size < sizeof(header_t) || position + record.size > size)
+      break;
+    position += record.size;
+    if (kFormatRecord == record.type || written.count(record.format) > 0)
+      continue;
+    auto format_string = format(record.format);
+    if (is_null(format_string)) continue;
+    written.insert(record.format);
+    auto length = strlen(format_string);
+    if (length > 0xffff - sizeof(header_t)) length = 0xffff - sizeof(header_t);
+    header_t define;
+    header(define, kFormatRecord, record.format);
+    define.size = static_cast<uint16_t>(sizeof(header_t) + length);
+    out.append(reinterpret_cast<const char *>(&define), sizeof(define));
+    out.append(format_string, length);
+  }
+}
+
+} //namespace binary_log
+
+} //namespace pf_basic
@@ -0,0 +1,127 @@
+#include "pf/basic/clock.h"
+
+namespace pf_basic {
+
+namespace {
+
+typedef struct cache_struct {
+  int64_t seconds;
+  tm local;
+  char time[16];
+  char date_time[32];
+} cache_t;
+
+cache_t g_cache;
+std::atomic<uint32_t> g_sequence{0}; //Odd when the writer in progress.
+std::atomic<int64_t> g_seconds{-1};
+std::atomic<bool> g_refreshing{false};
+
+int64_t realtime_seconds() {
+#if OS_UNIX && defined(CLOCK_REALTIME_COARSE)
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME_COARSE, &now);
+  return static_cast<int64_t>(now.tv_sec);
+#else
+  return static_cast<int64_t>(time(nullptr));
+#endif
+}
+
+void refresh(int64_t seconds) {
+  if (g_refreshing.exchange(true, std::memory_order_acquire)) return;
+  if (g_seconds.load(std::memory_order_relaxed) != seconds) {
+    time_t now = static_cast<time_t>(seconds);
+    tm local;
+#if OS_WIN
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    g_sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    g_cache.seconds = seconds;
+    g_cache.local = local;
+    strftime(g_cache.time, sizeof(g_cache.time), "%H:%M:%S", &local);
+    strftime(g_cache.date_time,
+             sizeof(g_cache.date_time),
+             "%Y-%m-%d %H:%M:%S",
+             &local);
+    g_sequence.fetch_add(1, std::memory_order_release);
+    g_seconds.store(seconds, std::memory_order_release);
+  }
+  g_refreshing.store(false, std::memory_order_release);
+}
+
+void read(cache_t &result) {
+  auto seconds = realtime_seconds();
+  if (seconds != g_seconds.load(std::memory_order_acquire)) refresh(seconds);
+  for (;;) {
+    auto sequence = g_sequence.load(std::memory_order_acquire);
+    if (sequence & 1) {
+      std::this_thread::yield();
+      continue;
+    }
+    memcpy(&result, &g_cache, sizeof(result));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (g_sequence.load(std::memory_order_relaxed) == sequence) break;
+  }
+}
+
+const uint64_t g_start_ms = Clock::now_ms();
+
+} //namespace
+
+uint64_t Clock::now_ms() {
+#if OS_UNIX && defined(CLOCK_MONOTONIC_COARSE)
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+#else
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+uint64_t Clock::now_us() {
+#if OS_UNIX
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+#else
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+uint64_t Clock::uptime_ms() {
+  return now_ms() - g_start_ms;
+}
+
+int64_t Clock::wall_seconds() {
+  auto seconds = realtime_seconds();
+  if (seconds != g_seconds.load(std::memory_order_acquire)) refresh(seconds);
+  return seconds;
+}
+
+void Clock::local_tm(tm &result) {
+  cache_t cache;
+  read(cache);
+  result = cache.local;
+}
+
+void Clock::format_time(char *buffer, size_t size) {
+  if (0 == size) return;
+  cache_t cache;
+  read(cache);
+  snprintf(buffer, size, "%s", cache.time);
+}
+
+void Clock::format_date_time(char *buffer, size_t size) {
+  if (0 == size) return;
+  cache_t cache;
+  read(cache);
+  snprintf(buffer, size, "%s", cache.date_time);
+}
+
+} //namespace pf_basic
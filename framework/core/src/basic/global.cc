@@ -19,14 +19,28 @@
  * GLOBALS["log.fast"] = bool;                    //default true.
  * GLOBALS["log.print"] = bool;                   //default true.
  * GLOBALS["log.clear"] = bool;                   //default false.
+ * GLOBALS["log.binary"] = bool;                  //default false.
+ * GLOBALS["log.binary_file"] = bool;             //default false.
  * GLOBALS["cache.gsinit"] = bool;                //default false.
  * GLOBALS["thread.collects"] = number;           //default 0.
  * GLOBALS["default.engine.frame"] = number;      //default 100.
+ * GLOBALS["default.engine.task_budget"] = number;//default 0(ms, 0 is a frame).
+ * GLOBALS["default.engine.frame_spin"] = number; //default 0(microseconds).
+ * GLOBALS["default.engine.metrics"] = number;    //default 0(seconds, 0 off).
+ * GLOBALS["default.engine.sampler"] = number;    //default 0(ms, 0 off).
+ * GLOBALS["default.engine.sampler_size"] = number; //default 60(samples).
+ * GLOBALS["default.engine.sampler_cpu"] = number;  //default 0(percent).
+ * GLOBALS["default.engine.sampler_rss"] = number;  //default 0(MB).
+ * GLOBALS["default.engine.sampler_fds"] = number;  //default 0.
+ * GLOBALS["default.engine.sampler_delay"] = number;//default 0(percent).
+ * GLOBALS["default.engine.sampler_steal"] = number;//default 0(percent).
  * GLOBALS["default.net.open"] = bool;            //default false.
  * GLOBALS["default.net.service"] = bool;         //default false.
  * GLOBALS["default.net.service_ip"] = string;    //default "".
  * GLOBALS["default.net.service_port"] = number;  //default 0.
  * GLOBALS["default.net.conn_max"] = number;      //default NET_CONNECTION_MAX.
+ * GLOBALS["default.net.profile"] = bool;         //default false.
+ * GLOBALS["default.net.profile_slow"] = number;  //default 0(microseconds).
  * GLOBALS["default.script.open"] = bool;         //default false.
  * GLOBALS["default.script.rootpath"] = string;   //default SCRIPT_ROOT_PATH.
  * GLOBALS["default.script.workpath"] = string;   //default SCRIPT_WORK_PATH.
@@ -42,11 +56,15 @@
  * GLOBALS["default.cache.query_map"] = number;   //default ID_INVALID.
  * GLOBALS["default.cache.clear"] = bool;         //default false.
  * GLOBALS["default.cache.workers"] = number;     //default CACHE_WORKERS_DEFAULT.
+ * GLOBALS["default.cache.snapshot"] = string;    //default "".
+ * GLOBALS["default.cache.snapshot_interval"] = number; //default 0(seconds).
  * GLOBALS["default.db.open"] = bool;             //default fasle.
  * GLOBALS["default.db.type"] = number;           //default -1.
  * GLOBALS["default.db.name"] = string;           //default "".
  * GLOBALS["default.db.user"] = string;           //default "".
  * GLOBALS["default.db.password"] = string;       //default "".
+ * GLOBALS["default.db.workers"] = number;        //default 0(query in net thread).
+ * GLOBALS["default.db.inflight"] = number;       //default CACHE_DB_INFLIGHT_DEFAULT.
  **/
 namespace pf_basic {
 
@@ -83,17 +101,31 @@ void set_default_globals(type::variable_set_t &g) {
   g["log.fast"] = true;
   g["log.print"] = true;
   g["log.clear"] = false;
+  g["log.binary"] = false;
+  g["log.binary_file"] = false;
 
   g["cache.gsinit"] = false;
 
   g["thread.collects"] = 0;
 
   g["default.engine.frame"] = 100;
+  g["default.engine.task_budget"] = 0;
+  g["default.engine.frame_spin"] = 0;
+  g["default.engine.metrics"] = 0;
+  g["default.engine.sampler"] = 0;
+  g["default.engine.sampler_size"] = 60;
+  g["default.engine.sampler_cpu"] = 0;
+  g["default.engine.sampler_rss"] = 0;
+  g["default.engine.sampler_fds"] = 0;
+  g["default.engine.sampler_delay"] = 0;
+  g["default.engine.sampler_steal"] = 0;
   g["default.net.open"] = false;
   g["default.net.service"] = false;
   g["default.net.service_ip"] = "";
   g["default.net.service_port"] = 0;
   g["default.net.conn_max"] = NET_CONNECTION_MAX;
+  g["default.net.profile"] = false;
+  g["default.net.profile_slow"] = 0;
   g["default.script.open"] = false;
   g["default.script.rootpath"] = SCRIPT_ROOT_PATH;
   g["default.script.workpath"] = SCRIPT_WORK_PATH;
@@ -107,11 +139,15 @@ void set_default_globals(type::variable_set_t &g) {
   g["default.cache.query_map"] = ID_INVALID;
   g["default.cache.clear"] = false;
   g["default.cache.workers"] = CACHE_WORKERS_DEFAULT;
+  g["default.cache.snapshot"] = "";
+  g["default.cache.snapshot_interval"] = 0;
   g["default.db.open"] = false;
   g["default.db.name"] = "";
   g["default.db.user"] = "";
   g["default.db.password"] = "";
   g["default.db.type"] = -1;
+  g["default.db.workers"] = 0;
+  g["default.db.inflight"] = CACHE_DB_INFLIGHT_DEFAULT;
 
   //The set flag.
   g["globals"] = true;
@@ -1,6 +1,8 @@
 #include "pf/basic/util.h"
+#include "pf/basic/clock.h"
 #include "pf/basic/time_manager.h"
 #include "pf/sys/thread.h"
+#include "pf/basic/metrics.h"
 #include "pf/basic/logger.h"
 
 std::unique_ptr< pf_basic::Logger > g_logger{nullptr};
@@ -20,15 +22,24 @@ Logger &Logger::getsingleton() {
   return *singleton_;
 }
 
-Logger::Logger() {
+Logger::Logger() : binary_stop_{false}, switches_time_{0}, switches_{0} {
   logids_.init(LOGTYPE_MAX);
   log_position_.init(LOGTYPE_MAX);
   logcache_.init(LOGTYPE_MAX);
   loglock_.init(LOGTYPE_MAX);
+  log_binary_.init(LOGTYPE_MAX);
   cache_size_ = 0;
 }
 
 Logger::~Logger() {
+  if (binary_thread_.joinable()) {
+    {
+      std::unique_lock<std::mutex> lock(binary_queue_mutex_);
+      binary_stop_ = true;
+    }
+    binary_condition_.notify_all();
+    binary_thread_.join();
+  }
   cache_size_ = 0;
   for (auto it = logcache_.begin(); it != logcache_.end(); ++it)
     safe_delete_array(it->second);
@@ -48,28 +59,29 @@ bool Logger::register_fastlog(const char *logname) {
   logcache_.add(logid, cache);
   auto mutex = new std::mutex;
   loglock_.add(logid, mutex);
+  log_binary_.add(logid, GLOBALS["log.binary"] == true ? 1 : 0);
   if (is_null(logcache_.get(logid))) return false;
   return true;
 }
 
 void Logger::get_log_timestr(char *time_str, int32_t length) {
+  static thread_local std::string thread_id{pf_sys::thread::get_id()};
   if (TIME_MANAGER_POINTER) {
-      TIME_MANAGER_POINTER->reset_time();
+      char clock[16]{0};
+      Clock::format_time(clock, sizeof(clock));
       auto runtime = TIME_MANAGER_POINTER->get_run_time();
       snprintf(
           time_str, 
           length, 
-          "%.2d:%.2d:%.2d (%s %.4f)",
-          TIME_MANAGER_POINTER->get_hour(),
-          TIME_MANAGER_POINTER->get_minute(),
-          TIME_MANAGER_POINTER->get_second(),
-          pf_sys::thread::get_id().c_str(),
+          "%s (%s %.4f)",
+          clock,
+          thread_id.c_str(),
           static_cast< float >(runtime) / 1000);
   } else {
     snprintf(time_str,
              length, 
              "00:00:00 (%s 0.0000)",
-             pf_sys::thread::get_id().c_str());
+             thread_id.c_str());
   }
 }
 
@@ -121,14 +133,16 @@ void Logger::get_log_filename(const char *filename_prefix,
            strlen(typestr) > 0 ? "_" : "",
            typestr);
   if (TIME_MANAGER_POINTER) {
+    tm local; //One snapshot, the day and hour not torn.
+    Clock::local_tm(local);
     char savedir[128] = {0};
     snprintf(savedir, 
              sizeof(savedir) - 1, 
              "%s/%.2d_%.2d_%.2d/%s", 
              GLOBALS["log.directory"].c_str(),
-             TIME_MANAGER_POINTER->get_year(), 
-             TIME_MANAGER_POINTER->get_month(),
-             TIME_MANAGER_POINTER->get_day(),
+             local.tm_year + 1900, 
+             local.tm_mon + 1,
+             local.tm_mday,
              GLOBALS["app.name"].c_str());
     if (!pf_basic::util::makedir(savedir, 0755))
       io_cerr("save dir: %s make failed", savedir);
@@ -137,7 +151,7 @@ void Logger::get_log_filename(const char *filename_prefix,
              "%s/%s_%.2d.log",
              savedir,
              prefixfinal,
-             TIME_MANAGER_POINTER->get_hour());
+             local.tm_hour);
   } else {
     snprintf(save,
              FILENAME_MAX - 1,
@@ -152,13 +166,18 @@ void Logger::get_log_filename(const char *filename_prefix,
 void Logger::flush_log(const char *logname) {
     uint8_t logid = static_cast<uint8_t>(logids_.get(logname));
     char *buffer = logcache_.get(logid);
-    uint32_t position = log_position_.get(logid);
     if (!loglock_.isfind(logid) || is_null(buffer)) return;
     char log_filename[FILENAME_MAX];
     memset(log_filename, '\0', sizeof(log_filename));
     get_log_filename(logname, log_filename);
     auto mutex = loglock_.get(logid);
+    if (1 == log_binary_.get(logid)) {
+      flush_binarylog(logid, logname);
+      return;
+    }
     std::unique_lock<std::mutex> autolock(*mutex);
+    uint32_t position = log_position_.get(logid);
+    if (0 == position) return;
     try {
       FILE* fp;
       fp = fopen(log_filename, "ab");
@@ -169,6 +188,162 @@ void Logger::flush_log(const char *logname) {
     } catch(...) {
       //do nothing
     }
+    log_position_.set(logid, 0); //The cache saved, write from the start.
+}
+
+void Logger::flush_binarylog(uint8_t logid, const char *logname) {
+  std::unique_lock<std::mutex> binarylock(binary_mutex_);
+  std::vector<binary_data_t> queue;
+  {
+    std::unique_lock<std::mutex> lock(binary_queue_mutex_);
+    queue.swap(binary_queue_);
+    take_binarylog(logid, logname, queue);
+  }
+  for (auto &data : queue) write_binarylog(data);
+}
+
+void Logger::post_binarylog(uint8_t logid, const char *logname) {
+  {
+    std::unique_lock<std::mutex> lock(binary_queue_mutex_);
+    if (!binary_thread_.joinable())
+      binary_thread_ = std::thread([this]() { binary_writer(); });
+    take_binarylog(logid, logname, binary_queue_);
+  }
+  binary_condition_.notify_one();
+}
+
+void Logger::take_binarylog(uint8_t logid,
+                            const char *logname,
+                            std::vector<binary_data_t> &queue) {
+  auto mutex = loglock_.get(logid);
+  auto cache = logcache_.get(logid);
+  if (is_null(mutex) || is_null(cache)) return;
+  std::unique_lock<std::mutex> autolock(*mutex);
+  uint32_t position = log_position_.get(logid);
+  if (0 == position) return;
+  binary_data_t data;
+  data.logid = logid;
+  data.raw = GLOBALS["log.binary_file"] == true;
+  char log_filename[FILENAME_MAX]{0};
+  get_log_filename(logname, log_filename);
+  if (data.raw) { //The same name as the text log with the ".blog" extension.
+    auto extension = strrchr(log_filename, '.');
+    if (extension)
+      snprintf(extension,
+               sizeof(log_filename) - (extension - log_filename),
+               ".blog");
+  }
+  data.filename = log_filename;
+  data.data.assign(cache, position);
+  queue.emplace_back(std::move(data));
+  log_position_.set(logid, 0);
+}
+
+void Logger::write_binarylog(const binary_data_t &data) {
+  std::string out;
+  if (data.raw) { //The records with the formats not defined in the file.
+    auto &file = binary_files_[data.logid];
+    if (file.filename != data.filename) {
+      file.filename = data.filename;
+      file.formats.clear();
+    }
+    binary_log::define_formats(
+        data.data.data(), data.data.size(), file.formats, out);
+    out += data.data;
+  } else {
+    binary_log::decode(data.data.data(), data.data.size(), out);
+  }
+  FILE *fp = fopen(data.filename.c_str(), "ab");
+  if (fp) {
+    fwrite(out.data(), 1, out.size(), fp);
+    fclose(fp);
+  }
+}
+
+void Logger::binary_writer() {
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(binary_queue_mutex_);
+      binary_condition_.wait(
+          lock, [this]() { return binary_stop_ || !binary_queue_.empty(); });
+      if (binary_queue_.empty()) return; //Stopped.
+    }
+    //The binary lock first as the flush, the queue written in order.
+    std::unique_lock<std::mutex> binarylock(binary_mutex_);
+    std::vector<binary_data_t> queue;
+    {
+      std::unique_lock<std::mutex> lock(binary_queue_mutex_);
+      queue.swap(binary_queue_);
+    }
+    for (auto &data : queue) write_binarylog(data);
+  }
+}
+
+void Logger::save_fastlog(uint8_t logid,
+                          const char *logname,
+                          const char *data,
+                          int32_t length) {
+  auto cache = logcache_.get(logid);
+  auto mutex = loglock_.get(logid);
+  if (is_null(cache) || is_null(mutex)) return;
+  uint32_t position{0};
+  {
+    std::unique_lock<std::mutex> autolock(*mutex);
+    position = log_position_.get(logid); //The flush resets it.
+    if (length + position > kDefaultLogCacheSize) {
+      static auto &drops = metrics::counter("log.drops");
+      drops.add();
+      return;
+    }
+    memcpy(cache + position, data, length);
+    log_position_.set(logid, position + length);
+  }
+  if (position + length > (kDefaultLogCacheSize * 2) / 3) {
+    if (1 == log_binary_.get(logid)) {
+      post_binarylog(logid, logname);
+    } else {
+      flush_log(logname);
+    }
+  }
+}
+
+uint8_t Logger::get_switches() {
+  auto now = Clock::wall_seconds();
+  if (now != switches_time_.load(std::memory_order_relaxed)) {
+    uint8_t switches{0};
+    if (GLOBALS["log.fast"] == true) switches |= kLogSwitchFast;
+    if (GLOBALS["log.print"] == true) switches |= kLogSwitchPrint;
+    if (GLOBALS["log.active"] == true) switches |= kLogSwitchActive;
+    switches_ = switches;
+    switches_time_ = now;
+  }
+  return switches_;
+}
+
+void Logger::format_log(char *buffer, size_t size, const char *format, ...) {
+  va_list argptr;
+  va_start(argptr, format);
+  vsnprintf(buffer, size, format, argptr);
+  va_end(argptr);
+}
+
+void Logger::print_log(uint8_t type, const char *buffer) {
+  switch (type) {
+    case 1:
+      io_cwarn(buffer);
+      break;
+    case 2:
+      io_cerr(buffer);
+      break;
+    case 3:
+      io_cdebug(buffer);
+      break;
+    case 9:
+      break;
+    default:
+      printf("%s" LF "", buffer);
+      break;
+  }
 }
 
 void Logger::flush_alllog() {
@@ -0,0 +1,239 @@
+#include "pf/basic/logger.h"
+#include "pf/basic/metrics.h"
+
+namespace pf_basic {
+
+namespace metrics {
+
+namespace {
+
+typedef struct registry_struct {
+  std::mutex mutex;
+  std::map<std::string, std::unique_ptr<Counter>> counters;
+  std::map<std::string, std::unique_ptr<Gauge>> gauges;
+  std::map<std::string, std::unique_ptr<Histogram>> histograms;
+  std::map<std::string, std::unique_ptr<Family<Counter>>> counter_families;
+  std::map<std::string, std::unique_ptr<Family<Histogram>>>
+    histogram_families;
+} registry_t;
+
+//Not destroyed, the metrics can be used in the static destructors.
+registry_t &registry() {
+  static registry_t *result = new registry_t;
+  return *result;
+}
+
+template <typename T>
+T &find_or_create(std::map<std::string, std::unique_ptr<T>> &metrics,
+                  const std::string &name) {
+  std::unique_lock<std::mutex> lock(registry().mutex);
+  auto &metric = metrics[name];
+  if (!metric) metric.reset(new T);
+  return *metric;
+}
+
+std::atomic<size_t> g_next_shard{0};
+
+void histogram_line(std::string &result,
+                    const std::string &name,
+                    const histogram_snapshot_t &histogram) {
+  char line[256]{0};
+  snprintf(line,
+           sizeof(line) - 1,
+           "%s count=%" PRIu64 " sum=%" PRIu64 " p50=%" PRIu64
+           " p90=%" PRIu64 " p99=%" PRIu64 " max=%" PRIu64 "\n",
+           name.c_str(),
+           histogram.count,
+           histogram.sum,
+           histogram.percentile(0.5),
+           histogram.percentile(0.9),
+           histogram.percentile(0.99),
+           histogram.max);
+  result += line;
+}
+
+} //namespace
+
+size_t shard() {
+  thread_local size_t index = g_next_shard++ % METRICS_SHARDS;
+  return index;
+}
+
+Counter::Counter() {
+  for (auto &item : shards_) item.value = 0;
+}
+
+uint64_t Counter::value() const {
+  uint64_t result{0};
+  for (auto &item : shards_)
+    result += item.value.load(std::memory_order_relaxed);
+  return result;
+}
+
+Histogram::Histogram() : shards_{new shard_t[METRICS_SHARDS]} {
+  for (size_t i = 0; i < METRICS_SHARDS; ++i) {
+    auto &item = shards_[i];
+    item.count = 0;
+    item.sum = 0;
+    item.max = 0;
+    for (auto &bucket : item.buckets) bucket = 0;
+  }
+}
+
+size_t Histogram::bucket(uint64_t value) {
+  if (value < 8) return static_cast<size_t>(value);
+#if defined(__GNUC__)
+  size_t exponent = 63 - static_cast<size_t>(__builtin_clzll(value));
+#else
+  size_t exponent{0};
+  for (auto temp = value; temp > 1; temp >>= 1) ++exponent;
+#endif
+  if (exponent > 40) return METRICS_HISTOGRAM_BUCKETS - 1;
+  size_t sub = static_cast<size_t>((value >> (exponent - 2)) & 3);
+  auto result = 8 + (exponent - 3) * 4 + sub;
+  return result < METRICS_HISTOGRAM_BUCKETS ?
+    result : METRICS_HISTOGRAM_BUCKETS - 1;
+}
+
+uint64_t Histogram::bucket_upper(size_t index) {
+  if (index < 8) return index;
+  auto exponent = (index - 8) / 4 + 3;
+  auto sub = (index - 8) % 4;
+  return ((4 + sub + 1) << (exponent - 2)) - 1;
+}
+
+void Histogram::record(uint64_t value) {
+  auto &item = shards_[shard()];
+  item.count.fetch_add(1, std::memory_order_relaxed);
+  item.sum.fetch_add(value, std::memory_order_relaxed);
+  item.buckets[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+  auto max = item.max.load(std::memory_order_relaxed);
+  while (value > max &&
+         !item.max.compare_exchange_weak(max, value,
+                                         std::memory_order_relaxed)) {}
+}
+
+void Histogram::snapshot(histogram_snapshot_t &result) const {
+  result = histogram_snapshot_t();
+  for (size_t i = 0; i < METRICS_SHARDS; ++i) {
+    auto &item = shards_[i];
+    result.count += item.count.load(std::memory_order_relaxed);
+    result.sum += item.sum.load(std::memory_order_relaxed);
+    auto max = item.max.load(std::memory_order_relaxed);
+    if (max > result.max) result.max = max;
+    for (size_t j = 0; j < METRICS_HISTOGRAM_BUCKETS; ++j)
+      result.buckets[j] += item.buckets[j].load(std::memory_order_relaxed);
+  }
+}
+
+uint64_t histogram_snapshot_struct::percentile(double p) const {
+  uint64_t total{0};
+  for (auto bucket : buckets) total += bucket;
+  if (0 == total) return 0;
+  auto rank = static_cast<uint64_t>(p * total);
+  if (rank >= total) rank = total - 1;
+  uint64_t seen{0};
+  for (size_t i = 0; i < METRICS_HISTOGRAM_BUCKETS; ++i) {
+    seen += buckets[i];
+    if (seen > rank) {
+      auto upper = Histogram::bucket_upper(i);
+      return upper > max ? max : upper;
+    }
+  }
+  return max;
+}
+
+Counter &counter(const std::string &name) {
+  return find_or_create(registry().counters, name);
+}
+
+Gauge &gauge(const std::string &name) {
+  return find_or_create(registry().gauges, name);
+}
+
+Histogram &histogram(const std::string &name) {
+  return find_or_create(registry().histograms, name);
+}
+
+Family<Counter> &counter_family(const std::string &name) {
+  return find_or_create(registry().counter_families, name);
+}
+
+Family<Histogram> &histogram_family(const std::string &name) {
+  return find_or_create(registry().histogram_families, name);
+}
+
+void snapshot(std::vector<sample_t> &samples) {
+  auto &all = registry();
+  std::unique_lock<std::mutex> lock(all.mutex);
+  sample_t sample;
+  for (auto &it : all.counters) {
+    sample.name = it.first;
+    sample.type = kTypeCounter;
+    sample.value = static_cast<int64_t>(it.second->value());
+    samples.push_back(sample);
+  }
+  for (auto &it : all.gauges) {
+    sample.name = it.first;
+    sample.type = kTypeGauge;
+    sample.value = it.second->value();
+    samples.push_back(sample);
+  }
+  for (auto &it : all.histograms) {
+    sample.name = it.first;
+    sample.type = kTypeHistogram;
+    it.second->snapshot(sample.histogram);
+    samples.push_back(sample);
+  }
+  for (auto &it : all.counter_families) {
+    it.second->each([&it, &samples](uint16_t label, const Counter &metric) {
+      sample_t item;
+      item.name = it.first;
+      item.label = label;
+      item.type = kTypeCounter;
+      item.value = static_cast<int64_t>(metric.value());
+      samples.push_back(item);
+    });
+  }
+  for (auto &it : all.histogram_families) {
+    it.second->each([&it, &samples](uint16_t label, const Histogram &metric) {
+      sample_t item;
+      item.name = it.first;
+      item.label = label;
+      item.type = kTypeHistogram;
+      metric.snapshot(item.histogram);
+      samples.push_back(item);
+    });
+  }
+}
+
+std::string text() {
+  std::vector<sample_t> samples;
+  snapshot(samples);
+  std::string result;
+  for (const sample_t &sample : samples) {
+    std::string name{sample.name};
+    if (sample.label >= 0) name += "{" + std::to_string(sample.label) + "}";
+    if (kTypeHistogram == sample.type) {
+      histogram_line(result, name, sample.histogram);
+    } else {
+      result += name + " " + std::to_string(sample.value) + "\n";
+    }
+  }
+  return result;
+}
+
+void log(const char *logname) {
+  auto lines = text();
+  size_t start{0};
+  while (start < lines.size()) {
+    auto end = lines.find('\n', start);
+    if (std::string::npos == end) end = lines.size();
+    SLOW_LOG(logname, "%s", lines.substr(start, end - start).c_str());
+    start = end + 1;
+  }
+}
+
+} //namespace metrics
+
+} //namespace pf_basic
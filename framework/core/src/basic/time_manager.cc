@@ -1,4 +1,5 @@
 #include "pf/sys/assert.h"
+#include "pf/basic/clock.h"
 #include "pf/basic/time_manager.h"
 
 std::unique_ptr< pf_basic::TimeManager > g_time_manager{nullptr};
@@ -20,7 +21,9 @@ TimeManager &TimeManager::getsingleton() {
 
 TimeManager::TimeManager() :
   start_time_{0},
-  current_time_{0} {
+  current_time_{0},
+  start_ms_{0},
+  start_us_{0} {
 }
 
 TimeManager::~TimeManager() {
@@ -28,38 +31,37 @@ TimeManager::~TimeManager() {
 }
 
 bool TimeManager::init() {
-#if OS_WIN
-  start_time_ = GetTickCount();
-  current_time_ = GetTickCount();
-#elif OS_UNIX
   start_time_ = 0;
   current_time_ = 0;
+#if OS_UNIX
   gettimeofday(&start_, &time_zone_);
 #endif
+  start_ms_ = Clock::now_ms();
+  start_us_ = Clock::now_us();
   reset_time();
   g_file_name_fix = get_day_time();
   g_file_name_fix_last = get_tickcount();
   return true;
 }
 
+//No syscall and not write the members, safe in any thread.
 uint32_t TimeManager::get_tickcount() {
-#if OS_WIN
-  current_time_ = GetTickCount();
-#elif OS_UNIX
-  gettimeofday(&end_, &time_zone_);
-  double time1 = static_cast<double>(start_.tv_sec * 1000) +
-           static_cast<double>(start_.tv_usec / 1000);
-  double time2 = static_cast<double>(end_.tv_sec * 1000) +
-           static_cast<double>(end_.tv_usec / 1000);
-  current_time_ = static_cast<uint32_t>(time2 - time1);
-#endif
-  return current_time_;
+  return static_cast<uint32_t>(get_tickcount64());
+}
+
+uint64_t TimeManager::get_tickcount64() {
+  return Clock::now_ms() - start_ms_;
+}
+
+uint64_t TimeManager::get_tickcount_us() {
+  return Clock::now_us() - start_us_;
 }
 
 uint32_t TimeManager::get_current_time() {
-  reset_time();
+  tm local;
+  Clock::local_tm(local);
   uint32_t time;
-  tm_totime(&tm_, time);
+  tm_totime(&local, time);
   return time;
 }
 
@@ -68,28 +70,16 @@ uint32_t TimeManager::get_start_time() const {
 }
 
 uint32_t TimeManager::get_saved_time() const {
-  return current_time_;
+  return static_cast<uint32_t>(Clock::now_ms() - start_ms_);
 }
 
 void TimeManager::reset_time() {
-  time_t newtime;
-  if (time(&newtime) != static_cast<time_t>(-1)) {
-    set_time_ = newtime;
-  }
-#if OS_WIN
-  tm *newtm = localtime(&set_time_);
-  tm_ = *newtm;
-#elif OS_UNIX
-  tm newtm;
-  tm *_tm = localtime_r(&set_time_, &newtm);
-  if (_tm) tm_ = newtm;
-#endif
+  set_time_ = static_cast<time_t>(Clock::wall_seconds());
+  Clock::local_tm(tm_);
 }
 
 time_t TimeManager::get_ansi_time() {
-  reset_time();
-  return set_time_;
-  return set_time_;
+  return static_cast<time_t>(Clock::wall_seconds());
 }
 
 uint32_t TimeManager::get_ctime() {
@@ -100,51 +90,66 @@ uint32_t TimeManager::get_ctime() {
 }
 
 void TimeManager::get_full_format_time(char *format_time, uint32_t length) {
-  reset_time();
-  strftime(format_time, length, "%Y-%m-%d %H:%M:%S", &tm_);
+  Clock::format_date_time(format_time, length);
 }
 
 uint16_t TimeManager::get_year() {
-  return static_cast<uint16_t>(tm_.tm_year + 1900);
+  tm local;
+  Clock::local_tm(local);
+  return static_cast<uint16_t>(local.tm_year + 1900);
 }
 
 uint8_t TimeManager::get_month() {
-  return static_cast<uint8_t>(tm_.tm_mon + 1);
+  tm local;
+  Clock::local_tm(local);
+  return static_cast<uint8_t>(local.tm_mon + 1);
 }
 
 uint8_t TimeManager::get_day() {
-  return static_cast<uint8_t>(tm_.tm_mday);
+  tm local;
+  Clock::local_tm(local);
+  return static_cast<uint8_t>(local.tm_mday);
 }
 
 uint8_t TimeManager::get_hour() {
-  return static_cast<uint8_t>(tm_.tm_hour);
+  tm local;
+  Clock::local_tm(local);
+  return static_cast<uint8_t>(local.tm_hour);
 }
 
 uint8_t TimeManager::get_minute() {
-  return static_cast<uint8_t>(tm_.tm_min);
+  tm local;
+  Clock::local_tm(local);
+  return static_cast<uint8_t>(local.tm_min);
 }
 
 uint8_t TimeManager::get_second() {
-  return static_cast<uint8_t>(tm_.tm_sec);
+  tm local;
+  Clock::local_tm(local);
+  return static_cast<uint8_t>(local.tm_sec);
 }
 
 uint8_t TimeManager::get_week() {
-  return static_cast<uint8_t>(tm_.tm_wday);
+  tm local;
+  Clock::local_tm(local);
+  return static_cast<uint8_t>(local.tm_wday);
 }
 
+//One snapshot, the fields not torn across the minute or day rollover.
 uint32_t TimeManager::tm_todword() {
-  reset_time();
+  tm local;
+  Clock::local_tm(local);
   uint32_t result = 0;
-  result += get_year();
+  result += local.tm_year + 1900;
   result -= 2000;
   result *= 100;
-  result += get_month();
+  result += local.tm_mon + 1;
   result *= 100;
-  result += get_day();
+  result += local.tm_mday;
   result = result * 100;
-  result += get_hour();
+  result += local.tm_hour;
   result *= 100;
-  result += get_minute();
+  result += local.tm_min;
   return result;
 }
 
@@ -178,18 +183,19 @@ int32_t TimeManager::diff_day_count(time_t ansi_time1, time_t ansi_time2) {
 }
 
 uint32_t TimeManager::get_day_time() {
+  tm local;
+  Clock::local_tm(local);
   uint32_t result = 0;
-  result += get_year();
+  result += local.tm_year + 1900;
   result *= 100;
-  result += get_month();
+  result += local.tm_mon + 1;
   result *= 100;
-  result += get_day();
+  result += local.tm_mday;
   return result;
 }
 
 uint32_t TimeManager::get_run_time() {
-  get_tickcount();
-  uint32_t result = current_time_ - start_time_;
+  uint32_t result = get_tickcount() - start_time_;
   return result;
 }
 
@@ -230,9 +236,9 @@ uint32_t TimeManager::diff_time(uint32_t time1, uint32_t time2) {
 
 uint32_t TimeManager::get_days() {
   uint32_t result = 0;
-  time_t _time_t;
-  time(&_time_t);
-  tm* _tm = localtime(&set_time_);
+  tm local;
+  Clock::local_tm(local);
+  tm *_tm = &local;
   result = (_tm->tm_year - 100) * 1000;
   result += _tm->tm_yday;
   return result;
@@ -240,9 +246,9 @@ uint32_t TimeManager::get_days() {
 
 uint32_t TimeManager::get_hours() {
   uint32_t result = 0;
-  time_t _time_t;
-  time(&_time_t);
-  tm* _tm = localtime(&set_time_);
+  tm local;
+  Clock::local_tm(local);
+  tm *_tm = &local;
   if (2008 == _tm->tm_year + 1900) {
     result = 365;
   }
@@ -255,9 +261,9 @@ uint32_t TimeManager::get_hours() {
 
 uint32_t TimeManager::get_weeks() {
   uint32_t result = 0;
-  time_t _time_t;
-  time(&_time_t);
-  tm* _tm = localtime(&set_time_);
+  tm local;
+  Clock::local_tm(local);
+  tm *_tm = &local;
   result  = (_tm->tm_year - 100) * 1000;
   if (_tm->tm_yday <= _tm->tm_wday) return result;
   int32_t diff = _tm->tm_yday - _tm->tm_wday;
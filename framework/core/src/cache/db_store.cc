@@ -3,15 +3,22 @@
 #include "pf/basic/string.h"
 #include "pf/basic/stringstream.h"
 #include "pf/basic/monitor.h"
+#include "pf/basic/metrics.h"
 #include "pf/basic/io.tcc"
 #include "pf/db/interface.h"
 #include "pf/db/query.h"
 #include "pf/net/connection/basic.h"
 #include "pf/cache/packet/db_query.h"
 #include "pf/sys/thread.h"
+#include "pf/sys/work_pool.h"
 #include "pf/sys/memory/share.h"
 #include "pf/engine/kernel.h"
 #include "pf/cache/db_store.h"
+#if OS_UNIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#endif
 
 #define cache_clear(k) {using namespace pf_sys::memory::share; \
   if (GLOBALS["default.cache.clear"] == true) clear(k); \
@@ -24,6 +31,73 @@
 
 namespace pf_cache {
 
+namespace {
+
+//The snapshot file: [header|section 0..n|data 0..n]
+//The pool section data is the item header(and the same header) with the
+//used rows, the map section data is the whole map segment.
+enum {
+  kSnapshotPool = 0,
+  kSnapshotKeyMap,
+  kSnapshotRecycleMap,
+  kSnapshotQueryMap,
+};
+
+const char kSnapshotMagic[4] = {'P', 'F', 'C', 'S'};
+const uint32_t kSnapshotVersion = 1;
+
+typedef struct snapshot_header_struct {
+  char magic[4];
+  uint32_t version;
+  uint32_t sections;
+  uint32_t reserved;
+  int64_t time;
+} snapshot_header_t;
+
+typedef struct snapshot_section_struct {
+  uint8_t type;
+  uint8_t same_header;
+  int16_t index;
+  int32_t key;
+  uint32_t count;
+  uint32_t stride;
+  uint64_t size;
+  uint64_t checksum;
+} snapshot_section_t;
+
+//FNV-1a of the 8 bytes words.
+uint64_t snapshot_checksum(const char *data, size_t size) {
+  const uint64_t prime = 1099511628211ULL;
+  uint64_t result = 14695981039346656037ULL;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    result = (result ^ word) * prime;
+  }
+  for (; i < size; ++i) result = (result ^ static_cast<uint8_t>(data[i])) * prime;
+  return result;
+}
+
+//The bytes before the first row of the pool item.
+size_t snapshot_head_size(const pf_sys::memory::share::group_item_t &item) {
+  return sizeof(pf_sys::memory::share::group_item_header_t) + 
+         (item.same_header ? item.header_size : 0);
+}
+
+//Unlock the copied map(the locks in the file are not owned by anyone).
+void snapshot_map_unlock(pf_sys::memory::share::Map &map) {
+  using namespace pf_sys::memory::share;
+  auto pool = map.getpool();
+  pool->get_header()->mutex.exchange(kFlagFree);
+  for (size_t i = 0; i < pool->size(); ++i) {
+    auto node = pool->get_obj(static_cast<int32_t>(i));
+    if (node) node->header.mutex.exchange(kFlagFree);
+  }
+}
+
+} //namespace
+
 DBStore::DBStore() : 
   service_{false},
   ready_{false},
@@ -193,9 +267,9 @@ bool DBStore::init() {
     return false;
   }
   auto workers_count = GLOBALS["default.cache.workers"].get<int32_t>();
-  auto workers = new pf_sys::ThreadPool(workers_count);
+  auto workers = new pf_sys::WorkPool(workers_count);
   if (is_null(workers)) return false;
-  unique_move(pf_sys::ThreadPool, workers, workers_);
+  unique_move(pf_sys::WorkPool, workers, workers_);
   ready_ = true;
   return true;
 }
@@ -209,7 +283,10 @@ bool DBStore::init() {
  * 共享内存MAP中存储的为唯一key（如玩家ID）
  **/ 
 void *DBStore::get(const char *key) {
+  static auto &hit = pf_basic::metrics::counter("cache.hit");
+  static auto &miss = pf_basic::metrics::counter("cache.miss");
   auto item = getitem(key);
+  is_null(item) ? miss.add() : hit.add();
   return is_null(item) ? nullptr : item->get_data();
 }
 
@@ -231,7 +308,7 @@ db_item_t *DBStore::getitem(const std::string &key) {
   share_pool_iterator it_pool;
   it_pool = share_pool_map_.find(info.share_key);
   if (it_pool == share_pool_map_.end()) return nullptr;
-  result = it_pool->second->item(it_conf->second.index, static_cast<int16_t>(info.share_index));
+  result = it_pool->second->item(it_conf->second.index, info.share_index);
   return result;
 }
 
@@ -253,7 +330,7 @@ void DBStore::put(const char *key, void *value, int32_t) {
   it_pool = share_pool_map_.find(it_conf->second.share_key);
   if (it_pool == share_pool_map_.end()) return;
   if (INDEX_INVALID == info.share_index) {
-    int16_t data_index = INDEX_INVALID;
+    int32_t data_index = INDEX_INVALID;
     it_pool->second->alloc(it_conf->second.index, data_index);
     if (INDEX_INVALID == data_index) {
       auto freesize = recycle_free(info.share_key, 1);
@@ -274,7 +351,7 @@ void DBStore::put(const char *key, void *value, int32_t) {
     memcpy(cache_item->only_key, info.only_key.c_str(), info.only_key.size());
   } else { //Cached.
     char *cache = 
-        it_pool->second->real_data(it_conf->second.index, static_cast<int16_t>(info.share_index));
+        it_pool->second->real_data(it_conf->second.index, info.share_index);
     cache_set(cache, value, it_conf->second.data_size);
     if (info.recycle_index != INDEX_INVALID) 
       recycle_drop(info.share_key, info.recycle_index);
@@ -301,14 +378,15 @@ void DBStore::forget(const char *key) {
   if (it_pool == share_pool_map_.end()) return;
   query(key); //Save.
   auto tindex = it_conf->second.index;
-  auto sindex = static_cast<int16_t>(info.share_index);
+  auto sindex = info.share_index;
 
   //在多线程下，删除内存可能会存在解锁错误问题，因此这里的内存锁需要特别注意
   //必须保证锁在过程中不被修改
   auto item = it_pool->second->item(tindex, sindex);
   cache_lock(item, auto_lock);
   auto mutex_value = item->mutex.load();
-  auto swap_index = it_pool->second->free(tindex, sindex);
+  auto swap_index =
+    it_pool->second->free<db_item_t>(tindex, sindex, CACHE_SHARE_FLAG);
   //New cache share index changed.
   if (swap_index > 0) {
     item->mutex.exchange(mutex_value);
@@ -370,6 +448,7 @@ size_t DBStore::recycle_free(int32_t key, size_t size) {
       break;
     }
   }
+  if (realsize > 0) pf_basic::metrics::counter("cache.evict").add(realsize);
   return realsize;
 }
 
@@ -584,7 +663,7 @@ bool DBStore::recycle_find(int32_t key, int32_t index) {
   auto it_conf = share_config_map_.find(info.name); \
   if (it_conf == share_config_map_.end()) { f(cache); return false; }\
   auto table_info = \
-    it_pool->second->table_info(it_conf->second.index, static_cast<int16_t>(info.share_index)); \
+    it_pool->second->table_info(it_conf->second.index, info.share_index); \
   if (is_null(table_info)) { f(cache); return false; } \
   auto data = cache->get_data();
 
@@ -594,10 +673,13 @@ bool DBStore::recycle_find(int32_t key, int32_t index) {
 //and need protected with multi threads.
 //The update query can record the change status to update to sql.
 bool DBStore::query(const std::string &key) {
+  static auto &write_back = pf_basic::metrics::counter("cache.write_back");
   hash_common(key, false, cache_error);
   cache_lock(cache, cachelock);
   std::string sql{""};
   auto status = cache->status;
+  if (kQueryInsert == status || kQueryUpdate == status || 
+      kQueryDelete == status) write_back.add();
   auto db_connection = query_net_ && get_db_connection_func_ ? 
     get_db_connection_func_(*cache) : nullptr;
   auto db_env = db_env_;
@@ -613,9 +695,12 @@ bool DBStore::query(const std::string &key) {
     return false;
   }
   if (db_connection) {
+    static std::atomic<uint32_t> request_id{0};
     packet::DBQuery packet;
     packet.set_type(cache->status); //Query status.
     packet.set_id(packet_id_.query);
+    packet.set_request_id(++request_id);
+    packet.set_key(key);
     packet.set_sql_str(sql.c_str());
     return db_connection->send(&packet);
   } else {
@@ -703,12 +788,28 @@ bool DBStore::set(const std::string &key,
                   const std::string &rows) {
   hash_common(key, false, (void));
   if (is_null(data)) return false;
+  if (columns.size() > sizeof(db_table_info_t) || 
+      rows.size() > static_cast<size_t>(cache->size)) return false;
   auto _columns = cast(char *, table_info);
   memcpy(_columns, columns.c_str(), columns.size());
   memcpy(data, rows.c_str(), rows.size());
   return true;
 }
    
+bool DBStore::set_result(const std::string &key, 
+                         bool complete,
+                         const std::string &columns, 
+                         const std::string &rows) {
+  static auto &incomplete = pf_basic::metrics::counter("cache.result_drops");
+  if (complete) return set(key, columns, rows);
+  incomplete.add();
+  auto cache = getitem(key);
+  if (is_null(cache)) return false;
+  cache_lock(cache, cachelock);
+  cache->status = kQueryError;
+  return false;
+}
+
 bool DBStore::set(const std::string &key, const db_fetch_array_t &hash) {
   using namespace pf_basic;
   hash_common(key, true, (void));
@@ -752,7 +853,7 @@ bool DBStore::generate_sql(const std::string &key, std::string &sql) {
   if (it_pool == share_pool_map_.end() || it_conf == share_config_map_.end())
     return false;
   auto tindex = it_conf->second.index;
-  auto sindex = static_cast<int16_t>(info.share_index);
+  auto sindex = info.share_index;
   //auto t_base = it_pool->second->table_base(tindex, sindex);
   auto t_info = it_pool->second->table_info(tindex, sindex);
   auto t_item = it_pool->second->item(tindex, sindex);
@@ -896,7 +997,7 @@ void DBStore::tick() {
     if (query_map_.size() > 0) {
       std::string key{""}; std::string value{""};
       query_map_.pop_front(key, value);
-      workers_->enqueue([this, key](){ this->query(key); });
+      workers_->post([this, key](){ this->query(key); });
     }
   }
 
@@ -905,7 +1006,7 @@ void DBStore::tick() {
     if (!forgetlist_.empty()) {
       std::string key = forgetlist_.back();
       forgetlist_.pop_back();
-      workers_->enqueue([this, key](){ 
+      workers_->post([this, key](){ 
           this->query(key); this->forget(key.c_str()); });
     }
   }
@@ -926,4 +1027,374 @@ void DBStore::tick() {
   }
 }
 
+bool DBStore::snapshot(const std::string &filename) {
+  using namespace pf_sys::memory::share;
+  if (!ready_ || filename.empty()) return false;
+  std::vector<snapshot_section_t> sections;
+  for (auto it = share_group_map_.begin(); it != share_group_map_.end(); ++it) {
+    for (const group_item_t &item : it->second) {
+      snapshot_section_t section;
+      memset(&section, 0, sizeof(section));
+      section.type = kSnapshotPool;
+      section.key = it->first;
+      section.index = item.index;
+      sections.push_back(section);
+    }
+  }
+  //The maps after the pools, the keys changed in the gap are dropped when
+  //restore(see restore_check).
+  const uint8_t maps[] = 
+    {kSnapshotKeyMap, kSnapshotRecycleMap, kSnapshotQueryMap};
+  for (uint8_t type : maps) {
+    snapshot_section_t section;
+    memset(&section, 0, sizeof(section));
+    section.type = type;
+    sections.push_back(section);
+  }
+  std::vector<std::string> datas(sections.size());
+  std::atomic<size_t> failed{0};
+  workers_->parallel_for(0, sections.size(), [&](size_t i) {
+    auto &section = sections[i];
+    auto &data = datas[i];
+    if (kSnapshotPool == section.type) {
+      auto it_pool = share_pool_map_.find(section.key);
+      auto conf = it_pool == share_pool_map_.end() ? 
+        nullptr : it_pool->second->item_conf(section.index);
+      if (is_null(conf)) {
+        ++failed;
+        return;
+      }
+      auto pool = it_pool->second.get();
+      auto head = snapshot_head_size(*conf);
+      auto header = pool->item_header(section.index);
+      {
+        //Alloc and free are stopped only while copying the head.
+        unique_lock<group_item_header_t> auto_lock(*header, kFlagMixedWrite);
+        section.count = static_cast<uint32_t>(header->pool_position);
+        data.resize(head + conf->stride * section.count);
+        memcpy(&data[0], header, head);
+      }
+      auto header_size = conf->stride - conf->data_size;
+      for (uint32_t n = 0; n < section.count; ++n) {
+        auto item = pool->item(section.index, static_cast<int32_t>(n));
+        if (is_null(item)) break;
+        cache_lock(item, auto_lock);
+        memcpy(&data[head + conf->stride * n], 
+               reinterpret_cast<char *>(item) - header_size, 
+               conf->stride);
+      }
+      section.same_header = conf->same_header ? 1 : 0;
+      section.stride = static_cast<uint32_t>(conf->stride);
+    } else {
+      auto &map = kSnapshotKeyMap == section.type ? key_map_ : 
+        (kSnapshotRecycleMap == section.type ? recycle_map_ : query_map_);
+      auto header = map.getpool()->get_header();
+      unique_lock<header_t> auto_lock(*header, kFlagMixedWrite);
+      section.count = header->pool_position;
+      data.assign(reinterpret_cast<char *>(header), header->size);
+    }
+    section.size = data.size();
+    section.checksum = snapshot_checksum(data.data(), data.size());
+  }, 1);
+  if (failed > 0) {
+    SLOW_ERRORLOG(CACHE_MODULENAME, 
+                  "[cache] DBStore::snapshot the pool not found, failed: %zu",
+                  failed.load());
+    return false;
+  }
+  snapshot_header_t header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+  header.version = kSnapshotVersion;
+  header.sections = static_cast<uint32_t>(sections.size());
+  header.time = static_cast<int64_t>(time(nullptr));
+  //Write to the temp file and rename it, the old snapshot is kept if failed.
+  std::string temp{filename + ".tmp"};
+  FILE *fp = fopen(temp.c_str(), "wb");
+  if (is_null(fp)) {
+    SLOW_ERRORLOG(CACHE_MODULENAME, 
+                  "[cache] DBStore::snapshot open %s failed",
+                  temp.c_str());
+    return false;
+  }
+  bool result = 1 == fwrite(&header, sizeof(header), 1, fp);
+  if (result) {
+    result = sections.size() == 
+      fwrite(&sections[0], sizeof(snapshot_section_t), sections.size(), fp);
+  }
+  for (size_t i = 0; result && i < datas.size(); ++i) {
+    if (datas[i].empty()) continue;
+    result = 1 == fwrite(datas[i].data(), datas[i].size(), 1, fp);
+  }
+  result = result && 0 == fflush(fp);
+#if OS_UNIX
+  result = result && 0 == fsync(fileno(fp));
+#endif
+  fclose(fp);
+  if (!result || rename(temp.c_str(), filename.c_str()) != 0) {
+    SLOW_ERRORLOG(CACHE_MODULENAME, 
+                  "[cache] DBStore::snapshot write %s failed",
+                  filename.c_str());
+    remove(temp.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool DBStore::restore(const std::string &filename) {
+  using namespace pf_sys::memory::share;
+  if (!ready_ || !service_ || filename.empty()) return false;
+  if (key_map_.size() > 0) {
+    SLOW_ERRORLOG(CACHE_MODULENAME, 
+                  "[cache] DBStore::restore the cache not empty");
+    return false;
+  }
+  const char *content{nullptr};
+  size_t length{0};
+#if OS_UNIX
+  int32_t fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat info;
+  void *pointer = MAP_FAILED;
+  if (0 == fstat(fd, &info) && info.st_size > 0) {
+    length = static_cast<size_t>(info.st_size);
+    pointer = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  ::close(fd);
+  if (MAP_FAILED == pointer) return false;
+  content = static_cast<const char *>(pointer);
+  std::unique_ptr<void, std::function<void(void *)>> 
+    auto_unmap(pointer, [length](void *p) { munmap(p, length); });
+#else
+  std::string buffer;
+  {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) return false;
+    buffer.assign(std::istreambuf_iterator<char>(file), 
+                  std::istreambuf_iterator<char>());
+  }
+  content = buffer.data();
+  length = buffer.size();
+#endif
+  snapshot_header_t header;
+  if (length < sizeof(header)) return false;
+  memcpy(&header, content, sizeof(header));
+  auto table_size = sizeof(snapshot_section_t) * header.sections;
+  if (memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) != 0 ||
+      header.version != kSnapshotVersion ||
+      length < sizeof(header) + table_size) {
+    SLOW_ERRORLOG(CACHE_MODULENAME, 
+                  "[cache] DBStore::restore %s invalid header",
+                  filename.c_str());
+    return false;
+  }
+  std::vector<snapshot_section_t> sections(header.sections);
+  if (header.sections > 0)
+    memcpy(&sections[0], content + sizeof(header), table_size);
+  std::vector<size_t> offsets(sections.size());
+  size_t offset = sizeof(header) + table_size;
+  for (size_t i = 0; i < sections.size(); ++i) {
+    offsets[i] = offset;
+    offset += sections[i].size;
+  }
+  if (offset > length) {
+    SLOW_ERRORLOG(CACHE_MODULENAME, 
+                  "[cache] DBStore::restore %s truncated",
+                  filename.c_str());
+    return false;
+  }
+
+  //Check all before write, the cache not changed if failed.
+  std::atomic<size_t> failed{0};
+  auto map_of = [this](uint8_t type) -> Map * {
+    switch (type) {
+      case kSnapshotKeyMap: return &key_map_;
+      case kSnapshotRecycleMap: return &recycle_map_;
+      case kSnapshotQueryMap: return &query_map_;
+      default: return nullptr;
+    }
+  };
+  workers_->parallel_for(0, sections.size(), [&](size_t i) {
+    const auto &section = sections[i];
+    bool valid{false};
+    if (kSnapshotPool == section.type) {
+      auto it_pool = share_pool_map_.find(section.key);
+      auto conf = it_pool == share_pool_map_.end() ? 
+        nullptr : it_pool->second->item_conf(section.index);
+      valid = !is_null(conf) && 
+              conf->stride == section.stride &&
+              conf->same_header == (1 == section.same_header) &&
+              section.count <= conf->size &&
+              section.size == 
+                snapshot_head_size(*conf) + conf->stride * section.count;
+    } else {
+      auto map = map_of(section.type);
+      valid = !is_null(map) && 
+              map->getpool()->get_header()->size == section.size;
+    }
+    if (valid) {
+      valid = section.checksum == 
+        snapshot_checksum(content + offsets[i], section.size);
+    }
+    if (!valid) {
+      SLOW_ERRORLOG(CACHE_MODULENAME, 
+                    "[cache] DBStore::restore the section(%d, %d, %d)"
+                    " not match",
+                    section.type,
+                    section.key,
+                    section.index);
+      ++failed;
+    }
+  }, 1);
+  if (failed > 0) return false;
+
+  workers_->parallel_for(0, sections.size(), [&](size_t i) {
+    const auto &section = sections[i];
+    const char *data = content + offsets[i];
+    if (kSnapshotPool == section.type) {
+      auto pool = share_pool_map_.find(section.key)->second.get();
+      auto conf = pool->item_conf(section.index);
+      auto item_header = pool->item_header(section.index);
+      auto head = snapshot_head_size(*conf);
+      auto header_size = conf->stride - conf->data_size;
+      memcpy(reinterpret_cast<char *>(item_header), data, head);
+      item_header->mutex.exchange(kFlagFree);
+      for (uint32_t n = 0; n < section.count; ++n) {
+        auto item = pool->item(section.index, static_cast<int32_t>(n));
+        memcpy(reinterpret_cast<char *>(item) - header_size,
+               data + head + conf->stride * n,
+               conf->stride);
+        item->mutex.exchange(kFlagFree);
+      }
+    } else {
+      auto map = map_of(section.type);
+      auto map_header = map->getpool()->get_header();
+      auto key = map_header->key;
+      memcpy(reinterpret_cast<char *>(map_header), data, section.size);
+      map_header->key = key;
+      snapshot_map_unlock(*map);
+    }
+  }, 1);
+  restore_check();
+  SLOW_LOG(CACHE_MODULENAME, 
+           "[cache] DBStore::restore %s success, caches: %zu",
+           filename.c_str(),
+           key_map_.size());
+  return true;
+}
+
+void DBStore::restore_check() {
+  using namespace pf_sys::memory::share;
+  std::vector<std::string> drops;
+  std::vector<std::string> dirties;
+  for (auto it = key_map_.begin(); it != key_map_.end(); ++it) {
+    if (!cache_key_is_valid(it.first)) continue; //The recycle keys.
+    cache_info_t info; cache_info(it.first, info);
+    db_item_t *item{nullptr};
+    auto it_conf = share_config_map_.find(info.name);
+    auto it_pool = share_pool_map_.find(info.share_key);
+    if (it_conf != share_config_map_.end() && 
+        it_pool != share_pool_map_.end()) {
+      auto index = it_conf->second.index;
+      auto header = it_pool->second->item_header(index);
+      if (header && info.share_index >= 0 && 
+          info.share_index < header->pool_position)
+        item = it_pool->second->item(index, info.share_index);
+    }
+    //The row moved or freed after the pool copied.
+    if (is_null(item) || 
+        strncmp(info.only_key.c_str(), 
+                item->only_key, 
+                sizeof(item->only_key)) != 0) {
+      drops.push_back(it.first);
+      continue;
+    }
+    if (kQueryInsert == item->status || 
+        kQueryUpdate == item->status || 
+        kQueryDelete == item->status) dirties.push_back(it.first);
+  }
+  for (const std::string &key : drops)
+    key_map_.remove(key.c_str());
+  auto recycle_drops = restore_check_recycle();
+  for (const std::string &key : dirties) {
+    if (!waitquery(key.c_str()))
+      workers_->post([this, key]() { this->query(key); });
+  }
+  if (!drops.empty() || !dirties.empty() || recycle_drops > 0) {
+    SLOW_WARNINGLOG(CACHE_MODULENAME, 
+                    "[cache] DBStore::restore_check dropped: %zu,"
+                    " dirty: %zu, recycle dropped: %zu",
+                    drops.size(),
+                    dirties.size(),
+                    recycle_drops);
+  }
+}
+
+size_t DBStore::restore_check_recycle() {
+  using namespace pf_basic;
+  size_t result{0};
+  for (auto it = share_group_map_.begin(); it != share_group_map_.end(); ++it) {
+    auto key = it->first;
+    char count_key[128]{0};
+    snprintf(count_key, sizeof(count_key) - 1, "count_%d", key);
+    const char *temp = recycle_map_[count_key];
+    type::variable_t count = is_null(temp) ? 0 : temp;
+    //The entry is kept if all the keys of the only key still point to it.
+    std::vector<std::string> valids;
+    for (int32_t i = 0; i < count.get<int32_t>(); ++i) {
+      char recycle_key[128]{0};
+      snprintf(recycle_key, sizeof(recycle_key) - 1, "%d_%d", key, i);
+      std::string only_key{""};
+      if (recycle_find(key, i)) only_key = recycle_map_[recycle_key];
+      bool valid = only_key != "";
+      for (size_t n = 0; valid && n < it->second.size(); ++n) {
+        char hash_key[128]{0};
+        snprintf(hash_key, 
+                 sizeof(hash_key) - 1, 
+                 "%s#%s", 
+                 it->second[n].name.c_str(), only_key.c_str());
+        cache_info_t info; cache_info(hash_key, info);
+        valid = info.recycle_index == i;
+      }
+      if (valid) {
+        valids.push_back(only_key);
+      } else {
+        ++result;
+        if (only_key != "") recycle_unlink(key, only_key);
+      }
+      recycle_map_.set(recycle_key, "0");
+    }
+    //Pack the kept entries from 0.
+    for (size_t i = 0; i < valids.size(); ++i) {
+      char recycle_key[128]{0};
+      snprintf(recycle_key, sizeof(recycle_key) - 1, "%d_%zu", key, i);
+      recycle_map_.set(recycle_key, valids[i].c_str());
+      recycle_mod(key, valids[i], static_cast<int32_t>(i));
+    }
+    if (count.get<int32_t>() > 0) {
+      type::variable_t val;
+      val = static_cast<int32_t>(valids.size());
+      recycle_map_.set(count_key, val.c_str());
+    }
+  }
+  return result;
+}
+
+void DBStore::recycle_unlink(int32_t key, const std::string &only_key) {
+  auto it = share_group_map_.find(key);
+  if (it == share_group_map_.end()) return;
+  for (const pf_sys::memory::share::group_item_t &item : it->second) {
+    char hash_key[128]{0};
+    snprintf(hash_key, 
+             sizeof(hash_key) - 1, 
+             "%s#%s", 
+             item.name.c_str(), only_key.c_str());
+    cache_info_t info; cache_info(hash_key, info);
+    if (INDEX_INVALID == info.share_index) continue;
+    char hash[128]{0};
+    snprintf(hash, sizeof(hash) - 1, "%d#%d", info.share_index, INDEX_INVALID);
+    key_map_.set(hash_key, hash);
+  }
+}
+
 } //namespace pf_cache
@@ -0,0 +1,117 @@
+#include "pf/basic/logger.h"
+#include "pf/net/connection/basic.h"
+#include "pf/net/connection/manager/interface.h"
+#include "pf/cache/packet/db_query.h"
+#include "pf/cache/db_worker.h"
+
+namespace pf_cache {
+
+DBWorker::DBWorker(const std::vector<pf_db::Interface *> &envs,
+                   uint32_t inflight_max) :
+  workers_{nullptr},
+  envs_{envs},
+  env_count_{envs.size()},
+  inflight_max_{inflight_max},
+  queue_depth_{0},
+  queue_depth_max_{0},
+  posted_{0},
+  rejected_{0} {
+  auto count = 0 == env_count_ ? 1 : env_count_;
+  std::unique_ptr<pf_sys::WorkPool> pointer(new pf_sys::WorkPool(count));
+  workers_ = std::move(pointer);
+}
+
+DBWorker::~DBWorker() {
+  workers_.reset(); //Wait the queries finish.
+}
+
+bool DBWorker::post(pf_net::connection::Basic *connection,
+                    packet::DBQuery *query) {
+  if (is_null(connection) || is_null(query)) return false;
+  auto manager = connection->get_manager();
+  int16_t connection_id = connection->get_id();
+  if (is_null(manager) || connection_id < 0) return false;
+  {
+    std::unique_lock<std::mutex> lock(inflight_mutex_);
+    auto &inflight = get_inflight(connection);
+    if (inflight_max_ != 0 && inflight.count >= inflight_max_) {
+      ++rejected_;
+      return false;
+    }
+    ++inflight.count;
+    ++posted_;
+  }
+  query->set_generation(connection->get_generation());
+  uint32_t depth = ++queue_depth_;
+  uint32_t depth_max = queue_depth_max_;
+  while (depth > depth_max &&
+         !queue_depth_max_.compare_exchange_weak(depth_max, depth)) {
+  }
+  workers_->post([this, manager, connection_id, query]() {
+    this->run(manager, connection_id, query);
+  });
+  return true;
+}
+
+void DBWorker::finish(pf_net::connection::Basic *connection, 
+                      uint32_t generation) {
+  if (is_null(connection) || connection->get_id() < 0) return;
+  std::unique_lock<std::mutex> lock(inflight_mutex_);
+  auto &inflight = get_inflight(connection);
+  if (inflight.generation == generation && inflight.count > 0) 
+    --inflight.count;
+}
+
+uint32_t DBWorker::inflight(pf_net::connection::Basic *connection) {
+  if (is_null(connection) || connection->get_id() < 0) return 0;
+  std::unique_lock<std::mutex> lock(inflight_mutex_);
+  return get_inflight(connection).count;
+}
+
+DBWorker::inflight_t &DBWorker::get_inflight(
+    pf_net::connection::Basic *connection) {
+  auto &inflights = inflight_[connection->get_manager()];
+  size_t id = static_cast<size_t>(connection->get_id());
+  if (id >= inflights.size()) inflights.resize(id + 1);
+  auto &inflight = inflights[id];
+  if (inflight.generation != connection->get_generation()) { //Cleared.
+    inflight.generation = connection->get_generation();
+    inflight.count = 0;
+  }
+  return inflight;
+}
+
+void DBWorker::run(pf_net::connection::manager::Interface *manager,
+                   int16_t connection_id,
+                   packet::DBQuery *query) {
+  --queue_depth_;
+  auto env = 0 == env_count_ ? nullptr : env_acquire();
+  try {
+    query->query(env);
+  } catch(...) {
+    SLOW_ERRORLOG(CACHE_MODULENAME,
+                  "[cache] (DBWorker::run) query exception, sql: %s",
+                  query->get_sql_str());
+  }
+  if (env) env_release(env);
+  //Execute again in the thread of the manager, then send the result.
+  manager->send(query, static_cast<uint16_t>(connection_id));
+}
+
+pf_db::Interface *DBWorker::env_acquire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait(lock, [this]() { return !envs_.empty(); });
+  auto env = envs_.back();
+  envs_.pop_back();
+  return env;
+}
+
+void DBWorker::env_release(pf_db::Interface *env) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    envs_.push_back(env);
+  }
+  condition_.notify_one();
+}
+
+} //namespace pf_cache
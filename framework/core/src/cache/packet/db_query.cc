@@ -1,22 +1,31 @@
+#include "pf/basic/logger.h"
+#include "pf/basic/time_manager.h"
 #include "pf/cache/db_store.h"
+#include "pf/cache/db_worker.h"
+#include "pf/db/interface.h"
 #include "pf/db/query.h"
 #include "pf/engine/kernel.h"
 #include "pf/net/connection/basic.h"
+#include "pf/net/connection/manager/basic.h"
 #include "pf/cache/packet/db_result.h"
 #include "pf/cache/packet/db_query.h"
 
 using namespace pf_cache::packet;
 
+DBQuery::~DBQuery() {
+  //do nothing
+}
+
 bool DBQuery::read(pf_net::stream::Input &istream) {
   type_ = istream.read_int8();
   operate_ = istream.read_int8();
-  istream.read_string(key_, sizeof(key_) - 1);
-  istream.read_string(sql_str_, sizeof(sql_str_) - 1);
-  return true;
+  request_id_ = istream.read_uint32();
+  if (!istream.read_string(key_, CACHE_PACKET_KEY_LENGTH_MAX)) return false;
+  return istream.read_string(sql_str_, SQL_LENGTH_MAX - 1);
 }
 
 bool DBQuery::write(pf_net::stream::Output &ostream) {
-  ostream << type_ << operate_ << key_ << sql_str_;
+  ostream << type_ << operate_ << request_id_ << key_ << sql_str_;
   return true;
 }
 
@@ -24,8 +33,9 @@ uint32_t DBQuery::size() const {
   size_t result = 0;
   result += sizeof(type_);
   result += sizeof(operate_);
-  result += strlen(key_);
-  result += strlen(sql_str_);
+  result += sizeof(request_id_);
+  result += sizeof(uint32_t) + key_.size();
+  result += sizeof(uint32_t) + sql_str_.size();
   return static_cast<uint32_t>(result);
 }
 
@@ -34,33 +44,98 @@ uint32_t DBQuery::execute(pf_net::connection::Basic *connection) {
     return Interface::execute(connection);
   }
   if (!ENGINE_POINTER) return kPacketExecuteStatusContinue;
+  auto worker = ENGINE_POINTER->get_db_worker();
+  if (result_) { //Back from the db workers.
+    if (worker) worker->finish(connection, generation_);
+    //The pooled connection reused by the other while querying.
+    if (connection->get_generation() != generation_) {
+      SLOW_WARNINGLOG(CACHE_MODULENAME,
+                      "[cache] (DBQuery::execute) the connection(%d) changed,"
+                      " drop the result of request: %u",
+                      connection->get_id(),
+                      request_id_);
+      return kPacketExecuteStatusContinue;
+    }
+    if (!connection->is_disconnect()) connection->send(result_.get());
+    return kPacketExecuteStatusContinue;
+  }
+  if (worker && connection->get_manager()) {
+    if (worker->post(connection, this)) 
+      return kPacketExecuteStatusNotRemove; //The worker own it.
+    static uint32_t checktime{0};
+    auto now = TIME_MANAGER_POINTER->get_tickcount();
+    if (0 == checktime || now - checktime >= 10000) {
+      SLOW_WARNINGLOG(CACHE_MODULENAME,
+                      "[cache] (DBQuery::execute) the connection(%d) in"
+                      " flight queries reached the max(%d), rejected: %d",
+                      connection->get_id(),
+                      worker->get_inflight_max(),
+                      worker->rejected());
+      checktime = now;
+    }
+    DBResult packet;
+    result_init(packet); //Failed, the requester can retry.
+    connection->send(&packet);
+    return kPacketExecuteStatusContinue;
+  }
   auto dbenv = ENGINE_POINTER->get_db();
   if (!dbenv) return kPacketExecuteStatusContinue;
   DBResult packet;
-  packet.set_result(DBResult::kResultFailed);
-  pf_db::Query query;
-  if (query.init(dbenv)) {
-    query.set_sql(get_sql_str());
-    if (query.query()) {
-      packet.set_result(DBResult::kResultSuccess);
-      if (kQuerySelect == get_type()) {
-        char columns[CACHE_DB_TABLE_COLUMNS_SIZE]{0};
-        char rows[100 * 1024]{0};
-        query.fetch(columns, sizeof(columns), rows, sizeof(rows));
-        packet.set_columns(columns);
-        packet.set_rows(rows);
-      }
-    }
+  {
+    db_lock(dbenv, db_auto_lock);
+    query(dbenv, packet);
   }
   connection->send(&packet);
   return kPacketExecuteStatusContinue;
 }
 
+void DBQuery::query(pf_db::Interface *env) {
+  std::unique_ptr<DBResult> pointer(new DBResult());
+  result_ = std::move(pointer);
+  query(env, *result_);
+}
+
+void DBQuery::result_init(DBResult &result) const {
+  result.set_id(CACHE_SHARE_NET_RESULT_PACKET_ID);
+  result.set_result(DBResult::kResultFailed);
+  result.set_operate(operate_);
+  result.set_request_id(request_id_);
+  result.set_key(key_);
+}
+
+void DBQuery::query(pf_db::Interface *env, DBResult &result) {
+  result_init(result);
+  pf_db::Query query;
+  if (!query.init(env)) return;
+  query.set_sql(sql_str_);
+  if (!query.query()) return;
+  if (kQuerySelect == get_type()) {
+    std::string columns, rows; //Only the fetched bytes.
+    bool truncated{false};
+    query.fetch(columns, rows, CACHE_PACKET_ROWS_SIZE_MAX, &truncated);
+    if (columns.size() > CACHE_DB_TABLE_COLUMNS_SIZE) return;
+    if (truncated) {
+      SLOW_WARNINGLOG(CACHE_MODULENAME,
+                      "[cache] (DBQuery::query) the rows truncated to %d"
+                      " bytes, key: %s",
+                      static_cast<int32_t>(rows.size()),
+                      key_.c_str());
+    }
+    result.set_columns(std::move(columns));
+    result.set_rows(std::move(rows));
+    result.set_result(
+        truncated ? DBResult::kResultTruncated : DBResult::kResultSuccess);
+    return;
+  }
+  result.set_result(DBResult::kResultSuccess);
+}
+
 uint32_t DBQueryFactory::packet_max_size() const {
   uint32_t result = 0;
   result += sizeof(int8_t);
   result += sizeof(int8_t);
-  result += 128;
-  result += SQL_LENGTH_MAX;
+  result += sizeof(uint32_t);
+  result += sizeof(uint32_t) + CACHE_PACKET_KEY_LENGTH_MAX;
+  result += sizeof(uint32_t) + SQL_LENGTH_MAX;
   return result;
 }
@@ -1,3 +1,4 @@
+#include "pf/basic/logger.h"
 #include "pf/engine/kernel.h"
 #include "pf/cache/repository.h"
 #include "pf/cache/db_store.h"
@@ -8,16 +9,14 @@ using namespace pf_cache::packet;
 bool DBResult::read(pf_net::stream::Input &istream) {
   result_ = istream.read_int8();
   operate_ = istream.read_int8();
-  istream.read_string(key_, sizeof(key_) - 1);
-  istream >> columns_;
-  istream >> rows_;
-  data_size_ = static_cast<int32_t>(columns_.size() + rows_.size());
-  return true;
+  request_id_ = istream.read_uint32();
+  if (!istream.read_string(key_, CACHE_PACKET_KEY_LENGTH_MAX)) return false;
+  if (!istream.read_string(columns_, CACHE_DB_TABLE_COLUMNS_SIZE)) return false;
+  return istream.read_string(rows_, CACHE_PACKET_ROWS_SIZE_MAX);
 }
 
 bool DBResult::write(pf_net::stream::Output &ostream) {
-  ostream << result_ << operate_ << key_ << columns_ << rows_;
-  data_size_ = static_cast<int32_t>(columns_.size() + rows_.size());
+  ostream << result_ << operate_ << request_id_ << key_ << columns_ << rows_;
   return true;
 }
 
@@ -25,8 +24,10 @@ uint32_t DBResult::size() const {
   uint32_t result = 0;
   result += sizeof(result_);
   result += sizeof(operate_);
-  result += 128;
-  result += data_size_;
+  result += sizeof(request_id_);
+  result += sizeof(uint32_t) + static_cast<uint32_t>(key_.size());
+  result += sizeof(uint32_t) + static_cast<uint32_t>(columns_.size());
+  result += sizeof(uint32_t) + static_cast<uint32_t>(rows_.size());
   return result;
 }
 
@@ -36,10 +37,16 @@ uint32_t DBResult::execute(pf_net::connection::Basic *) {
   if (!cache_manager) return kPacketExecuteStatusContinue;
   auto store = 
     dynamic_cast< pf_cache::DBStore *>(cache_manager->get_db_dirver()->store());
-  store->set(get_key(), columns_, rows_); 
+  if (is_null(store)) return kPacketExecuteStatusContinue;
+  //Only the whole rows are cached, a partial answer is not served later.
+  if (kResultSuccess != result_) {
+    SLOW_WARNINGLOG(CACHE_MODULENAME,
+                    "[cache.packet] DBResult::execute not cached,"
+                    " key: %s, result: %d",
+                    get_key(),
+                    result_);
+  }
+  store->set_result(get_key(), kResultSuccess == result_, columns_, rows_);
   return kPacketExecuteStatusContinue;
 }
 
-uint32_t DBResult::get_data_size() const {
-  return static_cast<uint32_t>(columns_.size() + rows_.size());
-}
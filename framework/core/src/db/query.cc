@@ -2,10 +2,26 @@
 #include "pf/db/interface.h"
 #include "pf/basic/stringstream.h"
 #include "pf/basic/io.tcc"
+#include "pf/basic/metrics.h"
 #include "pf/db/query.h"
 
 namespace pf_db {
 
+namespace {
+
+template <typename T>
+void append(std::string &str, T var) {
+  str.append(reinterpret_cast<const char *>(&var), sizeof(var));
+}
+
+void append(std::string &str, const char *var) {
+  auto size = static_cast<int32_t>(strlen(var));
+  append(str, size);
+  str.append(var, size);
+}
+
+} //namespace
+
 Query::Query()
   : tablename_{0},
   env_{nullptr},
@@ -29,7 +45,9 @@ void Query::set_tablename(const std::string &tablename) {
 }
 
 bool Query::query() {
+  static auto &query_time = pf_basic::metrics::histogram("db.query_us");
   if (!isready_ || is_null(env_)) return false;
+  pf_basic::metrics::ScopedTimer timer(query_time);
   bool result = env_->query(sql_);
   return result;
 }
@@ -263,85 +281,90 @@ bool Query::fetcharray(db_fetch_array_t &db_fetch_array) {
 }
 
 bool Query::fetch(char *str, size_t size) {
-  using namespace pf_basic;
+  std::string columns, rows;
+  bool truncated{false};
+  if (is_null(str) || 0 == size) return false;
+  memset(str, 0, size);
+  if (!serialize_columns(columns) || columns.size() > size) return false;
+  if (!serialize_rows(rows, size - columns.size(), truncated)) return false;
+  memcpy(str, columns.data(), columns.size());
+  memcpy(str + columns.size(), rows.data(), rows.size());
+  return !truncated;
+}
+
+bool Query::fetch(
+    char *columns, size_t columns_size, char *rows, size_t rows_size) {
+  std::string _columns, _rows;
+  bool truncated{false};
+  if (is_null(columns) || is_null(rows)) return false;
+  memset(columns, 0, columns_size);
+  memset(rows, 0, rows_size);
+  if (!serialize_columns(_columns) || _columns.size() > columns_size) 
+    return false;
+  if (!serialize_rows(_rows, rows_size, truncated)) return false;
+  memcpy(columns, _columns.data(), _columns.size());
+  memcpy(rows, _rows.data(), _rows.size());
+  return !truncated;
+}
+
+bool Query::fetch(std::string &columns, 
+                  std::string &rows, 
+                  size_t rows_max, 
+                  bool *truncated) {
+  bool _truncated{false};
+  rows.clear();
+  bool result = 
+    serialize_columns(columns) && serialize_rows(rows, rows_max, _truncated);
+  if (truncated) *truncated = _truncated;
+  return result && !_truncated;
+}
+
+bool Query::serialize_columns(std::string &columns) {
+  columns.clear();
   if (!isready_ || is_null(env_)) return false;
   if (!env_->fetch()) return false;
   int32_t columncount = env_->get_columncount();
   if (columncount <= 0) return false;
-  stringstream sstream(str, size);
-  sstream.clear();
-  sstream << columncount;
-  int32_t i = 0;
-  //read keys
-  for (i = 0; i < columncount; ++i) {
-    const char *columnname = env_->get_columnname(i);
-    auto columntype = static_cast<int8_t>(env_->gettype(i));
-    sstream << columnname;
-    sstream << columntype;
+  append(columns, columncount);
+  for (int32_t i = 0; i < columncount; ++i) {
+    append(columns, env_->get_columnname(i));
+    append(columns, static_cast<int8_t>(env_->gettype(i)));
   }
-  int32_t row = 0;
-  auto row_position = sstream.get_position();
-  sstream << row;
-  //read values
-  do {
-    for (i = 0; i < columncount; ++i) {
-      type::variable_t value = env_->get_data(i, "");
-      auto columntype = env_->gettype(i);
-      if (kDBColumnTypeString == columntype) {
-        sstream << value.c_str();
-      } else if (kDBColumnTypeNumber == columntype) {
-        sstream << value.get<double>();
-      } else {
-        sstream << value.get<int64_t>();
-      }
-      if (0 == (i + 1) % columncount && i != 0) row += 1;
-      if (sstream.full()) return false;
-    }
-  } while (env_->fetch());
-  sstream.set_position(row_position);
-  sstream << row;
   return true;
 }
 
-bool Query::fetch(
-    char *columns, size_t columns_size, char *rows, size_t rows_size) {
+bool Query::serialize_rows(std::string &rows, 
+                           size_t rows_max, 
+                           bool &truncated) {
   using namespace pf_basic;
-  if (!isready_ || is_null(env_)) return false;
-  if (!env_->fetch()) return false;
+  rows.clear();
+  truncated = false;
   int32_t columncount = env_->get_columncount();
-  if (columncount <= 0) return false;
-  stringstream scolumns(columns, columns_size);
-  scolumns.clear();
-  scolumns << columncount;
-  int32_t i{0};
-  for (i = 0; i < columncount; ++i) {
-    const char *columnname = env_->get_columnname(i);
-    auto columntype = static_cast<int8_t>(env_->gettype(i));
-    scolumns << columnname;
-    scolumns << columntype;
-  }
-  stringstream srows(rows, rows_size);
-  srows.clear();
   int32_t row = 0;
-  auto row_position = srows.get_position();
-  srows << row;
+  if (sizeof(row) > rows_max) return false;
+  append(rows, row);
+  std::string data;
   do {
-    for (i = 0; i < columncount; ++i) {
+    data.clear();
+    for (int32_t i = 0; i < columncount; ++i) {
       type::variable_t value = env_->get_data(i, "");
       auto columntype = env_->gettype(i);
       if (kDBColumnTypeString == columntype) {
-        srows << value.c_str();
+        append(data, value.c_str());
       } else if (kDBColumnTypeNumber == columntype) {
-        srows << value.get<double>();
+        append(data, value.get<double>());
       } else {
-        srows << value.get<int64_t>();
+        append(data, value.get<int64_t>());
       }
-      if (0 == (i + 1) % columncount && i != 0) row += 1;
-      if (srows.full()) return false;
     }
+    if (rows.size() + data.size() > rows_max) { //Stop on the row boundary.
+      truncated = true;
+      break;
+    }
+    rows.append(data);
+    ++row;
   } while (env_->fetch());
-  srows.set_position(row_position);
-  srows << row;
+  memcpy(&rows[0], &row, sizeof(row));
   return true;
 }
 
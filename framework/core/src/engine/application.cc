@@ -3,6 +3,7 @@
 #include "pf/basic/util.h"
 #include "pf/basic/io.tcc"
 #include "pf/sys/util.h"
+#include "pf/net/protocol/profiler.h"
 #include "pf/engine/kernel.h"
 #include "pf/engine/application.h"
 
@@ -27,6 +28,11 @@ void helps() {
 #if OS_UNIX /* { */
 void signal_handler(int32_t signal) {
   using namespace pf_basic;
+  //Save the packet profile report in the kernel loop.
+  if (signal == SIGUSR2) {
+    pf_net::protocol::Profiler::request_report();
+    return;
+  }
   //处理前台模式信号
   static uint32_t last_signaltime = 0;
   uint32_t currenttime = TIME_MANAGER_POINTER->get_tickcount();
@@ -164,6 +170,7 @@ void Application::run() {
 #if OS_UNIX
   signal(SIGINT, signal_handler);
   signal(SIGUSR1, signal_handler);
+  signal(SIGUSR2, signal_handler);
 #elif OS_WIN 
   pf_basic::util::disable_windowclose();
   if (SetConsoleCtrlHandler(
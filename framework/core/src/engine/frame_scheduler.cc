@@ -0,0 +1,90 @@
+#include "pf/basic/type/variable.h"
+#include "pf/basic/global.h"
+#include "pf/sys/process.h"
+#include "pf/engine/frame_scheduler.h"
+
+namespace pf_engine {
+
+namespace {
+
+void update_max(std::atomic<uint64_t> &max, uint64_t value) {
+  auto current = max.load(std::memory_order_relaxed);
+  while (value > current && !max.compare_exchange_weak(current, value)) {
+  }
+}
+
+} //namespace
+
+FrameScheduler::FrameScheduler(const std::string &name,
+                               uint32_t frame,
+                               uint32_t spin) :
+  name_{name},
+  frame_{0},
+  spin_{0},
+  stop_{false},
+  threadid_{0},
+  frames_{0},
+  overruns_{0},
+  dropped_{0},
+  overrun_max_{0},
+  overrun_total_{0},
+  work_max_{0} {
+  set_frame(frame);
+  spin_ =
+    0 == spin ? GLOBALS["default.engine.frame_spin"].get<uint32_t>() : spin;
+}
+
+void FrameScheduler::set_frame(uint32_t frame) {
+  if (0 == frame) frame = GLOBALS["default.engine.frame"].get<uint32_t>();
+  frame_ = 0 == frame ? 1 : frame;
+}
+
+void FrameScheduler::start() {
+  threadid_ = pf_sys::process::get_threadid();
+  deadline_ = std::chrono::steady_clock::now();
+  frame_start_ = deadline_;
+}
+
+bool FrameScheduler::wait() {
+  using namespace std::chrono;
+  auto now = steady_clock::now();
+  auto work = duration_cast<microseconds>(now - frame_start_).count();
+  update_max(work_max_, static_cast<uint64_t>(work));
+  ++frames_;
+  auto period = microseconds(1000000 / frame_);
+  deadline_ += period;
+  if (now >= deadline_) {
+    auto late = duration_cast<microseconds>(now - deadline_);
+    ++overruns_;
+    overrun_total_ += static_cast<uint64_t>(late.count());
+    update_max(overrun_max_, static_cast<uint64_t>(late.count()));
+    if (late >= period) { //Drop the missed frames, not a burst to catch up.
+      ++dropped_;
+      deadline_ = now;
+    }
+    frame_start_ = now;
+    return false;
+  }
+  auto spin = microseconds(spin_.load());
+  if (deadline_ - now > spin)
+    std::this_thread::sleep_until(deadline_ - spin);
+  while (steady_clock::now() < deadline_) std::this_thread::yield();
+  frame_start_ = steady_clock::now();
+  return true;
+}
+
+frame_stat_t FrameScheduler::stat() const {
+  frame_stat_t result;
+  result.name = name_;
+  result.threadid = threadid_;
+  result.frame = frame_;
+  result.frames = frames_;
+  result.overruns = overruns_;
+  result.dropped = dropped_;
+  result.overrun_max = overrun_max_;
+  result.overrun_total = overrun_total_;
+  result.work_max = work_max_;
+  return result;
+}
+
+} //namespace pf_engine
@@ -1,8 +1,11 @@
 #include "pf/basic/io.tcc"
 #include "pf/basic/time_manager.h"
 #include "pf/basic/logger.h"
+#include "pf/basic/clock.h"
+#include "pf/basic/metrics.h"
 #include "pf/net/connection/manager/listener.h"
 #include "pf/net/connection/manager/connector.h"
+#include "pf/net/protocol/profiler.h"
 #include "pf/db/interface.h"
 #include "pf/db/factory.h"
 #include "pf/script/factory.h"
@@ -10,6 +13,7 @@
 #include "pf/cache/repository.h"
 #include "pf/cache/db_store.h"
 #include "pf/cache/manager.h"
+#include "pf/cache/db_worker.h"
 #include "pf/sys/thread.h"
 #include "pf/engine/thread.h"
 #include "pf/file/library.h"
@@ -33,13 +37,19 @@ Kernel::Kernel() :
   db_factory_{nullptr},
   db_eid_{DB_EID_INVALID},
   cache_{nullptr},
+  db_worker_{nullptr},
   script_factory_{nullptr},
   script_eid_{SCRIPT_EID_INVALID},
+  sampler_{nullptr},
   isinit_{false},
-  stop_{false} {
+  waiting_{false},
+  stop_{false},
+  loop_option_{0, 0, 0, 0},
+  loop_option_time_{0} {
 }
 
 Kernel::~Kernel() {
+  sampler_.reset(); //It reads the frame stats.
   for (std::thread &worker : thread_workers_) {
     worker.join();
   }
@@ -71,20 +81,37 @@ bool Kernel::init() {
 void Kernel::run() {
   if (!is_null(net_)) {
     auto net = net_.get();
-    this->newthread([&net]() { return thread::for_net(net); });
+    this->newthread_frame({"net", 0, 0}, 
+                          [net]() { return thread::for_net(net); });
   }
   if (!is_null(db_factory_) && db_eid_ != DB_EID_INVALID) {
     auto env = db_factory_->getenv(db_eid_);
-    this->newthread([&env]() { return thread::for_db(env); });
+    this->newthread_frame({"db", 0, 0}, 
+                          [env]() { return thread::for_db(env); });
   }
   if (!is_null(script_factory_) && script_eid_ != SCRIPT_EID_INVALID) { 
     auto env = script_factory_->getenv(script_eid_);
     env->call(GLOBALS["default.script.enter"].data);
-    this->newthread([&env]() { return thread::for_script(env); });
+    this->newthread_frame({"script", 0, 0}, 
+                          [env]() { return thread::for_script(env); });
   }
   if (!is_null(cache_)) {
     auto cache = cache_.get();
-    this->newthread([&cache]() { return thread::for_cache(cache); });
+    this->newthread_frame({"cache", 0, 0}, 
+                          [cache]() { return thread::for_cache(cache); });
+  }
+  auto interval = GLOBALS["default.engine.sampler"].get<uint32_t>();
+  if (interval > 0 && is_null(sampler_)) {
+    auto size = GLOBALS["default.engine.sampler_size"].get<uint32_t>();
+    sampler_.reset(new Sampler(this, interval, size));
+    sampler_threshold_t threshold;
+    threshold.cpu = GLOBALS["default.engine.sampler_cpu"].get<uint32_t>();
+    threshold.rss = GLOBALS["default.engine.sampler_rss"].get<uint64_t>();
+    threshold.fds = GLOBALS["default.engine.sampler_fds"].get<uint64_t>();
+    threshold.delay = GLOBALS["default.engine.sampler_delay"].get<uint32_t>();
+    threshold.steal = GLOBALS["default.engine.sampler_steal"].get<uint32_t>();
+    sampler_->set_threshold(threshold);
+    sampler_->start();
   }
   GLOBALS["app.status"] = kAppStatusRunning;
   loop();
@@ -94,8 +121,22 @@ void Kernel::stop() {
   for (std::thread &worker : thread_workers_) {
     pf_sys::thread::stop(worker);
   }
+  {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    for (auto &scheduler : thread_schedulers_) scheduler->stop();
+  }
+  if (!is_null(sampler_)) sampler_->stop();
   GLOBALS["app.status"] = kAppStatusStop;
   stop_ = true;
+  wakeup();
+}
+
+std::vector<frame_stat_t> Kernel::get_frame_stats() {
+  std::vector<frame_stat_t> result;
+  std::unique_lock<std::mutex> lock(queue_mutex_);
+  for (auto &scheduler : thread_schedulers_) 
+    result.push_back(scheduler->stat());
+  return result;
 }
 
 bool Kernel::init_base() {
@@ -139,6 +180,9 @@ bool Kernel::init_net() {
   SLOW_DEBUGLOG(ENGINE_MODULENAME, 
                 "[%s] Kernel::init_net start...", 
                 ENGINE_MODULENAME);
+  protocol::Profiler::set_slow(
+      GLOBALS["default.net.profile_slow"].get<uint64_t>());
+  protocol::Profiler::set_enable(GLOBALS["default.net.profile"] == true);
   connection::manager::Basic *net{nullptr};
   auto conn_max = GLOBALS["default.net.conn_max"].get<uint16_t>();
   if (GLOBALS["default.net.service"] == true) {
@@ -181,6 +225,22 @@ bool Kernel::init_db() {
   if (DB_EID_INVALID == db_eid_) return false;
   auto env = db_factory_->getenv(db_eid_);
   if (!env->init()) return false;
+  //The workers query with their own envs, not block the net thread.
+  auto workers = GLOBALS["default.db.workers"].get<int32_t>();
+  if (workers > 0) {
+    std::vector<pf_db::Interface *> envs;
+    for (int32_t i = 0; i < workers; ++i) {
+      auto eid = db_factory_->newenv(conf);
+      if (DB_EID_INVALID == eid) return false;
+      auto worker_env = db_factory_->getenv(eid);
+      if (!worker_env->init()) return false;
+      envs.push_back(worker_env);
+    }
+    auto db_worker = new pf_cache::DBWorker(
+        envs, GLOBALS["default.db.inflight"].get<uint32_t>());
+    if (is_null(db_worker)) return false;
+    unique_move(pf_cache::DBWorker, db_worker, db_worker_);
+  }
   return true;
 }
 
@@ -203,6 +263,18 @@ bool Kernel::init_cache() {
   store->set_service(GLOBALS["default.cache.service"].get<bool>());
   if (!store->load_config(GLOBALS["default.cache.conf"].c_str())) return false;
   if (!store->init()) return false;
+  //Warm restart from the snapshot(skip if the share memory still alive).
+  std::string snapshot{GLOBALS["default.cache.snapshot"].c_str()};
+  if (GLOBALS["default.cache.service"] == true && 
+      !snapshot.empty() && 
+      0 == store->get_keymap()->size() && 
+      std::ifstream(snapshot).good() &&
+      !store->restore(snapshot)) {
+    SLOW_WARNINGLOG(ENGINE_MODULENAME, 
+                    "[%s] Kernel::init_cache restore %s failed",
+                    ENGINE_MODULENAME,
+                    snapshot.c_str());
+  }
   return true;
 }
 
@@ -229,18 +301,28 @@ bool Kernel::init_script() {
 }
 
 void Kernel::loop() {
+  auto metrics_time = pf_basic::Clock::now_ms();
+  auto snapshot_time = metrics_time;
   for (;;) {
     if (GLOBALS["app.status"] == kAppStatusStop) break;
     auto starttime = TIME_MANAGER_POINTER->get_tickcount();
-    std::function<void()> task;
-    {
-      if (!tasks_.empty()) {
-        task = std::move(this->tasks_.front());
-        this->tasks_.pop();
-      }
+    refresh_options();
+    work_tasks(loop_option_.budget);
+    auto metrics = loop_option_.metrics;
+    if (metrics > 0 && 
+        pf_basic::Clock::now_ms() - metrics_time >= metrics * 1000) {
+      metrics_time = pf_basic::Clock::now_ms();
+      pf_basic::metrics::log("metrics");
+    }
+    if (pf_net::protocol::Profiler::report_requested())
+      pf_net::protocol::Profiler::log();
+    auto snapshot = loop_option_.snapshot;
+    if (snapshot > 0 && 
+        pf_basic::Clock::now_ms() - snapshot_time >= snapshot * 1000) {
+      snapshot_time = pf_basic::Clock::now_ms();
+      snapshot_cache();
     }
-    if (task) task();
-    worksleep(starttime);
+    wait_tasks(starttime);
   }
   auto check_starttime = TIME_MANAGER_POINTER->get_tickcount();
   for (;;) {
@@ -252,4 +334,69 @@ void Kernel::loop() {
     }
     if (pf_sys::ThreadCollect::count() <= 0) break;
   }
+  snapshot_cache(); //The last one for the warm restart.
+}
+
+void Kernel::snapshot_cache() {
+  using namespace pf_cache;
+  std::string snapshot{GLOBALS["default.cache.snapshot"].c_str()};
+  if (is_null(cache_) || 
+      !GLOBALS["default.cache.service"].get<bool>() || 
+      snapshot.empty()) return;
+  auto dirver = cache_->get_db_dirver();
+  if (is_null(dirver)) return;
+  auto store = dynamic_cast< DBStore *>(dirver->store());
+  if (is_null(store)) return;
+  if (!store->snapshot(snapshot)) {
+    SLOW_WARNINGLOG(ENGINE_MODULENAME, 
+                    "[%s] Kernel::snapshot_cache %s failed",
+                    ENGINE_MODULENAME,
+                    snapshot.c_str());
+  }
+}
+
+uint32_t Kernel::work_tasks(uint32_t budget) {
+  auto starttime = TIME_MANAGER_POINTER->get_tickcount();
+  uint32_t count{0};
+  std::function<void()> task;
+  while (tasks_.pop(task)) {
+    task();
+    ++count;
+    if (TIME_MANAGER_POINTER->get_tickcount() - starttime >= budget) break;
+  }
+  return count;
+}
+
+void Kernel::wait_tasks(uint32_t starttime) {
+  auto worktime = 
+    static_cast<int32_t>(TIME_MANAGER_POINTER->get_tickcount() - starttime);
+  auto time = loop_option_.frametime - worktime;
+  if (time <= 0) return;
+  waiting_ = true;
+  {
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    wait_condition_.wait_for(lock, 
+                             std::chrono::milliseconds(time), 
+                             [this]() { return stop_ || !tasks_.empty(); });
+  }
+  waiting_ = false;
+}
+
+void Kernel::refresh_options() {
+  auto now = pf_basic::Clock::wall_seconds();
+  if (now == loop_option_time_) return;
+  loop_option_time_ = now;
+  loop_option_.frametime = 
+    1000 / GLOBALS["default.engine.frame"].get<int32_t>();
+  loop_option_.budget = GLOBALS["default.engine.task_budget"].get<uint32_t>();
+  if (0 == loop_option_.budget) 
+    loop_option_.budget = static_cast<uint32_t>(loop_option_.frametime);
+  loop_option_.metrics = GLOBALS["default.engine.metrics"].get<uint64_t>();
+  loop_option_.snapshot = 
+    GLOBALS["default.cache.snapshot_interval"].get<uint64_t>();
+}
+
+void Kernel::wakeup() {
+  std::unique_lock<std::mutex> lock(wait_mutex_);
+  wait_condition_.notify_one();
 }
@@ -0,0 +1,240 @@
+#include "pf/basic/logger.h"
+#include "pf/basic/clock.h"
+#include "pf/basic/metrics.h"
+#include "pf/engine/kernel.h"
+#include "pf/engine/sampler.h"
+
+namespace pf_engine {
+
+namespace {
+
+//The delta of the increasing counters, 0 if the counter reset.
+uint64_t delta(uint64_t current, uint64_t last) {
+  return current > last ? current - last : 0;
+}
+
+} //namespace
+
+Sampler::Sampler(Kernel *kernel, uint32_t interval, size_t size) :
+  kernel_{kernel},
+  interval_{0 == interval ? 1000 : interval},
+  size_{0 == size ? 1 : size},
+  next_{0},
+  stop_{false},
+  main_threadid_{0},
+  last_time_{0} {
+}
+
+Sampler::~Sampler() {
+  stop();
+  if (thread_.joinable()) thread_.join();
+}
+
+void Sampler::start() {
+  if (thread_.joinable()) return;
+  main_threadid_ = pf_sys::process::get_threadid();
+  stop_ = false;
+  thread_ = std::thread([this]() {
+    for (;;) {
+      sample();
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait_for(lock,
+                          std::chrono::milliseconds(interval_),
+                          [this]() { return stop_.load(); });
+      if (stop_) break;
+    }
+  });
+}
+
+void Sampler::stop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  stop_ = true;
+  condition_.notify_all();
+}
+
+void Sampler::samples(std::vector<sample_t> &samples) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  samples.clear();
+  if (ring_.size() < size_) {
+    samples = ring_;
+    return;
+  }
+  for (size_t i = 0; i < size_; ++i)
+    samples.push_back(ring_[(next_ + i) % size_]);
+}
+
+bool Sampler::last(sample_t &sample) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (ring_.empty()) return false;
+  sample = ring_[(next_ + size_ - 1) % size_];
+  return true;
+}
+
+void Sampler::sample() {
+  using namespace pf_sys::process;
+  using namespace pf_basic;
+  usage_t usage;
+  if (!get_usage(usage)) return;
+  sample_t sample;
+  sample.time = Clock::now_ms();
+  sample.interval = 0 == last_time_ ? 0 : sample.time - last_time_;
+  sample.rss = usage.rss;
+  sample.swap = usage.swap;
+  sample.fds = usage.fds;
+  sample.threads = usage.threads;
+  if (sample.interval > 0) {
+    auto ticks = delta(usage.utime + usage.stime, usage_.utime + usage_.stime);
+    sample.cpu = static_cast<uint32_t>(
+        ticks * 1000 * 100 / (get_clockticks() * sample.interval));
+    auto total = delta(usage.system_total, usage_.system_total);
+    if (total > 0) {
+      sample.steal = static_cast<uint32_t>(
+          delta(usage.system_steal, usage_.system_steal) * 100 / total);
+    }
+    sample.majflt = delta(usage.majflt, usage_.majflt);
+    sample.voluntary_switches =
+      delta(usage.voluntary_switches, usage_.voluntary_switches);
+    sample.involuntary_switches =
+      delta(usage.involuntary_switches, usage_.involuntary_switches);
+  }
+
+  //The engine threads, the exited threads are dropped from the last maps.
+  auto stats = kernel_->get_frame_stats();
+  frame_stat_t main;
+  main.name = "main";
+  main.threadid = main_threadid_;
+  stats.push_back(main);
+  std::map<int32_t, schedstat_t> schedstats;
+  std::map<int32_t, uint64_t> overruns;
+  for (auto &stat : stats) {
+    schedstat_t schedstat;
+    if (0 == stat.threadid || !get_schedstat(stat.threadid, schedstat))
+      continue;
+    thread_sample_t thread_sample;
+    thread_sample.name = stat.name.empty() ?
+      "thread_" + std::to_string(stat.threadid) : stat.name;
+    thread_sample.threadid = stat.threadid;
+    auto last_schedstat = schedstats_.find(stat.threadid);
+    if (last_schedstat != schedstats_.end()) {
+      thread_sample.run =
+        delta(schedstat.run, last_schedstat->second.run) / 1000;
+      thread_sample.delay =
+        delta(schedstat.delay, last_schedstat->second.delay) / 1000;
+    }
+    auto last_overruns = overruns_.find(stat.threadid);
+    if (last_overruns != overruns_.end())
+      thread_sample.overruns = delta(stat.overruns, last_overruns->second);
+    schedstats[stat.threadid] = schedstat;
+    overruns[stat.threadid] = stat.overruns;
+    sample.thread_samples.push_back(thread_sample);
+  }
+  schedstats_.swap(schedstats);
+  overruns_.swap(overruns);
+
+  metrics::gauge("process.cpu_percent").set(sample.cpu);
+  metrics::gauge("process.steal_percent").set(sample.steal);
+  metrics::gauge("process.rss_kb").set(sample.rss);
+  metrics::gauge("process.swap_kb").set(sample.swap);
+  metrics::gauge("process.fds").set(sample.fds);
+  metrics::gauge("process.threads").set(sample.threads);
+  metrics::gauge("process.major_faults").set(sample.majflt);
+  metrics::gauge("process.voluntary_switches").set(sample.voluntary_switches);
+  metrics::gauge("process.involuntary_switches").set(
+      sample.involuntary_switches);
+  for (auto &thread_sample : sample.thread_samples) {
+    auto prefix = "thread." + thread_sample.name;
+    metrics::gauge(prefix + ".run_us").set(thread_sample.run);
+    metrics::gauge(prefix + ".delay_us").set(thread_sample.delay);
+  }
+
+  if (sample.interval > 0) check(sample);
+  usage_ = usage;
+  last_time_ = sample.time;
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (ring_.size() < size_) {
+    ring_.push_back(sample);
+    next_ = ring_.size() % size_;
+  } else {
+    ring_[next_] = sample;
+    next_ = (next_ + 1) % size_;
+  }
+}
+
+void Sampler::check(const sample_t &sample) {
+  uint64_t overruns{0};
+  for (auto &thread_sample : sample.thread_samples)
+    overruns += thread_sample.overruns;
+  //Warn once when crossed, again after it back under the threshold.
+  auto crossed = [this](const std::string &key, bool over) {
+    auto &warned = warned_[key];
+    auto result = over && !warned;
+    warned = over;
+    return result;
+  };
+  if (threshold_.cpu > 0 && crossed("cpu", sample.cpu >= threshold_.cpu)) {
+    SLOW_WARNINGLOG(ENGINE_MODULENAME,
+                    "[%s] (Sampler::check) cpu %u percent over %u,"
+                    " frame overruns: %" PRIu64,
+                    ENGINE_MODULENAME,
+                    sample.cpu,
+                    threshold_.cpu,
+                    overruns);
+  }
+  if (threshold_.steal > 0 &&
+      crossed("steal", sample.steal >= threshold_.steal)) {
+    SLOW_WARNINGLOG(ENGINE_MODULENAME,
+                    "[%s] (Sampler::check) cpu steal %u percent over %u,"
+                    " frame overruns: %" PRIu64,
+                    ENGINE_MODULENAME,
+                    sample.steal,
+                    threshold_.steal,
+                    overruns);
+  }
+  if (threshold_.rss > 0 &&
+      crossed("rss", sample.rss >= threshold_.rss * 1024)) {
+    SLOW_WARNINGLOG(ENGINE_MODULENAME,
+                    "[%s] (Sampler::check) rss %" PRIu64 "KB over %" PRIu64
+                    "MB, swap: %" PRIu64 "KB",
+                    ENGINE_MODULENAME,
+                    sample.rss,
+                    threshold_.rss,
+                    sample.swap);
+  }
+  if (threshold_.fds > 0 && crossed("fds", sample.fds >= threshold_.fds)) {
+    SLOW_WARNINGLOG(ENGINE_MODULENAME,
+                    "[%s] (Sampler::check) fds %" PRIu64 " over %" PRIu64,
+                    ENGINE_MODULENAME,
+                    sample.fds,
+                    threshold_.fds);
+  }
+  if (sample.swap > usage_.swap) {
+    SLOW_WARNINGLOG(ENGINE_MODULENAME,
+                    "[%s] (Sampler::check) swap grow %" PRIu64 "KB -> %"
+                    PRIu64 "KB, major faults: %" PRIu64
+                    ", frame overruns: %" PRIu64,
+                    ENGINE_MODULENAME,
+                    usage_.swap,
+                    sample.swap,
+                    sample.majflt,
+                    overruns);
+  }
+  if (0 == threshold_.delay) return;
+  for (auto &thread_sample : sample.thread_samples) {
+    auto percent = thread_sample.delay / 10 / sample.interval;
+    if (!crossed("delay." + std::to_string(thread_sample.threadid),
+                 percent >= threshold_.delay)) continue;
+    SLOW_WARNINGLOG(ENGINE_MODULENAME,
+                    "[%s] (Sampler::check) thread %s(%d) waited the cpu %"
+                    PRIu64 " percent over %u, run: %" PRIu64 "us,"
+                    " frame overruns: %" PRIu64,
+                    ENGINE_MODULENAME,
+                    thread_sample.name.c_str(),
+                    thread_sample.threadid,
+                    percent,
+                    threshold_.delay,
+                    thread_sample.run,
+                    thread_sample.overruns);
+  }
+}
+
+} //namespace pf_engine
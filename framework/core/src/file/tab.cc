@@ -1,4 +1,5 @@
 #include <map>
+#include <algorithm>
 #include <assert.h>
 #include <exception>
 #include "pf/basic/string.h"
@@ -45,6 +46,7 @@ bool Tab::open_from_memory(const char *memory,
                                 const char *end, 
                                 const char *filename) {
   bool result = true;
+  clear_indexes();
   if (end - memory >= static_cast<int32_t>(sizeof(file_head_t)) && 
       *((uint32_t*)memory) == FILE_DATABASE_INDENTIFY) {
     result = open_from_memory_binary(memory, end, filename);
@@ -60,26 +62,21 @@ const Tab::field_data* Tab::search_index_equal(int32_t index) const {
   return it_find->second;
 }
 
-const char *Tab::get_fieldname(int32_t index) {
+const char *Tab::get_fieldname(int32_t index) const {
   const char *name = nullptr;
   Assert(index >= 0 && index <= field_number_);
   name = fieldnames_[index].c_str();
   return name;
 }
 
-int32_t Tab::get_fieldindex(const char *name) {
-  int32_t result = -1;
-  uint32_t i;
-  for (i = 0; i < fieldnames_.size(); ++i) {
-    if (0 == strcmp(name, fieldnames_[i].c_str())) {
-      result = i;
-      break;
-    }
-  }
-  return result;
+int32_t Tab::get_fieldindex(const char *name) const {
+  if (is_null(name)) return INDEX_INVALID;
+  auto it = fieldindex_map_.find(name);
+  if (it == fieldindex_map_.end()) return INDEX_INVALID;
+  return it->second;
 }
 
-uint8_t Tab::get_fieldtype(int32_t index) {
+uint8_t Tab::get_fieldtype(int32_t index) const {
   Assert(index >= 0 && index <= field_number_);
   uint8_t result = static_cast<uint8_t>(type_[index]);
   return result;
@@ -111,7 +108,15 @@ const Tab::field_data *Tab::search_position(int32_t line,
 const Tab::field_data* Tab::search_first_column_equal(
     int32_t column, 
     const field_data &value) const {
-  if (column < 0 || column > field_number_) return nullptr;
+  if (column < 0 || column >= field_number_) return nullptr;
+  if (column < static_cast<int32_t>(column_index_.size()) &&
+      column_index_[column] != INDEX_INVALID) {
+    record_list records;
+    search_multi(column_index_[column], index_key_t(value), records);
+    if (records.empty()) return nullptr;
+    //The multimap not keep the order, so get the first record of file.
+    return *std::min_element(records.begin(), records.end());
+  }
   field_type_enum type = type_[column];
   register int32_t i;
   for (i = 0; i < record_number_; ++i) {
@@ -147,6 +152,7 @@ int32_t Tab::get_record_number() const {
 void Tab::create_index(int32_t column, const char *filename) {
   if (column < 0 || column > field_number_ || index_column_ == column) return;
   hash_index_.clear();
+  index_column_ = column;
   int32_t i;
   for (i = 0; i < record_number_; ++i) {
     field_data* _field_data = &(data_buffer_[i * field_number_]);
@@ -208,6 +214,234 @@ bool Tab::field_equal(field_type_enum type,
   return result;
 }
 
+bool Tab::field_less(field_type_enum type, 
+                     const field_data &a, 
+                     const field_data &b) {
+  bool result = false;
+  if (kTypeInt == type) {
+    result = a.int_value < b.int_value;
+  } else if (kTypeFloat == type) {
+    result = a.float_value < b.float_value;
+  } else {
+    result = strcmp(a.string_value, b.string_value) < 0;
+  }
+  return result;
+}
+
+size_t Tab::field_hash(field_type_enum type, const field_data &value) {
+  uint64_t result = 14695981039346656037ULL; //FNV-1a
+  if (kTypeString == type) {
+    const unsigned char *str = 
+      reinterpret_cast<const unsigned char *>(value.string_value);
+    if (!is_null(str)) {
+      for (; *str != '\0'; ++str) {
+        result ^= *str;
+        result *= 1099511628211ULL;
+      }
+    }
+  } else {
+    //Float 0.0 and -0.0 are equal then must be the same hash.
+    uint32_t bits = 
+      kTypeFloat == type && 0.0f == value.float_value ? 0 : 
+      static_cast<uint32_t>(value.int_value);
+    for (int32_t i = 0; i < 4; ++i) {
+      result ^= (bits >> (i * 8)) & 0xff;
+      result *= 1099511628211ULL;
+    }
+  }
+  return static_cast<size_t>(result);
+}
+
+size_t Tab::index_hash::operator()(const index_key_t &key) const {
+  size_t result = 0;
+  int32_t count = static_cast<int32_t>(types.size());
+  for (int32_t i = 0; i < key.count && i < count; ++i)
+    result = result * 31 + field_hash(types[i], key.values[i]);
+  return result;
+}
+
+bool Tab::index_equal::operator()(const index_key_t &a, 
+                                  const index_key_t &b) const {
+  if (a.count != b.count || a.count > static_cast<int32_t>(types.size())) 
+    return false;
+  for (int32_t i = 0; i < a.count; ++i) {
+    if (!field_equal(types[i], a.values[i], b.values[i])) return false;
+  }
+  return true;
+}
+
+int32_t Tab::create_index(const char *name, 
+                          const std::vector<int32_t> &columns, 
+                          bool unique) {
+  if (is_null(name) || columns.empty() || 
+      columns.size() > FILE_DATABASE_INDEX_COLUMN_MAX) return INDEX_INVALID;
+  if (get_indexid(name) != INDEX_INVALID) return INDEX_INVALID;
+  std::unique_ptr<index_t> index(new index_t);
+  index_hash hasher;
+  index_equal equal;
+  for (int32_t column : columns) {
+    if (column < 0 || column >= field_number_) return INDEX_INVALID;
+    hasher.types.push_back(type_[column]);
+    equal.types.push_back(type_[column]);
+  }
+  index->columns = columns;
+  index->unique = unique;
+  index->hash.reset(
+      new index_hashmap(record_number_ + 1, hasher, equal));
+  for (int32_t i = 0; i < record_number_; ++i) {
+    const field_data *record = &(data_buffer_[i * field_number_]);
+    index_key_t key = make_key(*index, record);
+    if (unique && index->hash->find(key) != index->hash->end()) {
+      char temp[256];
+      memset(temp, '\0', sizeof(temp));
+      snprintf(temp, 
+               sizeof(temp) - 1, 
+               "pf_file::Tab::create_index(%s) multi index at line: %d", 
+               name, 
+               i + 1);
+#ifdef _PF_THROW_EXCEPTION_AS_STD_STRING
+      throw std::string(temp);
+#else
+      AssertEx(false, temp);
+#endif
+      return INDEX_INVALID;
+    }
+    index->hash->insert(std::make_pair(key, record));
+  }
+  int32_t id = static_cast<int32_t>(indexes_.size());
+  if (1 == columns.size()) {
+    if (static_cast<int32_t>(column_index_.size()) < field_number_)
+      column_index_.resize(field_number_, INDEX_INVALID);
+    if (INDEX_INVALID == column_index_[columns[0]])
+      column_index_[columns[0]] = id;
+  }
+  indexes_.emplace_back(std::move(index));
+  indexname_map_[name] = id;
+  return id;
+}
+
+int32_t Tab::create_sorted_index(const char *name, int32_t column) {
+  if (is_null(name) || column < 0 || column >= field_number_) 
+    return INDEX_INVALID;
+  if (get_indexid(name) != INDEX_INVALID) return INDEX_INVALID;
+  std::unique_ptr<index_t> index(new index_t);
+  index->columns.push_back(column);
+  index->sorted = true;
+  index->sorted_list.reserve(record_number_);
+  for (int32_t i = 0; i < record_number_; ++i) {
+    const field_data *record = &(data_buffer_[i * field_number_]);
+    index->sorted_list.push_back(std::make_pair(record[column], record));
+  }
+  field_type_enum type = type_[column];
+  std::stable_sort(index->sorted_list.begin(), 
+                   index->sorted_list.end(), 
+                   [type](const index_sorted::value_type &a, 
+                          const index_sorted::value_type &b) {
+    return field_less(type, a.first, b.first);
+  });
+  int32_t id = static_cast<int32_t>(indexes_.size());
+  indexes_.emplace_back(std::move(index));
+  indexname_map_[name] = id;
+  return id;
+}
+
+int32_t Tab::get_indexid(const char *name) const {
+  if (is_null(name)) return INDEX_INVALID;
+  auto it = indexname_map_.find(name);
+  if (it == indexname_map_.end()) return INDEX_INVALID;
+  return it->second;
+}
+
+const Tab::field_data *Tab::search_unique(int32_t id, 
+                                          const index_key_t &key) const {
+  const index_t *index = get_index(id);
+  if (is_null(index) || is_null(index->hash) || 
+      key.count != static_cast<int32_t>(index->columns.size())) return nullptr;
+  auto it = index->hash->find(key);
+  if (it == index->hash->end()) return nullptr;
+  return it->second;
+}
+
+int32_t Tab::search_multi(int32_t id, 
+                          const index_key_t &key, 
+                          record_list &records) const {
+  records.clear();
+  const index_t *index = get_index(id);
+  if (is_null(index) || is_null(index->hash) || 
+      key.count != static_cast<int32_t>(index->columns.size())) return 0;
+  auto range = index->hash->equal_range(key);
+  for (auto it = range.first; it != range.second; ++it)
+    records.push_back(it->second);
+  return static_cast<int32_t>(records.size());
+}
+
+int32_t Tab::search_range(int32_t id, 
+                          const field_data &low, 
+                          const field_data &high, 
+                          record_list &records) const {
+  records.clear();
+  const index_t *index = get_index(id);
+  if (is_null(index) || !index->sorted) return 0;
+  field_type_enum type = type_[index->columns[0]];
+  auto it = std::lower_bound(
+      index->sorted_list.begin(), 
+      index->sorted_list.end(), 
+      low, 
+      [type](const index_sorted::value_type &a, const field_data &b) {
+    return field_less(type, a.first, b);
+  });
+  for (; it != index->sorted_list.end(); ++it) {
+    if (field_less(type, high, it->first)) break;
+    records.push_back(it->second);
+  }
+  return static_cast<int32_t>(records.size());
+}
+
+const Tab::field_data *Tab::search_floor(int32_t id, 
+                                         const field_data &value) const {
+  const index_t *index = get_index(id);
+  if (is_null(index) || !index->sorted) return nullptr;
+  field_type_enum type = type_[index->columns[0]];
+  auto it = std::upper_bound(
+      index->sorted_list.begin(), 
+      index->sorted_list.end(), 
+      value, 
+      [type](const field_data &a, const index_sorted::value_type &b) {
+    return field_less(type, a, b.first);
+  });
+  if (it == index->sorted_list.begin()) return nullptr;
+  return (--it)->second;
+}
+
+void Tab::build_fieldindex() {
+  fieldindex_map_.clear();
+  for (size_t i = 0; i < fieldnames_.size(); ++i) {
+    //The same name use the first column like the old linear search.
+    fieldindex_map_.insert(
+        std::make_pair(fieldnames_[i], static_cast<int32_t>(i)));
+  }
+}
+
+void Tab::clear_indexes() {
+  indexes_.clear();
+  indexname_map_.clear();
+  column_index_.clear();
+  hash_index_.clear();
+  index_column_ = INDEX_INVALID;
+}
+
+const Tab::index_t *Tab::get_index(int32_t id) const {
+  if (id < 0 || id >= static_cast<int32_t>(indexes_.size())) return nullptr;
+  return indexes_[id].get();
+}
+
+Tab::index_key_t Tab::make_key(const index_t &index, 
+                               const field_data *record) const {
+  index_key_t key;
+  for (int32_t column : index.columns) key.add(record[column]);
+  return key;
+}
+
 bool Tab::open_from_memory_text(const char *memory, 
                                      const char *end, 
                                      const char *filename) {
@@ -243,6 +477,7 @@ bool Tab::open_from_memory_text(const char *memory,
   _memory = get_line_from_memory(line, sizeof(line) - 1, _memory, end);
   //第二行为列名（相当于数据库的字段名），应尽量使用英文
   string::explode(line, fieldnames_, "\t", true, true);
+  build_fieldindex();
   if (!_memory) return false;
   int32_t string_buffer_size = 0;
   bool loop = true;
@@ -519,9 +754,10 @@ bool Tab::save_totext(const char *filename) {
 }
 
 const Tab::field_data *Tab::get_fielddata(int32_t line, 
-                                                    const char *name) {
+                                          const char *name) const {
   const field_data *_field_data = nullptr;
   int32_t column = get_fieldindex(name);
+  if (INDEX_INVALID == column) return nullptr;
   _field_data = search_position(line, column);
   return _field_data;
 }
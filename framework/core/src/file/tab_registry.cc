@@ -0,0 +1,222 @@
+#include "pf/basic/logger.h"
+#include "pf/sys/thread.h"
+#include "pf/file/tab_registry.h"
+#if OS_UNIX
+#include <dirent.h>
+#endif
+#include <sys/stat.h>
+
+namespace pf_file {
+
+namespace {
+
+//Decrease the pending count when the task end(the load may throw).
+//Notify under the lock, the registry may be destroyed right after it.
+struct pending_guard_t {
+  std::atomic<int32_t> &pending;
+  std::mutex &mutex;
+  std::condition_variable &condition;
+  pending_guard_t(std::atomic<int32_t> &_pending,
+                  std::mutex &_mutex,
+                  std::condition_variable &_condition) : 
+    pending(_pending), mutex(_mutex), condition(_condition) {}
+  ~pending_guard_t() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (0 == --pending) condition.notify_all();
+  }
+};
+
+} //namespace
+
+TabRegistry::TabRegistry(pf_sys::ThreadPool *pool) :
+  slots_{std::make_shared<const slot_map_t>()},
+  pool_{pool},
+  prepare_{nullptr},
+  tab_id_{0},
+  pending_{0} {
+  if (is_null(pool_)) {
+    auto count = std::thread::hardware_concurrency();
+    auto _pool = new pf_sys::ThreadPool(0 == count ? 2 : count);
+    unique_move(pf_sys::ThreadPool, _pool, own_pool_);
+    pool_ = own_pool_.get();
+  }
+}
+
+TabRegistry::~TabRegistry() {
+  //The tasks in a shared pool may still reference this.
+  std::unique_lock<std::mutex> lock(pending_mutex_);
+  pending_condition_.wait(lock, [this]() { return 0 == pending_; });
+  lock.unlock();
+  own_pool_.reset();
+}
+
+bool TabRegistry::load_directory(const std::string &path,
+                                 const std::string &suffix) {
+  std::vector< std::pair<std::string, std::string> > files;
+#if OS_UNIX
+  DIR *dir = opendir(path.c_str());
+  if (is_null(dir)) {
+    SLOW_ERRORLOG("file",
+                  "[file] TabRegistry::load_directory open %s failed",
+                  path.c_str());
+    return false;
+  }
+  struct dirent *entry = nullptr;
+  while (!is_null(entry = readdir(dir))) {
+    std::string filename{entry->d_name};
+    if (filename.size() <= suffix.size() ||
+        filename.compare(filename.size() - suffix.size(),
+                         suffix.size(),
+                         suffix) != 0) continue;
+    std::string name = filename.substr(0, filename.size() - suffix.size());
+    files.push_back(std::make_pair(name, path + "/" + filename));
+  }
+  closedir(dir);
+#elif OS_WIN
+  WIN32_FIND_DATAA data;
+  std::string pattern = path + "\\*" + suffix;
+  HANDLE handle = FindFirstFileA(pattern.c_str(), &data);
+  if (INVALID_HANDLE_VALUE == handle) return false;
+  do {
+    std::string filename{data.cFileName};
+    std::string name = filename.substr(0, filename.size() - suffix.size());
+    files.push_back(std::make_pair(name, path + "\\" + filename));
+  } while (FindNextFileA(handle, &data));
+  FindClose(handle);
+#endif
+  return load(files, true);
+}
+
+bool TabRegistry::load(
+    const std::vector< std::pair<std::string, std::string> > &files,
+    bool wait) {
+  std::vector< std::future<bool> > results;
+  auto prepare = get_prepare();
+  for (auto &file : files) {
+    auto slot = add_slot(file.first, file.second);
+    auto generation = ++slot->generation;
+    ++pending_;
+    results.emplace_back(
+        pool_->enqueue([this, file, slot, generation, prepare]() {
+      pending_guard_t guard(pending_, pending_mutex_, pending_condition_);
+      return load_slot(file.first, slot, generation, prepare);
+    }));
+  }
+  if (!wait) return true;
+  bool result = true;
+  for (auto &ret : results) result = ret.get() && result;
+  return result;
+}
+
+bool TabRegistry::reload(const std::string &name, bool wait) {
+  auto slot = get_slot(name);
+  if (is_null(slot)) return false;
+  auto prepare = get_prepare();
+  auto generation = ++slot->generation;
+  ++pending_;
+  auto result = pool_->enqueue([this, name, slot, generation, prepare]() {
+    pending_guard_t guard(pending_, pending_mutex_, pending_condition_);
+    return load_slot(name, slot, generation, prepare);
+  });
+  return wait ? result.get() : true;
+}
+
+int32_t TabRegistry::reload_modified(bool wait) {
+  auto slots = std::atomic_load(&slots_);
+  std::vector< std::pair<std::string, std::string> > files;
+  for (auto &it : *slots) {
+    auto modified = get_modified(it.second->filename);
+    //The missing file is kept as it loaded, retry when it comes back.
+    if (modified != -1 && modified != it.second->modified)
+      files.push_back(std::make_pair(it.first, it.second->filename));
+  }
+  if (!files.empty()) load(files, wait);
+  return static_cast<int32_t>(files.size());
+}
+
+TabRegistry::snapshot_t TabRegistry::get(const std::string &name) const {
+  auto slot = get_slot(name);
+  if (is_null(slot)) return nullptr;
+  return std::atomic_load(&slot->tab);
+}
+
+uint32_t TabRegistry::get_version(const std::string &name) const {
+  auto slot = get_slot(name);
+  return is_null(slot) ? 0 : slot->version.load();
+}
+
+bool TabRegistry::has(const std::string &name) const {
+  return !is_null(get(name));
+}
+
+void TabRegistry::set_prepare(prepare_t prepare) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  prepare_ = prepare;
+}
+
+TabRegistry::prepare_t TabRegistry::get_prepare() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return prepare_;
+}
+
+std::shared_ptr<TabRegistry::slot_t> TabRegistry::get_slot(
+    const std::string &name) const {
+  auto slots = std::atomic_load(&slots_);
+  auto it = slots->find(name);
+  if (it == slots->end()) return nullptr;
+  return it->second;
+}
+
+std::shared_ptr<TabRegistry::slot_t> TabRegistry::add_slot(
+    const std::string &name, const std::string &filename) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto slots = std::atomic_load(&slots_);
+  auto it = slots->find(name);
+  if (it != slots->end() && it->second->filename == filename)
+    return it->second;
+  auto slot = std::make_shared<slot_t>();
+  slot->filename = filename;
+  if (it != slots->end()) {
+    //The file changed, keep the old table until the new one loaded.
+    slot->tab = std::atomic_load(&it->second->tab);
+    slot->version = it->second->version.load();
+  }
+  std::shared_ptr<slot_map_t> _slots = std::make_shared<slot_map_t>(*slots);
+  (*_slots)[name] = slot;
+  std::atomic_store(&slots_, std::shared_ptr<const slot_map_t>(_slots));
+  return slot;
+}
+
+bool TabRegistry::load_slot(const std::string &name,
+                            std::shared_ptr<slot_t> slot,
+                            uint64_t generation,
+                            const prepare_t &prepare) {
+  auto modified = get_modified(slot->filename);
+  std::shared_ptr<Tab> tab = std::make_shared<Tab>(++tab_id_);
+  if (!tab->open_from_txt(slot->filename.c_str())) {
+    std::unique_lock<std::mutex> lock(slot->mutex);
+    //Not retry until the file changed again.
+    if (generation > slot->published) slot->modified = modified;
+    SLOW_ERRORLOG("file",
+                  "[file] TabRegistry::load_slot %s(%s) failed",
+                  name.c_str(),
+                  slot->filename.c_str());
+    return false;
+  }
+  if (prepare) prepare(name, *tab);
+  std::unique_lock<std::mutex> lock(slot->mutex);
+  if (generation < slot->published) return true; //A newer one published.
+  slot->published = generation;
+  std::atomic_store(&slot->tab, snapshot_t(tab));
+  slot->modified = modified;
+  ++slot->version;
+  return true;
+}
+
+int64_t TabRegistry::get_modified(const std::string &filename) {
+  struct stat info;
+  if (stat(filename.c_str(), &info) != 0) return -1;
+  return static_cast<int64_t>(info.st_mtime);
+}
+
+} //namespace pf_file
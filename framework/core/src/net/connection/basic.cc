@@ -10,6 +10,8 @@ namespace connection {
 Basic::Basic() : 
   id_{ID_INVALID},
   managerid_{ID_INVALID},
+  manager_{nullptr},
+  generation_{0},
   socket_{nullptr},
   istream_{nullptr},
   istream_compress_{nullptr},
@@ -25,7 +27,8 @@ Basic::Basic() :
   send_bytes_{0},
   packet_index_{0},
   execute_count_pretick_{NET_CONNECTION_EXECUTE_COUNT_PRE_TICK_DEFAULT},
-  status_{0} {
+  status_{0},
+  handshake_{false} {
   //do nothing
 }
 
@@ -103,6 +106,13 @@ bool Basic::process_input() {
   return result;
 }
 
+bool Basic::input_pending() const {
+  if (is_null(istream_)) return false;
+  if (istream_->getcompressor()->getassistant()->isenable())
+    return !is_null(istream_compress_) && istream_compress_->pending();
+  return istream_->pending();
+}
+
 void Basic::process_input_compress() {
   protocol_->compress(this, uncompress_buffer_, compress_buffer_);
 }
@@ -162,10 +172,14 @@ bool Basic::is_valid() {
 void Basic::clear() {
   if (socket_) socket_->close();
   if (istream_) istream_->clear();
+  if (istream_compress_) istream_compress_->clear();
   if (ostream_) ostream_->clear();
   set_managerid(ID_INVALID);
+  set_manager(nullptr);
+  ++generation_;
   packet_index_ = 0;
   status_ = 0;
+  handshake_ = false;
   execute_count_pretick_ = NET_CONNECTION_EXECUTE_COUNT_PRE_TICK_DEFAULT;
   set_disconnect(true);
   set_empty(true);
@@ -210,12 +224,45 @@ void Basic::compress_set_mode(compress_mode_t mode) {
             NETINPUT_BUFFERSIZE_DEFAULT,
             64 * 1024 * 1024));
       istream_compress_ = std::move(_istream_compress);
+      istream_compress_->init();
     }
   }
   assistant = ostream_->getcompressor()->getassistant();
   assistant->enable(outputstream_compress_enable);
 }
 
+uint32_t Basic::compress_codecs() const {
+  return pf_util::compressor::codec::mask();
+}
+
+uint8_t Basic::compress_negotiate(uint32_t remote_codecs) {
+  uint8_t codec = 
+    pf_util::compressor::codec::negotiate(compress_codecs(), remote_codecs);
+  if (pf_util::compressor::kCodecNone == codec) {
+    compress_set_mode(kCompressModeNone);
+    return codec;
+  }
+  compress_set_codec(codec);
+  return codec;
+}
+
+bool Basic::compress_set_codec(uint8_t codec) {
+  if (!istream_->getcompressor()->set_codec(codec)) return false;
+  return ostream_->getcompressor()->set_codec(codec);
+}
+
+uint8_t Basic::compress_get_codec() const {
+  return ostream_->getcompressor()->get_codec();
+}
+
+void Basic::compress_adaptive_enable(bool enable) {
+  ostream_->getcompressor()->getassistant()->adaptive_enable(enable);
+}
+
+pf_util::compressor::Assistant::stat_t Basic::compress_stat() const {
+  return ostream_->getcompressor()->getassistant()->get_stat();
+}
+
 void Basic::encrypt_enable(bool enable) {
   istream_->encryptenable(enable);
   ostream_->encryptenable(enable);
@@ -1,36 +1,31 @@
 #include "pf/basic/time_manager.h"
+#include "pf/basic/metrics.h"
 #include "pf/sys/assert.h"
 #include "pf/net/connection/manager/basic.h"
 
 using namespace pf_net::connection::manager;
 
+//The timeouts and the connection heartbeats are in the timer wheel, only the
+//expired connections visited.
 bool Basic::heartbeat(uint32_t time) {
-  using namespace pf_net;
   auto _time = 0 == time ? TIME_MANAGER_POINTER->get_tickcount() : time;
-  auto _size = size();
-  for (decltype(_size)i = 0; i < _size; ++i) {
-    if (ID_INVALID == connection_idset_[i]) continue;
-    connection::Basic* connection = nullptr;
-    connection = pool_->get(connection_idset_[i]);
-    if (nullptr == connection) {
-      Assert(false);
-      return false;
-    }
-    if (!connection->heartbeat(_time)) {
-      remove(connection);
-      Assert(false);
-    }
-  }
-  return true;
+  return Interface::heartbeat(_time);
 }
 
 void Basic::tick() {
+  using namespace pf_basic;
+  static auto &wait_time = metrics::histogram("net.poll_wait_us");
+  static auto &handle_time = metrics::histogram("net.poll_handle_us");
   bool result = false;
   //normal.
   try {
-    result = select();
+    {
+      metrics::ScopedTimer timer(wait_time);
+      result = select();
+    }
     Assert(result);
 
+    metrics::ScopedTimer timer(handle_time);
     result = process_exception();
     Assert(result);
 
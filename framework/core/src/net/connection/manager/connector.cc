@@ -1,13 +1,45 @@
+#include <algorithm>
 #include "pf/basic/logger.h"
+#include "pf/basic/time_manager.h"
 #include "pf/sys/assert.h"
 #include "pf/net/connection/manager/connector.h"
+#if OS_UNIX
+#include <poll.h>
+#endif
 
 using namespace pf_net::connection::manager;
 
+Connector::Connector() :
+  connect_timeout_{NET_CONNECTOR_CONNECT_TIMEOUT},
+  backoff_min_{NET_CONNECTOR_BACKOFF_MIN},
+  backoff_max_{NET_CONNECTOR_BACKOFF_MAX},
+  callback_ready_{nullptr} {
+  //do nothing
+}
+
 bool Connector::init(uint16_t _max_size) {
   return Basic::init(_max_size);
 }
 
+void Connector::tick() {
+  Basic::tick();
+  if (links_.empty()) return;
+  uint32_t _now = now();
+  link_poll();
+  for (size_t i = 0; i < links_.size(); ++i) {
+    link_t &_link = links_[i];
+    if (0 == _link.port) continue; //Free.
+    auto id = static_cast<int32_t>(i);
+    if (kConnectStateConnecting == _link.state) {
+      if (static_cast<int32_t>(_now - _link.deadline) >= 0)
+        link_failed(id, _now, "timeout");
+    } else if (kConnectStateNone == _link.state &&
+               static_cast<int32_t>(_now - _link.retry_time) >= 0) {
+      link_connect(id, _now);
+    }
+  }
+}
+
 pf_net::connection::Basic *Connector::connect(const char *ip, uint16_t port) {
   if (!checkpool()) return nullptr;
   pf_net::connection::Basic *connection = pool_->create();
@@ -100,8 +132,8 @@ Connector::group_connect(const char *ip, uint16_t port) {
       step = 3;
       struct timeval tm;
       fd_set readset, writeset;
-      tm.tv_sec = 10;
-      tm.tv_usec = 0;
+      tm.tv_sec = connect_timeout_ / 1000;
+      tm.tv_usec = (connect_timeout_ % 1000) * 1000;
       FD_ZERO(&readset);
       FD_SET(socket->get_id(), &readset);
       writeset = readset;
@@ -118,7 +150,7 @@ Connector::group_connect(const char *ip, uint16_t port) {
           FD_ISSET(socket->get_id(), &writeset)) {
         uint32_t length = sizeof(_result);
         if (!pf_net::socket::api::getsockopt_exb(
-              socket->get_id(), SOL_SOCKET, SO_ERROR, &result, &length)) {
+              socket->get_id(), SOL_SOCKET, SO_ERROR, &_result, &length)) {
           step = 5;
           goto EXCEPTION;
         }
@@ -171,3 +203,309 @@ EXCEPTION:
   }
   return nullptr;
 }
+
+int32_t Connector::link(const char *ip, 
+                        uint16_t port, 
+                        const std::string &group, 
+                        bool reconnect) {
+  if (is_null(ip) || 0 == port) return -1;
+  int32_t id = -1;
+  for (size_t i = 0; i < links_.size(); ++i) {
+    if (0 == links_[i].port) {
+      id = static_cast<int32_t>(i);
+      break;
+    }
+  }
+  if (-1 == id) {
+    id = static_cast<int32_t>(links_.size());
+    links_.push_back(link_t());
+  }
+  link_t &_link = links_[id];
+  _link = link_t();
+  _link.ip = ip;
+  _link.port = port;
+  _link.group = group;
+  _link.reconnect = reconnect;
+  groups_[group].push_back(id);
+  link_connect(id, now());
+  return id;
+}
+
+void Connector::unlink(int32_t id) {
+  if (id < 0 || id >= static_cast<int32_t>(links_.size())) return;
+  link_t &_link = links_[id];
+  if (0 == _link.port) return;
+  _link.reconnect = false;
+  if (kConnectStateReady == _link.state) {
+    connection::Basic *connection = get(_link.connection_id);
+    if (!is_null(connection)) remove(connection); //Reset the link.
+  } else if (kConnectStateConnecting == _link.state) {
+    link_failed(id, now(), "unlink");
+  }
+  if (_link.port != 0) link_free(id);
+}
+
+const Connector::link_t *Connector::get_link(int32_t id) const {
+  if (id < 0 || id >= static_cast<int32_t>(links_.size())) return nullptr;
+  return 0 == links_[id].port ? nullptr : &links_[id];
+}
+
+pf_net::connection::Basic *Connector::link_connection(int32_t id) {
+  const link_t *_link = get_link(id);
+  if (is_null(_link) || _link->state != kConnectStateReady) return nullptr;
+  return get(_link->connection_id);
+}
+
+pf_net::connection::Basic *Connector::group_select(const std::string &group, 
+                                                   int8_t type,
+                                                   uint64_t key) {
+  auto it = groups_.find(group);
+  if (it == groups_.end() || it->second.empty()) return nullptr;
+  const std::vector<int32_t> &ids = it->second;
+  if (kGroupSelectHash == type) {
+    //Probe from the hash position, so the key moves only when link lost.
+    size_t count = ids.size();
+    for (size_t i = 0; i < count; ++i) {
+      auto connection = link_connection(ids[(key + i) % count]);
+      if (!is_null(connection)) return connection;
+    }
+    return nullptr;
+  }
+  connection::Basic *result = nullptr;
+  size_t load = 0;
+  for (int32_t id : ids) {
+    auto connection = link_connection(id);
+    if (is_null(connection)) continue;
+    size_t _load = connection->ostream().size();
+    if (is_null(result) || _load < load) {
+      result = connection;
+      load = _load;
+    }
+  }
+  return result;
+}
+
+uint16_t Connector::group_ready(const std::string &group) const {
+  auto it = groups_.find(group);
+  if (it == groups_.end()) return 0;
+  uint16_t result = 0;
+  for (int32_t id : it->second) {
+    if (kConnectStateReady == links_[id].state) ++result;
+  }
+  return result;
+}
+
+bool Connector::connecting_event(int16_t connection_id, bool error) {
+  int32_t id = link_of(connection_id);
+  if (-1 == id || links_[id].state != kConnectStateConnecting) return false;
+  connection::Basic *connection = get(connection_id);
+  if (is_null(connection)) return false;
+  //The writable only means the connect finished, the result in SO_ERROR.
+  if (error || connection->socket()->check_error()) {
+    link_failed(id, now(), "refused");
+  } else {
+    link_ready(id);
+  }
+  return true;
+}
+
+bool Connector::remove(int16_t id) {
+  bool result = Basic::remove(id);
+  int32_t _link_id = link_of(id);
+  if (_link_id != -1 && kConnectStateReady == links_[_link_id].state) {
+    link_t &_link = links_[_link_id];
+    connection_links_[id] = -1;
+    _link.state = kConnectStateNone;
+    _link.connection_id = ID_INVALID;
+    _link.backoff = 0;
+    _link.retry_time = now() + backoff_min_; //Let the peer restart.
+    SLOW_WARNINGLOG(NET_MODULENAME,
+                    "[net.connection.manager] (Connector::remove) link lost!"
+                    " ip: %s, port: %d, group: %s",
+                    _link.ip.c_str(),
+                    _link.port,
+                    _link.group.c_str());
+    if (!_link.reconnect) link_free(_link_id);
+  }
+  return result;
+}
+
+void Connector::link_connect(int32_t id, uint32_t _now) {
+  link_t &_link = links_[id];
+  if (!checkpool(false)) {
+    link_failed(id, _now, "pool");
+    return;
+  }
+  connection::Basic *connection = pool_->create();
+  if (is_null(connection)) {
+    link_failed(id, _now, "pool full");
+    return;
+  }
+  _link.state = kConnectStateConnecting;
+  _link.connection_id = connection->get_id();
+  _link.deadline = _now + connect_timeout_;
+  _link.registered = false;
+  if (connection->get_id() >= static_cast<int16_t>(connection_links_.size()))
+    connection_links_.resize(connection->get_id() + 1, -1);
+  connection_links_[connection->get_id()] = id;
+  if (!connection->init(protocol())) {
+    link_failed(id, _now, "init");
+    return;
+  }
+  socket::Basic *socket = connection->socket();
+  if (!socket->create() || 
+      !socket->set_nonblocking() || 
+      !socket->set_linger(0)) {
+    link_failed(id, _now, "socket");
+    return;
+  }
+  if (socket->connect(_link.ip.c_str(), _link.port)) {
+    link_ready(id); //The local connect may finish at once.
+    return;
+  }
+  auto code = static_cast<int32_t>(socket->get_last_error_code());
+  if (code != EINPROGRESS && code != EWOULDBLOCK) {
+    link_failed(id, _now, "connect");
+    return;
+  }
+  //Not registered then check it in the tick.
+  _link.registered = 
+    socket_add_connecting(socket->get_id(), connection->get_id());
+}
+
+void Connector::link_ready(int32_t id) {
+  link_t &_link = links_[id];
+  connection::Basic *connection = get(_link.connection_id);
+  Assert(connection);
+  if (_link.registered) socket_remove(connection->socket()->get_id());
+  _link.registered = false;
+  _link.state = kConnectStateReady; //Before add, the callbacks can use it.
+  if (!add(connection)) {
+    links_[id].state = kConnectStateConnecting;
+    link_failed(id, now(), "add");
+    return;
+  }
+  link_t &_ready = links_[id]; //The callback may add links.
+  _ready.attempts = 0;
+  _ready.backoff = 0;
+  SLOW_LOG(NET_MODULENAME,
+           "[net.connection.manager] (Connector::link_ready) success!"
+           " ip: %s, port: %d, group: %s",
+           _ready.ip.c_str(),
+           _ready.port,
+           _ready.group.c_str());
+  if (!is_null(callback_ready_)) callback_ready_(connection, id);
+}
+
+void Connector::link_failed(int32_t id, uint32_t _now, const char *reason) {
+  link_t &_link = links_[id];
+  if (kConnectStateConnecting == _link.state) {
+    connection::Basic *connection = get(_link.connection_id);
+    if (!is_null(connection)) {
+      if (_link.registered) socket_remove(connection->socket()->get_id());
+      connection_links_[_link.connection_id] = -1;
+      pool_->remove(_link.connection_id); //Close the socket.
+    }
+  }
+  _link.state = kConnectStateNone;
+  _link.connection_id = ID_INVALID;
+  _link.registered = false;
+  ++_link.attempts;
+  //Exponential backoff, the restarting peer not flooded.
+  _link.backoff = 0 == _link.backoff ? backoff_min_ : _link.backoff * 2;
+  if (_link.backoff > backoff_max_) _link.backoff = backoff_max_;
+  _link.retry_time = _now + _link.backoff;
+  static uint32_t checktime{0};
+  if (0 == checktime || _now - checktime >= 1000 || 1 == _link.attempts) {
+    SLOW_WARNINGLOG(NET_MODULENAME,
+                    "[net.connection.manager] (Connector::link_failed)"
+                    " ip: %s, port: %d, reason: %s, attempts: %d, retry: %d",
+                    _link.ip.c_str(),
+                    _link.port,
+                    reason,
+                    _link.attempts,
+                    _link.reconnect ? _link.backoff : -1);
+    checktime = _now;
+  }
+  if (!_link.reconnect) link_free(id);
+}
+
+void Connector::link_free(int32_t id) {
+  link_t &_link = links_[id];
+  auto it = groups_.find(_link.group);
+  if (it != groups_.end()) {
+    auto &ids = it->second;
+    ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+    if (ids.empty()) groups_.erase(it);
+  }
+  _link = link_t();
+}
+
+//The poll set not support connecting socket(select), check them here.
+void Connector::link_poll() {
+#if OS_UNIX
+  //poll() has no limit of the fd value as the fd_set(FD_SETSIZE).
+  std::vector<struct pollfd> fds;
+  std::vector<int16_t> connection_ids;
+  for (const link_t &_link : links_) {
+    if (kConnectStateConnecting != _link.state || _link.registered) continue;
+    connection::Basic *connection = get(_link.connection_id);
+    if (is_null(connection)) continue;
+    struct pollfd fd;
+    fd.fd = connection->socket()->get_id();
+    fd.events = POLLOUT;
+    fd.revents = 0;
+    fds.push_back(fd);
+    connection_ids.push_back(_link.connection_id);
+  }
+  if (fds.empty()) return;
+  if (::poll(&fds[0], static_cast<nfds_t>(fds.size()), 0) <= 0) return;
+  for (size_t i = 0; i < fds.size(); ++i) {
+    bool error = (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) != 0;
+    if (error || (fds[i].revents & POLLOUT))
+      connecting_event(connection_ids[i], error);
+  }
+#else
+  fd_set writeset, exceptset;
+  FD_ZERO(&writeset);
+  FD_ZERO(&exceptset);
+  int32_t maxfd = SOCKET_INVALID;
+  uint32_t count{0};
+  for (const link_t &_link : links_) {
+    if (kConnectStateConnecting != _link.state || _link.registered) continue;
+    connection::Basic *connection = get(_link.connection_id);
+    if (is_null(connection)) continue;
+    if (count >= FD_SETSIZE) break; //The rest checked at the next tick.
+    int32_t fd = connection->socket()->get_id();
+    FD_SET(fd, &writeset);
+    FD_SET(fd, &exceptset);
+    if (fd > maxfd) maxfd = fd;
+    ++count;
+  }
+  if (SOCKET_INVALID == maxfd) return;
+  timeval timeout{0, 0};
+  if (socket::Basic::select(
+        maxfd + 1, nullptr, &writeset, &exceptset, &timeout) <= 0) return;
+  for (size_t i = 0; i < links_.size(); ++i) {
+    link_t &_link = links_[i];
+    if (kConnectStateConnecting != _link.state || _link.registered) continue;
+    connection::Basic *connection = get(_link.connection_id);
+    if (is_null(connection)) continue;
+    int32_t fd = connection->socket()->get_id();
+    bool error = FD_ISSET(fd, &exceptset) != 0;
+    if (error || FD_ISSET(fd, &writeset))
+      connecting_event(_link.connection_id, error);
+  }
+#endif
+}
+
+int32_t Connector::link_of(int16_t connection_id) const {
+  if (connection_id < 0 || 
+      connection_id >= static_cast<int16_t>(connection_links_.size())) 
+    return -1;
+  return connection_links_[connection_id];
+}
+
+uint32_t Connector::now() const {
+  return TIME_MANAGER_POINTER ? TIME_MANAGER_POINTER->get_tickcount() : now_;
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "pf/basic/logger.h"
 #include "pf/basic/util.h"
 #include "pf/net/connection/manager/epoll.h"
@@ -67,7 +68,10 @@ bool Epoll::socket_add(int32_t socket_id, int16_t connection_id) {
     return false;
   }
   Assert(SOCKET_INVALID != socket_id);
-  if (poll_add(polldata_, socket_id, EPOLLIN | EPOLLET, connection_id) != 0) {
+  if (poll_add(polldata_, 
+               socket_id, 
+               EPOLLIN | EPOLLET | EPOLLRDHUP, 
+               connection_id) != 0) {
     SLOW_ERRORLOG(NET_MODULENAME, 
                   "[net.connection.manager] (Epoll::socket_add)"
                   " error, message: %s", 
@@ -78,6 +82,20 @@ bool Epoll::socket_add(int32_t socket_id, int16_t connection_id) {
   return true;
 }
 
+bool Epoll::socket_add_connecting(int32_t socket_id, int16_t connection_id) {
+  if (fdsize_ > polldata_.maxcount) return false;
+  Assert(SOCKET_INVALID != socket_id);
+  if (poll_add(polldata_, socket_id, EPOLLOUT, connection_id) != 0) {
+    SLOW_ERRORLOG(NET_MODULENAME, 
+                  "[net.connection.manager] (Epoll::socket_add_connecting)"
+                  " error, message: %s", 
+                  strerror(errno));
+    return false;
+  }
+  ++fdsize_;
+  return true;
+}
+
 bool Epoll::socket_remove(int32_t socket_id) {
   if (SOCKET_INVALID == socket_id) {
     SLOW_ERRORLOG(NET_MODULENAME,
@@ -106,19 +124,36 @@ bool Epoll::socket_remove(int32_t socket_id) {
 bool Epoll::process_input() {
   using namespace pf_basic;
   uint16_t i;
-  uint16_t accept_count{0};
+  //No new edge for the data left at last tick(the budget or buffer full).
+  if (!pending_input_.empty()) {
+    std::vector<int16_t> pending;
+    pending.swap(pending_input_);
+    for (int16_t connection_id : pending) {
+      connection::Basic *connection = get(connection_id);
+      if (is_null(connection) || connection->is_disconnect()) continue;
+      connection_input(connection);
+    }
+  }
   for (i = 0; i < polldata_.result_eventcount; ++i) {
     //接受新连接的时候至少尝试两次，所以连接池里会多创建一个
     int32_t socket_id = static_cast<int32_t>(
         util::get_highsection(polldata_.events[i].data.u64));
     int16_t connection_id = static_cast<int16_t>(
         util::get_lowsection(polldata_.events[i].data.u64));
-    if (socket_id != SOCKET_INVALID && 
-        socket_id == listener_socket_id() && 
-        accept_count < onestep_accept_ ) {
-      accept();
-      ++accept_count;
-    } else if (polldata_.events[i].events & EPOLLIN) {
+    uint32_t events = polldata_.events[i].events;
+    if (socket_id != SOCKET_INVALID && socket_id == listener_socket_id()) {
+      //Drain the backlog in one event, until EAGAIN or the step limit.
+      for (int32_t count = 0; 
+           onestep_accept_ < 0 || count < onestep_accept_; 
+           ++count) {
+        if (is_null(accept())) break;
+      }
+    } else if (connecting_event(
+                 connection_id, (events & (EPOLLERR | EPOLLHUP)) != 0)) {
+      //Any event of a connecting socket, the failed connect may report the
+      //error without the writable, it is not in the pool yet.
+      continue;
+    } else if (events & (EPOLLIN | EPOLLERR | EPOLLHUP | EPOLLRDHUP)) {
       connection::Basic *connection = nullptr;
       if (ID_INVALID == connection_id) {
         SLOW_WARNINGLOG(NET_MODULENAME, 
@@ -142,27 +177,40 @@ bool Epoll::process_input() {
                       connection_id);
         return false;
       }
-      if (connection->socket()->error()) {
-        pf_basic::io_cerr("connection->socket()->error()");
-        remove(connection);
-      } else {
-        try {
-          if (!connection->process_input()) { 
-            pf_basic::io_cerr("!connection->process_input()");
-            remove(connection);
-          } else {
-            receive_bytes_ += connection->get_receive_bytes();
-          }
-        } catch(...) {
-          pf_basic::io_cerr("connection catch");
-          remove(connection);
-        }
-      }
+      //Only query the kernel when the event say the socket has error.
+      if (events & (EPOLLERR | EPOLLHUP)) connection->socket()->check_error();
+      connection_input(connection);
     } //handle the epoll input event
   }
   return true;
 }
 
+void Epoll::connection_input(connection::Basic *connection) {
+  if (connection->socket()->error()) {
+    pf_basic::io_cerr("connection->socket()->error()");
+    remove(connection);
+    return;
+  }
+  try {
+    if (!connection->process_input()) { 
+      pf_basic::io_cerr("!connection->process_input()");
+      remove(connection);
+    } else {
+      uint32_t receive_bytes = connection->get_receive_bytes();
+      receive_bytes_ += receive_bytes;
+      if (receive_bytes > 0) timeout_receive(connection);
+      if (connection->input_pending() &&
+          std::find(pending_input_.begin(), 
+                    pending_input_.end(), 
+                    connection->get_id()) == pending_input_.end())
+        pending_input_.push_back(connection->get_id());
+    }
+  } catch(...) {
+    pf_basic::io_cerr("connection catch");
+    remove(connection);
+  }
+}
+
 bool Epoll::process_output() {
   uint16_t i;
   uint16_t _size = size();
@@ -172,10 +220,6 @@ bool Epoll::process_output() {
     connection = pool_->get(connection_idset_[i]);
     Assert(connection);
     if (connection->socket()->error()) {
-      char msg[1024]{0};
-      connection->socket()->get_last_error_message(msg, sizeof(msg) - 1);
-      pf_basic::io_cerr("msg: %s", msg);
-      throw 1;
       pf_basic::io_cerr("connection->socket()->error() 1");
       remove(connection);
     } else {
@@ -184,7 +228,10 @@ bool Epoll::process_output() {
           pf_basic::io_cerr("!connection->process_output()");
           remove(connection);
         } else {
-          send_bytes_ += connection->get_send_bytes();
+          uint32_t send_bytes = connection->get_send_bytes();
+          send_bytes_ += send_bytes;
+          timeout_write(
+              connection, 0 == send_bytes && !connection->ostream().empty());
         }
       } catch(...) {
         remove(connection);
@@ -1,4 +1,5 @@
 #include "pf/basic/logger.h"
+#include "pf/basic/time_manager.h"
 #include "pf/sys/thread.h"
 #include "pf/net/packet/factorymanager.h"
 #include "pf/net/connection/manager/interface.h"
@@ -21,7 +22,13 @@ Interface::Interface() :
   onestep_accept_{NET_ONESTEP_ACCEPT_DEFAULT},
   pool_{nullptr},
   callback_disconnect_{nullptr},
-  callback_connect_{nullptr} {
+  callback_connect_{nullptr},
+  callback_kick_{nullptr},
+  kicktime_{NET_CONNECTION_KICKTIME},
+  income_kicktime_{NET_CONNECTION_INCOME_KICKTIME},
+  write_kicktime_{NET_CONNECTION_WRITE_KICKTIME},
+  heartbeat_interval_{NET_CONNECTION_HEARTBEAT_INTERVAL},
+  now_{0} {
 }
 
 Interface::~Interface() {
@@ -51,6 +58,9 @@ bool Interface::init(uint16_t maxcount) {
   if (is_null(NET_PACKET_FACTORYMANAGER_POINTER)) return false;
   if (!NET_PACKET_FACTORYMANAGER_POINTER->init()) return false;
   if (!pool_init(maxcount)) return false;
+  now_ = TIME_MANAGER_POINTER ? TIME_MANAGER_POINTER->get_tickcount() : 0;
+  if (!timer_wheel_.init(static_cast<uint16_t>(pool_->get_max_size()), now_))
+    return false;
   ready_ = true;
   return true;
 }
@@ -73,11 +83,116 @@ void Interface::pool_set(connection::Pool *pool) {
   pool_ = std::move(pointer);
 }
 
-bool Interface::heartbeat(uint32_t) {
+bool Interface::heartbeat(uint32_t time) {
   bool result = true;
+  if (0 == time && TIME_MANAGER_POINTER) 
+    time = TIME_MANAGER_POINTER->get_tickcount();
+  now_ = time;
+  timeout_expire(now_);
   return result;
 }
 
+void Interface::timeout_add(connection::Basic *connection, uint32_t now) {
+  int16_t id = connection->get_id();
+  if (id < 0) return;
+  if (static_cast<size_t>(id) >= timeouts_.size()) {
+    timeouts_.resize(id + 1);
+    timer_wheel_.resize(static_cast<uint16_t>(id + 1));
+  }
+  timeout_t &timeout = timeouts_[id];
+  timeout.receive_time = now;
+  timeout.handshake_deadline = 
+    is_service() && income_kicktime_ > 0 ? now + income_kicktime_ : 0;
+  timeout.write_deadline = 0;
+  timeout.heartbeat_time = now;
+  kick_reason_t reason;
+  uint32_t deadline = timeout_deadline(connection, reason);
+  if (reason != kKickReasonNone) timer_wheel_.schedule(id, deadline);
+}
+
+void Interface::timeout_receive(connection::Basic *connection) {
+  int16_t id = connection->get_id();
+  if (id < 0 || static_cast<size_t>(id) >= timeouts_.size()) return;
+  timeouts_[id].receive_time = now_; //The wheel check it when expired.
+}
+
+void Interface::timeout_write(connection::Basic *connection, bool stalled) {
+  int16_t id = connection->get_id();
+  if (0 == write_kicktime_ || 
+      id < 0 || static_cast<size_t>(id) >= timeouts_.size()) return;
+  timeout_t &timeout = timeouts_[id];
+  if (!stalled) {
+    timeout.write_deadline = 0;
+    return;
+  }
+  if (timeout.write_deadline != 0) return;
+  timeout.write_deadline = now_ + write_kicktime_;
+  //The write deadline may be earlier than the scheduled.
+  if (!timer_wheel_.is_scheduled(id) ||
+      static_cast<int32_t>(
+        timeout.write_deadline - timer_wheel_.get_deadline(id)) < 0)
+    timer_wheel_.schedule(id, timeout.write_deadline);
+}
+
+//Get the earliest deadline of the connection, the heartbeat reason is the
+//connection heartbeat should be called.
+uint32_t Interface::timeout_deadline(connection::Basic *connection, 
+                                     kick_reason_t &reason) const {
+  const timeout_t &timeout = timeouts_[connection->get_id()];
+  uint32_t result = 0;
+  reason = kKickReasonNone;
+  auto earlier = [&result, &reason](uint32_t deadline, kick_reason_t _reason) {
+    if (kKickReasonNone == reason || 
+        static_cast<int32_t>(deadline - result) < 0) {
+      result = deadline;
+      reason = _reason;
+    }
+  };
+  if (kicktime_ > 0 && is_service()) //Not kick the idle connector.
+    earlier(timeout.receive_time + kicktime_, kKickReasonIdle);
+  if (timeout.handshake_deadline != 0 && !connection->is_handshake())
+    earlier(timeout.handshake_deadline, kKickReasonHandshake);
+  if (timeout.write_deadline != 0)
+    earlier(timeout.write_deadline, kKickReasonWriteStall);
+  if (heartbeat_interval_ > 0)
+    earlier(timeout.heartbeat_time + heartbeat_interval_, kKickReasonHeartbeat);
+  return result;
+}
+
+void Interface::timeout_expire(uint32_t now) {
+  expired_.clear();
+  if (0 == timer_wheel_.advance(now, expired_)) return;
+  for (int16_t id : expired_) {
+    connection::Basic *connection = pool_->get(id);
+    if (is_null(connection) || connection->empty()) continue;
+    kick_reason_t reason;
+    uint32_t deadline = timeout_deadline(connection, reason);
+    if (kKickReasonNone == reason) continue;
+    //Touched after scheduled, check it again later.
+    if (static_cast<int32_t>(now - deadline) < 0) {
+      timer_wheel_.schedule(id, deadline);
+      continue;
+    }
+    if (kKickReasonHeartbeat == reason) {
+      timeouts_[id].heartbeat_time = now;
+      if (connection->heartbeat(now)) {
+        deadline = timeout_deadline(connection, reason);
+        if (static_cast<int32_t>(now - deadline) < 0) {
+          timer_wheel_.schedule(id, deadline);
+          continue;
+        }
+      }
+    }
+    SLOW_WARNINGLOG(NET_MODULENAME,
+                    "[net.connection.manager] (Interface::timeout_expire)"
+                    " kick connection id: %d, reason: %d",
+                    id,
+                    reason);
+    if (!is_null(callback_kick_)) callback_kick_(connection, reason);
+    remove(connection);
+  }
+}
+
 bool Interface::add(connection::Basic *connection) {
   Assert(connection);
   if (size_ >= max_size_) return false;
@@ -93,8 +208,12 @@ bool Interface::add(connection::Basic *connection) {
   } else {
     Assert(false);
   }
+  connection->set_manager(this);
   connection->set_disconnect(false); //connect is success
   connection->set_empty(false);      //Pool use flag.
+  timeout_add(
+      connection, 
+      TIME_MANAGER_POINTER ? TIME_MANAGER_POINTER->get_tickcount() : now_);
   if (!is_null(callback_connect_)) callback_connect_(connection);
   return true;
 }
@@ -107,6 +226,7 @@ bool Interface::remove(int16_t id) {
     Assert(false);
     return false;
   }
+  timer_wheel_.cancel(id);
   int16_t managerid = connection->get_managerid();
   if (managerid >= static_cast<int16_t>(size_)) {
     Assert(false);
@@ -9,7 +9,7 @@ using namespace pf_net::connection::manager;
 
 Listener::Listener() :
   listener_socket_{nullptr} {
-  //do nothing
+  socket_option_.linger = 0;
 }
 
 Listener::~Listener() {
@@ -23,9 +23,15 @@ bool Listener::init(uint16_t _max_size, uint16_t _port, const std::string &ip) {
   listener_socket_ = std::move(pointer);
   listener_socket_->set_nonblocking();
   Assert(listener_socket_->get_id() != SOCKET_INVALID);
+  listener_socket_->apply_option(socket_option_);
   return Basic::init(_max_size);
 }
 
+void Listener::set_socket_option(const socket::option_t &option) {
+  socket_option_ = option;
+  if (listener_socket_) listener_socket_->apply_option(socket_option_);
+}
+
 
 pf_net::connection::Basic *Listener::accept() {
   uint32_t step = 0;
@@ -34,7 +40,7 @@ pf_net::connection::Basic *Listener::accept() {
   newconnection = pool_->create();
   if (is_null(newconnection)) { /* When pool full then will close new socket. */
     socket::Basic socket;
-    if (listener_socket_->accept(&socket)) {
+    if (listener_socket_->accept(&socket, true)) {
       socket.close();
     }
     static uint32_t checktime{0};
@@ -53,8 +59,9 @@ pf_net::connection::Basic *Listener::accept() {
   int32_t socketid = SOCKET_INVALID;
   step = 10;
   try {
-    //accept client socket
-    result = listener_socket_->accept(newconnection->socket());
+    //accept client socket, nonblocking and the options inherited from the
+    //listen socket(linux), so no more syscalls for the new socket.
+    result = listener_socket_->accept(newconnection->socket(), true);
     if (!result) {
       step = 15;
       goto EXCEPTION;
@@ -70,23 +77,14 @@ pf_net::connection::Basic *Listener::accept() {
       Assert(false);
       goto EXCEPTION;
     }
-    step = 40;
-    result = newconnection->socket()->set_nonblocking();
-    if (!result) {
-      Assert(false);
-      goto EXCEPTION;
-    }
-    step = 50;
-    if (newconnection->socket()->error()) {
-      Assert(false);
-      goto EXCEPTION;
-    }
+#if !defined(__linux__)
     step = 60;
-    result = newconnection->socket()->set_linger(0);
+    result = newconnection->socket()->apply_option(socket_option_);
     if (!result) {
       Assert(false);
       goto EXCEPTION;
     }
+#endif
     step = 70;
     try {
       result = add(newconnection);
@@ -72,7 +72,9 @@ bool Select::process_input() {
   //接受新连接的时候至少尝试两次，所以连接池里会多创建一个
   if (listener_socket_id() != SOCKET_INVALID && 
       FD_ISSET(listener_socket_id(), &readfds_[kSelectUse])) {
-    for (i = 0; i < onestep_accept_; ++i) {
+    for (int32_t count = 0; 
+         onestep_accept_ < 0 || count < onestep_accept_; 
+         ++count) {
       if (!accept()) break;
     }
   }
@@ -92,7 +94,9 @@ bool Select::process_input() {
           if (!connection->process_input()) { 
             remove(connection);
           } else {
-            receive_bytes_ += connection->get_receive_bytes();
+            uint32_t receive_bytes = connection->get_receive_bytes();
+            receive_bytes_ += receive_bytes;
+            if (receive_bytes > 0) timeout_receive(connection);
           }
         } catch(...) {
           remove(connection);
@@ -123,7 +127,10 @@ bool Select::process_output() {
           if (!connection->process_output()) { 
             remove(connection);
           } else {
-            send_bytes_ += connection->get_send_bytes();
+            uint32_t send_bytes = connection->get_send_bytes();
+            send_bytes_ += send_bytes;
+            timeout_write(
+                connection, 0 == send_bytes && !connection->ostream().empty());
           }
         } catch(...) {
           remove(connection);
@@ -150,6 +157,7 @@ bool Select::process_exception() {
       continue;
     }
     if (FD_ISSET(socket_id, &exceptfds_[kSelectUse])) {
+      connection->socket()->check_error();
       remove(connection);
     }
   }
@@ -0,0 +1,111 @@
+#include "pf/net/connection/manager/timer_wheel.h"
+
+using namespace pf_net::connection::manager;
+
+//The time compare with wrap around(the tick count is uint32_t).
+inline bool time_before(uint32_t a, uint32_t b) {
+  return static_cast<int32_t>(a - b) < 0;
+}
+
+TimerWheel::TimerWheel() :
+  slot_time_{NET_CONNECTION_TIMER_WHEEL_SLOT_TIME},
+  time_{0},
+  current_{0},
+  count_{0} {
+}
+
+TimerWheel::~TimerWheel() {
+  //do nothing
+}
+
+bool TimerWheel::init(uint16_t size, 
+                      uint32_t now, 
+                      uint32_t slot_time, 
+                      uint32_t slot_count) {
+  if (0 == slot_time || 0 == slot_count) return false;
+  entries_.assign(size, entry_t());
+  slots_.assign(slot_count, ID_INVALID);
+  slot_time_ = slot_time;
+  time_ = now;
+  current_ = 0;
+  count_ = 0;
+  return true;
+}
+
+void TimerWheel::resize(uint16_t size) {
+  if (size > entries_.size()) entries_.resize(size);
+}
+
+void TimerWheel::schedule(int16_t id, uint32_t deadline) {
+  if (id < 0 || static_cast<size_t>(id) >= entries_.size()) return;
+  unlink(id);
+  entry_t &entry = entries_[id];
+  //The slots from the current one, the slot reached after the deadline.
+  uint32_t ticks = 1; //Next advance.
+  if (time_before(time_ + slot_time_, deadline))
+    ticks = (deadline - time_ + slot_time_ - 1) / slot_time_;
+  entry.deadline = deadline;
+  entry.slot = static_cast<int32_t>((current_ + ticks) % slots_.size());
+  entry.prev = ID_INVALID;
+  entry.next = slots_[entry.slot];
+  if (entry.next != ID_INVALID) entries_[entry.next].prev = id;
+  slots_[entry.slot] = id;
+  ++count_;
+}
+
+void TimerWheel::cancel(int16_t id) {
+  if (id < 0 || static_cast<size_t>(id) >= entries_.size()) return;
+  unlink(id);
+}
+
+bool TimerWheel::is_scheduled(int16_t id) const {
+  if (id < 0 || static_cast<size_t>(id) >= entries_.size()) return false;
+  return entries_[id].slot != INDEX_INVALID;
+}
+
+uint32_t TimerWheel::get_deadline(int16_t id) const {
+  if (!is_scheduled(id)) return 0;
+  return entries_[id].deadline;
+}
+
+uint32_t TimerWheel::advance(uint32_t now, std::vector<int16_t> &expired) {
+  uint32_t result = 0;
+  if (slots_.empty()) return result;
+  uint32_t steps = 0;
+  //A round is enough when the time jumped.
+  while (!time_before(now, time_ + slot_time_) && steps < slots_.size()) {
+    time_ += slot_time_;
+    ++current_;
+    ++steps;
+    int16_t id = slots_[current_ % slots_.size()];
+    while (id != ID_INVALID) {
+      int16_t next = entries_[id].next;
+      if (!time_before(now, entries_[id].deadline)) {
+        unlink(id);
+        expired.push_back(id);
+        ++result;
+      }
+      id = next;
+    }
+  }
+  if (!time_before(now, time_ + slot_time_)) {
+    uint32_t skip = (now - time_) / slot_time_;
+    time_ += skip * slot_time_;
+    current_ += skip;
+  }
+  return result;
+}
+
+void TimerWheel::unlink(int16_t id) {
+  entry_t &entry = entries_[id];
+  if (INDEX_INVALID == entry.slot) return;
+  if (entry.prev != ID_INVALID) {
+    entries_[entry.prev].next = entry.next;
+  } else {
+    slots_[entry.slot] = entry.next;
+  }
+  if (entry.next != ID_INVALID) entries_[entry.next].prev = entry.prev;
+  entry.slot = INDEX_INVALID;
+  entry.prev = entry.next = ID_INVALID;
+  --count_;
+}
@@ -5,6 +5,9 @@
 #include "pf/basic/io.tcc"
 #include "pf/sys/assert.h"
 #include "pf/basic/logger.h"
+#include "pf/basic/metrics.h"
+#include "pf/basic/clock.h"
+#include "pf/net/protocol/profiler.h"
 #include "pf/net/protocol/basic.h"
 
 namespace pf_net {
@@ -20,6 +23,9 @@ Basic::~Basic() {
 }
 
 bool Basic::command(connection::Basic *connection, uint16_t count) {
+  using namespace pf_basic;
+  static auto &packet_in = metrics::counter_family("net.packet_in");
+  static auto &bytes_in = metrics::counter("net.bytes_in");
   bool result = false;
   char packetheader[NET_PACKET_HEADERSIZE + 1] = {0};
   uint16_t packetid = 0;
@@ -86,13 +92,24 @@ bool Basic::command(connection::Basic *connection, uint16_t count) {
           NET_PACKET_FACTORYMANAGER_POINTER->packet_remove(packet);
           return result;
         }
+        packet_in.get(packetid).add();
+        bytes_in.add(NET_PACKET_HEADERSIZE + packetsize);
         bool needremove = true;
         bool exception = false;
         uint32_t executestatus = 0;
         try {
-          //connection->resetkick();
+          if (!connection->is_handshake()) connection->set_handshake();
           try {
-            executestatus = packet->execute(connection);
+            if (Profiler::enable()) {
+              auto starttime = Clock::now_us();
+              executestatus = packet->execute(connection);
+              Profiler::record(connection, 
+                               packetid, 
+                               packetsize, 
+                               Clock::now_us() - starttime);
+            } else {
+              executestatus = packet->execute(connection);
+            }
           } catch(...) {
             SaveErrorLog();
             executestatus = kPacketExecuteStatusError;
@@ -155,23 +172,46 @@ bool Basic::compress(connection::Basic * connection,
     Assert(false);
     return false;
   }
-  memset(uncompress_buffer, 0, NET_CONNECTION_UNCOMPRESS_BUFFER_SIZE);
-  memset(compress_buffer, 0, NET_CONNECTION_COMPRESS_BUFFER_SIZE);
+  //The compressed frame is encrypted as a whole and the raw packets are
+  //encrypted when write, so decrypt the bytes of both before parse them.
+  stream::Encryptor *encryptor = 
+    istream.encrypt_isenable() ? istream.getencryptor() : nullptr;
   do {
     if (!istream_compress.peek(
           reinterpret_cast<char *>(&compressheader), 
           sizeof(compressheader))) {
       break;
     }
+    if (encryptor) 
+      encryptor->decrypt(&compressheader, &compressheader, 
+                         sizeof(compressheader));
+    size = istream_compress.size();
     if (static_cast<int16_t>(compressheader) < 0) {
-      compressheader &= 0x7FFF;
-      uint32_t totalsize = sizeof(compressheader) + compressheader;
+      char header[NET_STREAM_COMPRESSOR_HEADER_SIZE_MAX] = {0};
+      uint32_t headersize = size < sizeof(header) ? size : sizeof(header);
+      if (!istream_compress.peek(header, headersize)) break;
+      if (encryptor) encryptor->decrypt(header, header, headersize);
+      uint32_t framesize = 0;
+      headersize = 
+        stream::Compressor::read_header(header, headersize, framesize);
+      if (0 == headersize) break;
+      uint32_t totalsize = headersize + framesize;
+      if (totalsize > NET_CONNECTION_UNCOMPRESS_BUFFER_SIZE) {
+        SLOW_ERRORLOG(
+            NET_MODULENAME,
+            "[net.protocol] (Basic::compress)"
+            " compress frame too large: %d",
+            totalsize);
+        return false;
+      }
       if (size < totalsize) break;
       result = istream_compress.read(uncompress_buffer, totalsize);
       if (0 == result) return false;
-      uint32_t outsize = 0;
+      if (encryptor) 
+        encryptor->decrypt(uncompress_buffer, uncompress_buffer, totalsize);
+      uint32_t outsize = NET_CONNECTION_COMPRESS_BUFFER_SIZE;
       bool _result = istream.getcompressor()->decompress(
-          uncompress_buffer, compressheader, compress_buffer, outsize);
+          uncompress_buffer + headersize, framesize, compress_buffer, outsize);
       if (!_result) {
         SLOW_ERRORLOG(
             NET_MODULENAME,
@@ -196,6 +236,8 @@ bool Basic::compress(connection::Basic * connection,
     } else {
       if (!istream_compress.peek(&packetheader[0], sizeof(packetheader)))
         break;
+      if (encryptor) 
+        encryptor->decrypt(packetheader, packetheader, sizeof(packetheader));
       memcpy(&packetid, &packetheader[0], sizeof(packetid));
       memcpy(&packetcheck, 
              &packetheader[sizeof(packetid)], 
@@ -211,7 +253,6 @@ bool Basic::compress(connection::Basic * connection,
         return false;
       }
       packetsize = NET_PACKET_GETLENGTH(packetcheck);
-      size = istream_compress.size();
       if (!NET_PACKET_FACTORYMANAGER_POINTER
           ->is_valid_dynamic_packet_id(packetid)) {
         uint32_t sizemax = 
@@ -234,6 +275,8 @@ bool Basic::compress(connection::Basic * connection,
       //Read it.
       result = istream_compress.read(uncompress_buffer, totalsize);
       if (0 == result) return false;
+      if (encryptor) //The istream encrypt it again when write.
+        encryptor->decrypt(uncompress_buffer, uncompress_buffer, totalsize);
       result = istream.write(uncompress_buffer, totalsize);
       if (result != totalsize) {
         SLOW_ERRORLOG(
@@ -252,6 +295,9 @@ bool Basic::compress(connection::Basic * connection,
 }
 
 bool Basic::send(connection::Basic * connection, packet::Interface *packet) {
+  using namespace pf_basic;
+  static auto &packet_out = metrics::counter_family("net.packet_out");
+  static auto &bytes_out = metrics::counter("net.bytes_out");
   bool result = false;
   stream::Output &ostream = connection->ostream();
   if (&ostream) {
@@ -272,6 +318,8 @@ bool Basic::send(connection::Basic * connection, packet::Interface *packet) {
                   sizeof(packetcheck));
     result = packet->write(ostream);
     Assert(result);
+    packet_out.get(packetid).add();
+    bytes_out.add(NET_PACKET_HEADERSIZE + packetsize);
     uint32_t after_writesize = ostream.size();
     if (packet->size() != 
         after_writesize - before_writesize - NET_PACKET_HEADERSIZE) {
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include "pf/basic/logger.h"
+#include "pf/basic/metrics.h"
+#include "pf/net/connection/basic.h"
+#include "pf/net/protocol/profiler.h"
+
+namespace pf_net {
+
+namespace protocol {
+
+namespace {
+
+pf_basic::metrics::Family<pf_basic::metrics::Counter> &bytes_family() {
+  static auto &result = 
+    pf_basic::metrics::counter_family("net.packet_in_bytes");
+  return result;
+}
+
+pf_basic::metrics::Family<pf_basic::metrics::Histogram> &time_family() {
+  static auto &result = 
+    pf_basic::metrics::histogram_family("net.packet_execute_us");
+  return result;
+}
+
+} //namespace
+
+std::atomic<bool> Profiler::enable_{false};
+std::atomic<uint64_t> Profiler::slow_{0};
+std::atomic<bool> Profiler::report_requested_{false};
+
+void Profiler::set_enable(bool enable) {
+  //Create the families before the net threads use them.
+  bytes_family(); time_family();
+  enable_ = enable;
+}
+
+void Profiler::record(connection::Basic *connection, 
+                      uint16_t id, 
+                      uint32_t size, 
+                      uint64_t time) {
+  bytes_family().get(id).add(size);
+  time_family().get(id).record(time);
+  auto _slow = slow();
+  if (_slow > 0 && time >= _slow) {
+    SLOW_WARNINGLOG(NET_MODULENAME,
+                    "[net.protocol] (Profiler::record) slow packet: %d,"
+                    " connection: %d, size: %u, time: %" PRIu64 "us",
+                    id,
+                    is_null(connection) ? ID_INVALID : connection->get_id(),
+                    size,
+                    time);
+  }
+}
+
+void Profiler::report(std::vector<profile_t> &result, size_t top) {
+  using namespace pf_basic;
+  result.clear();
+  time_family().each([&result](uint16_t id, const metrics::Histogram &time) {
+    metrics::histogram_snapshot_t snapshot;
+    time.snapshot(snapshot);
+    profile_t profile;
+    profile.id = id;
+    profile.count = snapshot.count;
+    profile.total = snapshot.sum;
+    profile.max = snapshot.max;
+    profile.p99 = snapshot.percentile(0.99);
+    result.push_back(profile);
+  });
+  for (profile_t &profile : result)
+    profile.bytes = bytes_family().get(profile.id).value();
+  std::sort(result.begin(), result.end(), 
+            [](const profile_t &a, const profile_t &b) {
+    return a.total > b.total;
+  });
+  if (top > 0 && result.size() > top) result.resize(top);
+}
+
+std::string Profiler::report_text(size_t top) {
+  std::vector<profile_t> profiles;
+  report(profiles, top);
+  std::string result;
+  char line[256]{0};
+  snprintf(line, sizeof(line) - 1, "%8s %12s %14s %14s %10s %10s %10s\n",
+           "id", "count", "bytes", "total_us", "avg_us", "p99_us", "max_us");
+  result += line;
+  for (const profile_t &profile : profiles) {
+    snprintf(line,
+             sizeof(line) - 1,
+             "%8u %12" PRIu64 " %14" PRIu64 " %14" PRIu64 " %10" PRIu64
+             " %10" PRIu64 " %10" PRIu64 "\n",
+             profile.id,
+             profile.count,
+             profile.bytes,
+             profile.total,
+             profile.count > 0 ? profile.total / profile.count : 0,
+             profile.p99,
+             profile.max);
+    result += line;
+  }
+  return result;
+}
+
+void Profiler::log(size_t top) {
+  auto lines = report_text(top);
+  size_t start{0};
+  while (start < lines.size()) {
+    auto end = lines.find('\n', start);
+    if (std::string::npos == end) end = lines.size();
+    SLOW_LOG("profiler", "%s", lines.substr(start, end - start).c_str());
+    start = end + 1;
+  }
+}
+
+} //namespace protocol
+
+} //namespace pf_net
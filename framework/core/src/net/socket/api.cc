@@ -324,6 +324,26 @@ bool listenex(int32_t socketid, uint32_t backlog) {
   return true;
 }
 
+int32_t accept_nonblocking_ex(int32_t socketid, 
+                              struct sockaddr *addr, 
+                              uint32_t *addrlength) {
+#if OS_UNIX && defined(SOCK_NONBLOCK)
+  int32_t client = SOCKET_INVALID;
+  do {
+    client = accept4(
+        socketid, addr, addrlength, SOCK_NONBLOCK | SOCK_CLOEXEC);
+  } while (SOCKET_INVALID == client && EINTR == errno);
+  return client;
+#else
+  int32_t client = acceptex(socketid, addr, addrlength);
+  if (client != SOCKET_INVALID && !set_nonblocking_ex(client, true)) {
+    closeex(client);
+    client = SOCKET_INVALID;
+  }
+  return client;
+#endif
+}
+
 int32_t acceptex(int32_t socketid, 
                  struct sockaddr *addr, 
                  uint32_t *addrlength) {
@@ -673,7 +693,9 @@ int32_t sendex(int32_t socketid,
                uint32_t flag) {
   int32_t result = 0;
 #if OS_UNIX
-  result = send(socketid, buffer, length, flag);
+  do { //The interrupt is not an error of the socket, send again.
+    result = send(socketid, buffer, length, flag);
+  } while (SOCKET_ERROR == result && EINTR == errno);
 #elif OS_WIN
   result = send(socketid, (const char *)buffer, length, flag);
 #endif
@@ -834,7 +856,9 @@ int32_t recvex(int32_t socketid,
 
   int32_t result = 0;
 #if OS_UNIX
-  result = recv(socketid, buffer, length, flag);
+  do { //The interrupt is not an error of the socket, read again.
+    result = recv(socketid, buffer, length, flag);
+  } while (SOCKET_ERROR == result && EINTR == errno);
 #elif OS_WIN
   result = recv(socketid, (char *)buffer, length, flag);
 #endif
@@ -850,7 +874,6 @@ int32_t recvex(int32_t socketid,
       case EBADF : 
       case ENOTCONN : 
       case ENOTSOCK : 
-      case EINTR : 
       case EFAULT : 
 
       default : {
@@ -938,6 +961,33 @@ int32_t recvex(int32_t socketid,
   return result;
 }
 
+int32_t recvvex(int32_t socketid, 
+                void *buffer1, 
+                uint32_t length1, 
+                void *buffer2, 
+                uint32_t length2) {
+#if OS_UNIX
+  struct iovec vectors[2];
+  vectors[0].iov_base = buffer1;
+  vectors[0].iov_len = length1;
+  vectors[1].iov_base = buffer2;
+  vectors[1].iov_len = length2;
+  int32_t result = 0;
+  do {
+    result = static_cast<int32_t>(
+        readv(socketid, vectors, 0 == length2 ? 1 : 2));
+  } while (SOCKET_ERROR == result && EINTR == errno);
+  if (SOCKET_ERROR == result && (EWOULDBLOCK == errno || EAGAIN == errno))
+    result = SOCKET_ERROR_WOULD_BLOCK;
+  return result;
+#elif OS_WIN
+  int32_t result = recvex(socketid, buffer1, length1, 0);
+  if (result != static_cast<int32_t>(length1) || 0 == length2) return result;
+  int32_t _result = recvex(socketid, buffer2, length2, 0);
+  return _result > 0 ? result + _result : result;
+#endif
+}
+
 int32_t recvfrom_ex(int32_t socketid, 
                     void *buffer, 
                     int32_t length, 
@@ -9,11 +9,12 @@ namespace socket {
 Basic::Basic() :
   id_{SOCKET_INVALID},
   host_{0,},
-  port_{0} {
+  port_{0},
+  error_{0} {
   //do nothing.
 }
 
-Basic::Basic(const char *_host, uint16_t _port) {
+Basic::Basic(const char *_host, uint16_t _port) : error_{0} {
   using namespace pf_basic;
   memset(host_, '\0', sizeof(host_));
   if (_host != nullptr) string::safecopy(host_, _host, sizeof(host_));      
@@ -28,14 +29,15 @@ Basic::~Basic() {
 bool Basic::create() {
   bool result = true;
   id_ = api::socketex(AF_INET, SOCK_STREAM, 0);
+  error_ = 0;
   result = is_valid();
   return result;
 }
 
 void Basic::close() {
-  if (is_valid() && !error())
-    api::closeex(id_);
+  if (is_valid()) api::closeex(id_); //Close it even has error(not leak).
   id_ = SOCKET_INVALID;
+  error_ = 0;
   memset(host_, '\0', sizeof(host_));
   port_ = 0;
 }
@@ -84,12 +86,23 @@ bool Basic::reconnect(const char *_host, uint16_t _port) {
 int32_t Basic::send(const void *buffer, uint32_t length, uint32_t flag) {
   int32_t result = 0;
   result = api::sendex(id_, buffer, length, flag);
+  if (SOCKET_ERROR == result) set_error(last_error());
   return result;
 }
 
 int32_t Basic::receive(void *buffer, uint32_t length, uint32_t flag) {
   int32_t result = 0;
   result = api::recvex(id_, buffer, length, flag);
+  if (SOCKET_ERROR == result) set_error(last_error());
+  return result;
+}
+
+int32_t Basic::receivev(void *buffer1, 
+                        uint32_t length1, 
+                        void *buffer2, 
+                        uint32_t length2) {
+  int32_t result = api::recvvex(id_, buffer1, length1, buffer2, length2);
+  if (SOCKET_ERROR == result) set_error(last_error());
   return result;
 }
 
@@ -99,14 +112,22 @@ uint32_t Basic::available() const {
     return result;
 }
 
-int32_t Basic::accept(struct sockaddr_in *accept_sockaddr_in) {
+int32_t Basic::accept(struct sockaddr_in *accept_sockaddr_in, 
+                      bool nonblocking) {
   int32_t result = SOCKET_ERROR;
   uint32_t addrlength = 0;
   addrlength = sizeof(struct sockaddr_in);
-  result = api::acceptex(
-      id_, 
-      reinterpret_cast<struct sockaddr *>(accept_sockaddr_in),
-      &addrlength);
+  if (nonblocking) {
+    result = api::accept_nonblocking_ex(
+        id_, 
+        reinterpret_cast<struct sockaddr *>(accept_sockaddr_in),
+        &addrlength);
+  } else {
+    result = api::acceptex(
+        id_, 
+        reinterpret_cast<struct sockaddr *>(accept_sockaddr_in),
+        &addrlength);
+  }
   return result;
 }
 
@@ -220,8 +241,7 @@ void Basic::get_last_error_message(char *buffer, uint16_t length) const {
   api::getlast_errormessage(buffer, length);
 }
 
-bool Basic::error() const {
-  bool result = true;
+bool Basic::check_error() {
   int32_t option_value = 0;
   uint32_t option_length = sizeof(option_value);
   api::getsockopt_exu(id_, 
@@ -229,8 +249,13 @@ bool Basic::error() const {
                       SO_ERROR, 
                       &option_value,
                       &option_length);
-  result = 0 == option_value ? false : true;
-  return result;
+  if (option_value != 0) set_error(option_value);
+  return error();
+}
+
+int32_t Basic::last_error() const {
+  int32_t result = static_cast<int32_t>(get_last_error_code());
+  return 0 == result ? SOCKET_ERROR : result; //Keep the error state.
 }
 
 bool Basic::is_nonblocking() const {
@@ -281,6 +306,37 @@ bool Basic::set_send_buffer_size(uint32_t size) {
   return result;
 }
 
+bool Basic::set_nodelay(bool on) {
+  int32_t value = on ? 1 : 0;
+  return api::setsockopt_ex(
+      id_, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value));
+}
+
+bool Basic::set_keepalive(bool on) {
+  int32_t value = on ? 1 : 0;
+  return api::setsockopt_ex(
+      id_, SOL_SOCKET, SO_KEEPALIVE, &value, sizeof(value));
+}
+
+bool Basic::apply_option(const option_t &option) {
+  bool result = true;
+  if (option.nodelay >= 0) 
+    result = set_nodelay(option.nodelay != 0) && result;
+  if (option.keepalive >= 0) 
+    result = set_keepalive(option.keepalive != 0) && result;
+  if (option.linger >= 0)
+    result = set_linger(static_cast<uint32_t>(option.linger)) && result;
+  if (option.send_buffer_size > 0) {
+    result = set_send_buffer_size(
+        static_cast<uint32_t>(option.send_buffer_size)) && result;
+  }
+  if (option.receive_buffer_size > 0) {
+    result = set_receive_buffer_size(
+        static_cast<uint32_t>(option.receive_buffer_size)) && result;
+  }
+  return result;
+}
+
 uint64_t Basic::uint64host() const {
   uint64_t result = 0;
   if (0 == strlen(host_)) {
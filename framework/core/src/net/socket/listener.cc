@@ -61,12 +61,12 @@ void Listener::close() {
   if (socket_ != nullptr) socket_->close();
 }
 
-bool Listener::accept(pf_net::socket::Basic *socket) {
+bool Listener::accept(pf_net::socket::Basic *socket, bool nonblocking) {
   using namespace pf_basic;
   if (nullptr == socket) return false;
   struct sockaddr_in accept_sockaddr_in;
   socket->close();
-  socket->set_id(socket_->accept(&accept_sockaddr_in));
+  socket->set_id(socket_->accept(&accept_sockaddr_in, nonblocking));
   if (SOCKET_INVALID == socket->get_id()) return false;
   socket->set_port(ntohs(accept_sockaddr_in.sin_port));
   socket->set_host(inet_ntoa(accept_sockaddr_in.sin_addr));
@@ -14,8 +14,7 @@ Basic::Basic(socket::Basic *_socket,
   streamdata_.buffer = nullptr;
   streamdata_.bufferlength = bufferlength;
   streamdata_.bufferlength_max = bufferlength_max;
-  compressor_.sethead(NET_STREAM_COMPRESSOR_HEADER_SIZE);
-  compressor_.settail(NET_STREAM_COMPRESSOR_HEADER_SIZE);
+  compressor_.resetposition();
   compressor_.setencryptor(&encryptor_);
 }
 
@@ -33,8 +32,7 @@ void Basic::init() {
   streamdata_.tail = 0;
   encrypt_isenable_ = false;
   receive_bytes_ = send_bytes_ = 0;
-  compressor_.sethead(NET_STREAM_COMPRESSOR_HEADER_SIZE);
-  compressor_.settail(NET_STREAM_COMPRESSOR_HEADER_SIZE);
+  compressor_.resetposition();
   set_isinit(true);
 }
 
@@ -85,8 +83,9 @@ void Basic::clear() {
   streamdata_.head = 0;
   streamdata_.tail = 0;
   receive_bytes_ = send_bytes_ = 0;
-  compressor_.sethead(NET_STREAM_COMPRESSOR_HEADER_SIZE);
-  compressor_.settail(NET_STREAM_COMPRESSOR_HEADER_SIZE);
+  compressor_.resetposition();
+  compressor_.resetcontext();
+  compressor_.getassistant()->reset(); //The new connection learn again.
 }
 
 }; //namespace stream
@@ -5,10 +5,11 @@ using namespace pf_net::stream;
 
 Compressor::Compressor() :
   buffer_{nullptr},
-  head_{NET_STREAM_COMPRESSOR_HEADER_SIZE},
-  tail_{NET_STREAM_COMPRESSOR_HEADER_SIZE},
+  head_{NET_STREAM_COMPRESSOR_HEADER_SIZE_MAX},
+  tail_{NET_STREAM_COMPRESSOR_HEADER_SIZE_MAX},
   maxsize_{0},
-  encryptor_{nullptr} {
+  encryptor_{nullptr},
+  codec_{pf_util::compressor::codec::get(pf_util::compressor::kCodecLzo)} {
 }
 
 Compressor::~Compressor() {
@@ -17,8 +18,8 @@ Compressor::~Compressor() {
 }
 
 void Compressor::clear() {
-  head_ = NET_STREAM_COMPRESSOR_HEADER_SIZE;
-  tail_ = NET_STREAM_COMPRESSOR_HEADER_SIZE;
+  head_ = NET_STREAM_COMPRESSOR_HEADER_SIZE_MAX;
+  tail_ = NET_STREAM_COMPRESSOR_HEADER_SIZE_MAX;
   maxsize_ = 0;
   buffer_ = nullptr;
   encryptor_ = nullptr;
@@ -28,9 +29,17 @@ bool Compressor::alloc(uint32_t size) {
   safe_delete_array(buffer_);
   buffer_ = new char[size];
   if (is_null(buffer_)) return false;
+  maxsize_ = size;
   return true;
 }
 
+bool Compressor::reserve(uint32_t insize) {
+  if (insize > NET_STREAM_COMPRESSOR_FRAME_MAX) return false;
+  if (NET_STREAM_COMPRESSOR_OUT_BOUND(insize) <= maxsize_) return true;
+  if (getsize() != 0) return false;
+  return alloc(NET_STREAM_COMPRESSOR_OUT_SIZE_MAX);
+}
+
 char *Compressor::getbuffer() {
   return buffer_;
 }
@@ -71,18 +80,50 @@ bool Compressor::pophead(uint32_t size) {
 }
 
 void Compressor::add_packetheader() {
-  uint16_t size = static_cast<uint16_t>(getsize());
-  size |= 0x8000;
-  *reinterpret_cast<uint16_t *>(buffer_) = size;
-  head_ = 0;
+  uint32_t size = getsize();
+  if (size < 0x7FFF) {
+    uint16_t header = static_cast<uint16_t>(size) | 0x8000;
+    head_ = NET_STREAM_COMPRESSOR_HEADER_SIZE_MAX - sizeof(header);
+    memcpy(buffer_ + head_, &header, sizeof(header));
+  } else {
+    uint16_t header = 0xFFFF;
+    memcpy(buffer_, &header, sizeof(header));
+    memcpy(buffer_ + sizeof(header), &size, sizeof(size));
+    head_ = 0;
+  }
+}
+
+uint32_t Compressor::read_header(const char *buffer, 
+                                 uint32_t size, 
+                                 uint32_t &framesize) {
+  uint16_t header = 0;
+  if (size < sizeof(header)) return 0;
+  memcpy(&header, buffer, sizeof(header));
+  if (header != 0xFFFF) {
+    framesize = header & 0x7FFF;
+    return sizeof(header);
+  }
+  if (size < NET_STREAM_COMPRESSOR_HEADER_SIZE_MAX) return 0;
+  uint32_t _framesize = 0;
+  memcpy(&_framesize, buffer + sizeof(header), sizeof(_framesize));
+  framesize = _framesize;
+  return NET_STREAM_COMPRESSOR_HEADER_SIZE_MAX;
+}
+
+bool Compressor::set_codec(uint8_t codec) {
+  auto _codec = pf_util::compressor::codec::get(codec);
+  if (is_null(_codec)) return false;
+  codec_ = _codec;
+  context_.reset();
+  return true;
 }
 
 void Compressor::encrypt() {
-  encryptor_->encrypt(buffer_, buffer_, getsize());
+  encryptor_->encrypt(getheader(), getheader(), getsize());
 }
 
 void Compressor::resetposition() {
-  head_ = tail_ = NET_STREAM_COMPRESSOR_HEADER_SIZE;
+  head_ = tail_ = NET_STREAM_COMPRESSOR_HEADER_SIZE_MAX;
 }
 
 void Compressor::setencryptor(Encryptor *encryptor) {
@@ -93,20 +134,35 @@ bool Compressor::compress(const char *in,
                           uint32_t insize, 
                           char *out, 
                           uint32_t &outsize) {
+  if (insize > NET_STREAM_COMPRESSOR_FRAME_MAX) return false;
+  if (assistant_.adaptive_isenable()) {
+    if (!assistant_.should_compress(insize)) return false;
+  } else if (insize < NET_STREAM_COMPRESSOR_IN_SIZE) {
+    return false;
+  }
   assistant_.compressframe_inc();
-  if (insize < NET_STREAM_COMPRESSOR_IN_SIZE) return false;
   const unsigned char *_in = reinterpret_cast<const unsigned char *>(in);
   unsigned char *_out = reinterpret_cast<unsigned char *>(out);
-  bool result = UTIL_COMPRESSOR_MINIMANAGER_POINTER->compress(
-      _in, insize, _out, outsize, assistant_.get_workmemory());
+  if (maxsize_ < NET_STREAM_COMPRESSOR_OUT_BOUND(insize)) return false;
+  if (is_null(context_)) 
+    context_.reset(codec_->create_context(NET_STREAM_COMPRESSOR_FRAME_MAX));
+  outsize = maxsize_ - tail_;
+  auto start = std::chrono::steady_clock::now();
+  bool result = codec_->compress(context_.get(), _in, insize, _out, outsize);
+  assistant_.feedback(
+      insize, 
+      result ? outsize : 0,
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
   if (true == result) {
     assistant_.compressframe_successinc();
     pushback(outsize);
     add_packetheader();
     //logging
-    if (UTIL_COMPRESSOR_MINIMANAGER_POINTER->log_isenable()) {
+    if (UTIL_COMPRESSOR_MINIMANAGER_POINTER &&
+        UTIL_COMPRESSOR_MINIMANAGER_POINTER->log_isenable()) {
       UTIL_COMPRESSOR_MINIMANAGER_POINTER->add_compress_datasize(
-          outsize + NET_STREAM_COMPRESSOR_HEADER_SIZE);
+          getsize());
       UTIL_COMPRESSOR_MINIMANAGER_POINTER->add_uncompress_datasize(insize);
     }
   }
@@ -119,10 +175,9 @@ bool Compressor::decompress(const char *in,
                             uint32_t &outsize) {
   const unsigned char *_in = reinterpret_cast<const unsigned char *>(in);
   unsigned char *_out = reinterpret_cast<unsigned char *>(out);
-  int32_t result = UTIL_COMPRESSOR_MINIMANAGER_POINTER->decompress(
-      _in + NET_STREAM_COMPRESSOR_HEADER_SIZE, insize, _out, outsize);
-  bool _result = LZO_E_OK == result;
-  return _result;
+  if (is_null(context_)) 
+    context_.reset(codec_->create_context(NET_STREAM_COMPRESSOR_FRAME_MAX));
+  return codec_->decompress(context_.get(), _in, insize, _out, outsize);
 }
 
 pf_util::compressor::Assistant *Compressor::getassistant() {
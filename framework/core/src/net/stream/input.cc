@@ -105,114 +105,60 @@ bool Input::skip(uint32_t length) {
 
 int32_t Input::fill() {
   if (!socket_->is_valid()) return 0;
-  uint32_t fillcount = 0;
-  int32_t receivecount = 0;
-  uint32_t freecount = 0;
   if (is_null(streamdata_.buffer)) return -1;
-  // head tail length=10
-  // 0123456789
-  // abcd......
-  if (streamdata_.head <= streamdata_.tail) {
-    if (0 == streamdata_.head) {
-      receivecount = 0;
-      freecount = streamdata_.bufferlength - streamdata_.tail - 1;
-      if (freecount != 0) {
-        receivecount = socket_->receive(
-            &streamdata_.buffer[streamdata_.tail], freecount);
-        if (SOCKET_ERROR_WOULD_BLOCK == receivecount) return 0;
-        if (SOCKET_ERROR == receivecount) return SOCKET_ERROR - 1;
-        if (0 == receivecount) return SOCKET_ERROR - 2;
-        streamdata_.tail += receivecount;
-        fillcount += receivecount;
-        if (static_cast<uint32_t>(receivecount) == freecount) {
-          uint32_t available = socket_->available();
-          if (available <= 0) return fillcount;
-          if ((streamdata_.bufferlength + available + 1) > 
-              streamdata_.bufferlength_max) {
-            init();
-            return SOCKET_ERROR - 3;
-          }
-          if (!resize(available + 1)) return 0;
-          receivecount = socket_->receive(
-              &streamdata_.buffer[streamdata_.tail], available);
-          if (SOCKET_ERROR_WOULD_BLOCK == receivecount) return 0;
-          if (SOCKET_ERROR == receivecount) return SOCKET_ERROR - 4;
-          if (0 == receivecount) return SOCKET_ERROR - 5;
-          streamdata_.tail += receivecount;
-          fillcount += receivecount; 
-        }
-      }
-    } else { // 0 == head
-      freecount = streamdata_.bufferlength - streamdata_.tail;
-      receivecount = socket_->receive(
-          &streamdata_.buffer[streamdata_.tail], freecount);
-      if (SOCKET_ERROR_WOULD_BLOCK == receivecount) return 0;
-      if (SOCKET_ERROR == receivecount) return SOCKET_ERROR - 6;
-      if (0 == receivecount) return SOCKET_ERROR - 7;
-      streamdata_.tail = 
-        (streamdata_.tail + receivecount) % streamdata_.bufferlength;
-      fillcount += receivecount;
-      if (static_cast<uint32_t>(receivecount) == freecount) {
-        receivecount = 0;
-        freecount = streamdata_.head - 1;
-        if (freecount != 0) {
-          receivecount = socket_->receive(
-              &streamdata_.buffer[0], freecount);
-          if (SOCKET_ERROR_WOULD_BLOCK == receivecount) return 0;
-          if (SOCKET_ERROR == receivecount) return SOCKET_ERROR - 8;
-          if (0 == receivecount) return SOCKET_ERROR - 9;
-          streamdata_.tail += receivecount;
-          fillcount += receivecount;
-        }
-        if (static_cast<uint32_t>(receivecount) == freecount) {
-          uint32_t available = socket_->available();
-          if (available <= 0) return fillcount;
-          if ((streamdata_.bufferlength + available + 1) > 
-              streamdata_.bufferlength_max) {
-            init();
-            return SOCKET_ERROR - 10;
-          }
-          if (!resize(available + 1)) return 0;
-          receivecount = socket_->receive(
-              &streamdata_.buffer[streamdata_.tail], available);
-          if (SOCKET_ERROR_WOULD_BLOCK == receivecount) return 0;
-          if (SOCKET_ERROR == receivecount) return SOCKET_ERROR - 11;
-          if (0 == receivecount) return SOCKET_ERROR - 12;
-          streamdata_.tail += receivecount;
-          fillcount += receivecount; 
-        }
-      }
-    }
-  } else { //streamdata_.head <= streamdata_.tail
-    receivecount = 0;
-    freecount = streamdata_.head - streamdata_.tail - 1;
-    if (freecount != 0) {
-      receivecount = socket_->receive(
-          &streamdata_.buffer[streamdata_.tail], freecount);
-      if (SOCKET_ERROR_WOULD_BLOCK == receivecount) return 0;
-      if (SOCKET_ERROR == receivecount) return SOCKET_ERROR - 13;
-      if (0 == receivecount) return SOCKET_ERROR - 14;
-      streamdata_.tail += receivecount;
-      fillcount += receivecount;
+  if (eof_) return SOCKET_ERROR - 2;
+  uint32_t fillcount = 0;
+  pending_ = false;
+  //Full before read, the protocol can't consume anything(one packet bigger
+  //than the buffer), grow to the max only at this time.
+  if (0 == unused()) {
+    if (streamdata_.bufferlength >= streamdata_.bufferlength_max ||
+        !resize(streamdata_.bufferlength_max - streamdata_.bufferlength)) {
+      init();
+      return SOCKET_ERROR - 3;
     }
-    if (static_cast<uint32_t>(receivecount) == freecount) {
-      uint32_t available = socket_->available();
-      if (available <= 0) return fillcount;
-      if ((streamdata_.bufferlength + available + 1) > 
-          streamdata_.bufferlength_max) {
-        init();
-        return SOCKET_ERROR - 15;
+  }
+  //Edge trigger: read the free segments of the ring until would block, the
+  //ring full or the budget used(the rest read at next tick).
+  while (fillcount < fill_budget_) {
+    uint32_t head = streamdata_.head;
+    uint32_t tail = streamdata_.tail;
+    uint32_t bufferlength = streamdata_.bufferlength;
+    uint32_t length1 = 0;
+    uint32_t length2 = 0;
+    // head tail length=10
+    // 0123456789
+    // abcd......
+    if (head <= tail) {
+      if (0 == head) {
+        length1 = bufferlength - tail - 1;
+      } else {
+        length1 = bufferlength - tail;
+        length2 = head - 1;
       }
-      if (!resize(available + 1)) return 0;
-      receivecount = socket_->receive(
-          &streamdata_.buffer[streamdata_.tail], available);
-      if (SOCKET_ERROR_WOULD_BLOCK == receivecount) return 0;
-      if (SOCKET_ERROR == receivecount) return SOCKET_ERROR - 16;
-      if (0 == receivecount) return SOCKET_ERROR - 17;
-      streamdata_.tail += receivecount;
-      fillcount += receivecount; 
+    } else {
+      length1 = head - tail - 1;
+    }
+    uint32_t budget = fill_budget_ - fillcount;
+    if (length1 > budget) length1 = budget;
+    if (length2 > budget - length1) length2 = budget - length1;
+    if (0 == length1 + length2) break; //The ring is full.
+    int32_t receivecount = socket_->receivev(
+        &streamdata_.buffer[tail], length1, streamdata_.buffer, length2);
+    if (SOCKET_ERROR_WOULD_BLOCK == receivecount) return fillcount;
+    if (SOCKET_ERROR == receivecount) return SOCKET_ERROR - 1;
+    if (0 == receivecount) {
+      if (0 == fillcount) return SOCKET_ERROR - 2;
+      eof_ = pending_ = true; //Handle the received data first.
+      return fillcount;
     }
+    streamdata_.tail = (tail + receivecount) % bufferlength;
+    fillcount += receivecount;
+    //Short read, the socket is drained(new data will trigger again).
+    if (static_cast<uint32_t>(receivecount) < length1 + length2) 
+      return fillcount;
   }
+  pending_ = true;
   return fillcount;
 }
 
@@ -278,7 +224,7 @@ void Input::read_string(char *buffer, size_t _size) {
     if (read_length < length) {
       SLOW_ERRORLOG(NET_MODULENAME,
                     "[net.stream] Input::read_string size < length"
-                    " not read, size: %d, length: %d",
+                    " not read, size: %zu, length: %d",
                     _size, 
                     length);
     }
@@ -287,6 +233,21 @@ void Input::read_string(char *buffer, size_t _size) {
   read(buffer, length);
 }
 
+bool Input::read_string(std::string &value, size_t max) {
+  uint32_t length = read_uint32();
+  if (length > max) {
+    SLOW_ERRORLOG(NET_MODULENAME,
+                  "[net.stream] Input::read_string max < length"
+                  " not read, max: %zu, length: %u",
+                  max,
+                  length);
+    return false;
+  }
+  value.resize(length);
+  if (length > 0 && read(&value[0], length) != length) return false;
+  return true;
+}
+
 float Input::read_float() {
   float result = 0;
   read((char*)&result, sizeof(result));
@@ -317,6 +278,8 @@ uint32_t Input::write(const char *buffer, uint32_t length) {
       } else {
         memcpy(&streamdata_.buffer[streamdata_.tail], buffer, copysize);
       }
+      fillcount += copysize;
+      streamdata_.tail += copysize;
     } else {
       freecount = streamdata_.bufferlength - streamdata_.tail;
       uint32_t copysize1 = freecount > length ? length : freecount;
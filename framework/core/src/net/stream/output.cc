@@ -55,21 +55,26 @@ int32_t Output::flush() {
   if (!socket_->is_valid()) return 0;
   if (0 == size()) return 0;
   if (compressor_.getassistant()->isenable()) { //compress is enable
-    uint32_t result = 0;
-    uint32_t sendcount = 0;
-    uint32_t tail = get_floortail();
-    if (static_cast<int32_t>(tail) < -1) return tail;
-    if (compress(tail)) return -1;
-    result = compressflush();
+    //First finish the last frame(compressed or raw) then prepare a new one.
+    int32_t sendcount = 0;
+    int32_t result = compressflush();
+    if (result <= SOCKET_ERROR) return result;
     sendcount += result;
-    if (static_cast<int32_t>(result) <= SOCKET_ERROR) 
-      return static_cast<int32_t>(result);
-    rawprepare(tail);
+    if (compressor_.getsize() != 0) return sendcount;
     result = rawflush();
+    if (result <= SOCKET_ERROR) return result;
     sendcount += result;
-    if (static_cast<int32_t>(result) <= SOCKET_ERROR) 
-      return static_cast<int32_t>(result);
-    return sendcount;
+    if (!raw_isempty() || 0 == size()) return sendcount;
+    uint32_t tail = get_floortail();
+    if (static_cast<int32_t>(tail) < -1) return static_cast<int32_t>(tail);
+    if (compress(tail)) {
+      result = compressflush();
+    } else {
+      rawprepare(tail);
+      result = rawflush();
+    }
+    if (result <= SOCKET_ERROR) return result;
+    return sendcount + result;
   }
   uint32_t flushcount = 0;
   int32_t sendcount = 0;
@@ -211,22 +216,17 @@ int32_t Output::compressflush() {
 #elif __WINDOWS__
   flag = MSG_DONTROUTE;
 #endif
-  bool totalsend = true;
-  if (leftcount > 1024) {
-    leftcount = 1024;
-    totalsend = false;
-  }
   while (leftcount > 0) {
     sendcount = socket_->send(compressor_.getheader(), leftcount, flag);
-    if (SOCKET_ERROR_WOULD_BLOCK == static_cast<int32_t>(sendcount)) return 0;
+    if (SOCKET_ERROR_WOULD_BLOCK == static_cast<int32_t>(sendcount)) 
+      return flushcount;
     if (SOCKET_ERROR == static_cast<int32_t>(sendcount)) 
       return SOCKET_ERROR - 12;
-    if (0 == sendcount) return 0;
+    if (0 == sendcount) return flushcount;
     flushcount += sendcount;
     compressor_.pophead(sendcount);
     leftcount -= sendcount;
   }
-  if (!totalsend) return flushcount;
   compressor_.resetposition();
   return flushcount;
 }
@@ -238,23 +238,28 @@ bool Output::compress(uint32_t tail) {
     return false;
   }
   uint32_t head = streamdata_.head;
-  uint32_t _tail = streamdata_.tail;
   uint32_t bufferlength = streamdata_.bufferlength;
   uint32_t bufferlength_max = streamdata_.bufferlength_max;
   if (bufferlength > bufferlength_max) return false;
+  //The frame wrap the ring end, send it as raw.
+  if (tail < head) return false;
   compressor_.resetposition();
   char *inbuffer = nullptr;
-  uint32_t insize = _tail - head;
+  uint32_t insize = tail - head;
   uint32_t outsize = 0;
   if (insize < NET_STREAM_COMPRESSOR_SIZE_MIN) return false;
+  if (!compressor_.reserve(insize)) return false;
   inbuffer = streamdata_.buffer + head;
   bool compress_result = 
     compressor_.compress(inbuffer, insize, compressor_.getheader(), outsize);
   if (!compress_result) return false;
+  //The frame(header and data) is encrypted again, the peer decrypt it
+  //before decompress.
   if (encrypt_isenable()) compressor_.encrypt();
   streamdata_.head = (head + insize) % bufferlength;
   if (streamdata_.head == streamdata_.tail)
     streamdata_.head = streamdata_.tail = 0;
+  tail_ = streamdata_.head; //No raw data before the next frame.
   return true;
 }
 
@@ -275,7 +280,7 @@ uint32_t Output::get_floortail() {
   uint32_t position = head;
   uint32_t _size{0};
   char *buffer = streamdata_.buffer + position;
-  uint32_t sizemax = NET_STREAM_COMPRESSOR_IN_SIZE;
+  uint32_t sizemax = NET_STREAM_COMPRESSOR_FRAME_MAX;
   if (size() < sizemax) return tail;
   //uint16_t last_packetid = static_cast<uint16_t>(-1);
   do {
@@ -345,49 +350,35 @@ int32_t Output::rawflush() {
     result = static_cast<uint32_t>(SOCKET_ERROR - 11);
     return result;
   }
-  bool totalsend = true;
   if (streamdata_.head < tail_) {
     leftcount = tail_ - streamdata_.head;
-    if (leftcount > 1024) {
-      leftcount = 1024;
-      totalsend = false;
-    }
     while (leftcount > 0) {
       sendcount = 
         socket_->send(&streamdata_.buffer[streamdata_.head], leftcount, flag);
       if (SOCKET_ERROR_WOULD_BLOCK == static_cast<int32_t>(sendcount)) 
-        return 0;
+        return flushcount;
       if (SOCKET_ERROR == static_cast<int32_t>(sendcount)) 
         return SOCKET_ERROR - 12;
-      if (0 == sendcount) return 0;
+      if (0 == sendcount) return flushcount;
       flushcount += sendcount;
       leftcount -= sendcount;
       streamdata_.head += sendcount;
     }
-    if (!totalsend) return flushcount;
   } else if (streamdata_.head > tail_) {
     leftcount = streamdata_.bufferlength - streamdata_.head;
-    if (leftcount > 1024) {
-      leftcount = 1024;
-      totalsend = false;
-    }
     while (leftcount > 0) {
       sendcount = 
         socket_->send(&streamdata_.buffer[streamdata_.head], leftcount, flag);
       if (SOCKET_ERROR_WOULD_BLOCK == static_cast<int32_t>(sendcount)) 
-        return 0;
+        return flushcount;
       if (SOCKET_ERROR == static_cast<int32_t>(sendcount)) 
         return SOCKET_ERROR - 12;
-      if (0 == sendcount) return 0;
+      if (0 == sendcount) return flushcount;
       flushcount += sendcount;
       leftcount -= sendcount;
       streamdata_.head += sendcount;
     }
-    if (!totalsend) {
-      return flushcount;
-    } else {
-      streamdata_.head = 0;
-    }
+    streamdata_.head = 0; //The rest [0, tail_) send at next time.
   }
   if (streamdata_.head == streamdata_.tail)
     streamdata_.head = streamdata_.tail = tail_ = 0;
@@ -4,6 +4,10 @@
 #include <sys/types.h>
 #include <sys/ipc.h>
 #include <sys/shm.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
 #include <errno.h>
 #elif OS_WIN
 #include <winbase.h>
@@ -89,14 +93,14 @@ dataheader_t *dataheader_struct::operator = (const dataheader_t *object) {
 namespace api {
 
 #if OS_UNIX
-int32_t create(uint32_t key, size_t size) {
+int32_t create(uint32_t key, size_t size, int32_t flag) {
   int32_t handle = 0;
 #elif OS_WIN
 HANDLE create(uint32_t key, size_t size) {
     HANDLE handle = nullptr;
 #endif
 #if OS_UNIX
-    handle = shmget(key, size, IPC_CREAT | IPC_EXCL | 0666);
+    handle = shmget(key, size, IPC_CREAT | IPC_EXCL | flag | 0666);
     if (HANDLE_INVALID == handle) {
       SLOW_ERRORLOG(
           GLOBALS["app.name"].c_str(),
@@ -182,12 +186,45 @@ void close(HANDLE handle) {
 
 } //namespace api
 
+namespace {
+
+std::mutex g_option_mutex;
+std::map<uint32_t, option_t> g_options;
+
+#if OS_UNIX
+//The huge page size of x86_64 and aarch64(4k page).
+const size_t kHugePageSize = 2 * 1024 * 1024;
+
+std::string segment_name(const option_t &option, uint32_t key) {
+  char name[32]{0};
+  snprintf(name, sizeof(name) - 1, "pf_share_%u", key);
+  if (kBackendPosix == option.backend) return std::string("/") + name;
+  return option.path + "/" + name;
+}
+#endif
+
+} //namespace
+
+void set_option(uint32_t key, const option_t &option) {
+  std::unique_lock<std::mutex> lock(g_option_mutex);
+  g_options[key] = option;
+}
+
+option_t get_option(uint32_t key) {
+  std::unique_lock<std::mutex> lock(g_option_mutex);
+  auto it = g_options.find(key);
+  if (it == g_options.end()) it = g_options.find(0);
+  return it == g_options.end() ? option_t() : it->second;
+}
+
 
 //-- class start
 Base::Base() :
   size_{0},
   data_{nullptr},
   header_{nullptr},
+  map_size_{0},
+  zeroed_{false},
   handle_{HANDLE_INVALID} {
 }
 
@@ -197,7 +234,29 @@ Base::~Base() {
 
 bool Base::create(uint32_t _key, size_t _size) {
     if (GLOBALS["app.cmdmodel"] == kCmdModelClearAll) return false;
-    handle_ = api::create(_key, _size);
+    option_ = get_option(_key);
+    zeroed_ = false;
+#if OS_WIN
+    option_.backend = kBackendSysV; //Only the file mapping of the key.
+#endif
+    if (option_.backend != kBackendSysV) {
+      if (!map_create(_key, _size)) return false;
+      handle_ = 0; //Not the sysv id.
+    } else {
+#if OS_UNIX
+      int32_t flag{0};
+      map_size_ = _size;
+#if defined(SHM_HUGETLB)
+      if (kHugePageTLB == option_.huge_page) {
+        flag = SHM_HUGETLB;
+        map_size_ = (_size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+      }
+#endif
+      handle_ = api::create(_key, map_size_, flag);
+#else
+      handle_ = api::create(_key, _size);
+#endif
+    }
     if (HANDLE_INVALID == handle_) {
       SLOW_ERRORLOG(
           GLOBALS["app.name"].c_str(), 
@@ -207,8 +266,10 @@ bool Base::create(uint32_t _key, size_t _size) {
           _key);
       return false;
     }
-    header_ = api::map(handle_);
+    if (kBackendSysV == option_.backend) header_ = api::map(handle_);
     if (header_) {
+      map_advise();
+      zeroed_ = option_.lazy_zero;
       data_ = header_ + sizeof(header_t);
       header()->clear();
       header()->key = _key;
@@ -234,23 +295,34 @@ bool Base::create(uint32_t _key, size_t _size) {
 }
 
 void Base::release() {
+    if (option_.backend != kBackendSysV) {
+      map_release();
+      size_ = 0;
+      return;
+    }
     if (header_) {
       api::unmap(header_);
       header_ = nullptr;
     }
-    if (handle_) {
+    if (handle_ != HANDLE_INVALID) { //The sysv id can be 0.
       api::close(handle_);
-#if OS_UNIX
-      handle_ = 0;
-#elif OS_WIN
-      handle_ = nullptr;
-#endif
+      handle_ = HANDLE_INVALID;
     }
     size_ = 0;
 }
 
 bool Base::attach(uint32_t _key, size_t _size, bool errorlog) {
-    handle_ = api::open(_key, _size, errorlog);
+    option_ = get_option(_key);
+    zeroed_ = false;
+#if OS_WIN
+    option_.backend = kBackendSysV;
+#endif
+    if (option_.backend != kBackendSysV) {
+      handle_ = map_attach(_key, _size) ? 0 : HANDLE_INVALID;
+    } else {
+      handle_ = api::open(_key, _size, errorlog);
+      map_size_ = _size;
+    }
     if (GLOBALS["app.cmdmodel"] == kCmdModelClearAll) {
       release();
       SLOW_LOG(
@@ -268,8 +340,9 @@ bool Base::attach(uint32_t _key, size_t _size, bool errorlog) {
       }
       return false;
     }
-    header_ = api::map(handle_);
+    if (kBackendSysV == option_.backend) header_ = api::map(handle_);
     if (header_) {
+      map_advise();
       data_ = header_ + sizeof(header_t);
       Assert(header()->key == _key);
       Assert(header()->size == _size);
@@ -291,6 +364,128 @@ bool Base::attach(uint32_t _key, size_t _size, bool errorlog) {
     return true;
 }
 
+#if OS_UNIX
+
+bool Base::map_create(uint32_t key, size_t size) {
+  auto name = segment_name(option_, key);
+  int32_t fd{-1};
+  if (kBackendPosix == option_.backend) {
+    fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+  } else {
+    fd = ::open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+  }
+  if (fd < 0) {
+    SLOW_ERRORLOG(GLOBALS["app.name"].c_str(),
+                  "[sys.memory.share] (Base::map_create) open %s failed,"
+                  " error: %d",
+                  name.c_str(),
+                  errno);
+    return false;
+  }
+  map_size_ = size;
+  if (kHugePageTLB == option_.huge_page)
+    map_size_ = (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+  int32_t flags = MAP_SHARED;
+#if defined(MAP_POPULATE)
+  if (option_.populate && option_.numa_node < 0) flags |= MAP_POPULATE;
+#endif
+  void *pointer = MAP_FAILED;
+  if (0 == ftruncate(fd, static_cast<off_t>(map_size_))) {
+    pointer = 
+      mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, flags, fd, 0);
+  }
+  ::close(fd);
+  if (MAP_FAILED == pointer) {
+    SLOW_ERRORLOG(GLOBALS["app.name"].c_str(),
+                  "[sys.memory.share] (Base::map_create) map %s size: %zu"
+                  " failed, error: %d",
+                  name.c_str(),
+                  map_size_,
+                  errno);
+    if (kBackendPosix == option_.backend) {
+      shm_unlink(name.c_str());
+    } else {
+      unlink(name.c_str());
+    }
+    return false;
+  }
+  header_ = static_cast<char *>(pointer);
+  return true;
+}
+
+bool Base::map_attach(uint32_t key, size_t size) {
+  auto name = segment_name(option_, key);
+  int32_t fd{-1};
+  if (kBackendPosix == option_.backend) {
+    fd = shm_open(name.c_str(), O_RDWR, 0666);
+  } else {
+    fd = ::open(name.c_str(), O_RDWR, 0666);
+  }
+  if (fd < 0) return false;
+  struct stat info;
+  void *pointer = MAP_FAILED;
+  if (0 == fstat(fd, &info) && static_cast<size_t>(info.st_size) >= size) {
+    map_size_ = static_cast<size_t>(info.st_size);
+    pointer = 
+      mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  ::close(fd);
+  if (MAP_FAILED == pointer) return false;
+  header_ = static_cast<char *>(pointer);
+  return true;
+}
+
+void Base::map_release() {
+  if (is_null(header_)) return;
+  auto name = segment_name(option_, header()->key);
+  munmap(header_, map_size_);
+  header_ = nullptr;
+  data_ = nullptr;
+  if (kBackendPosix == option_.backend) {
+    shm_unlink(name.c_str());
+  } else {
+    unlink(name.c_str());
+  }
+}
+
+void Base::map_advise() {
+  if (is_null(header_) || 0 == map_size_) return;
+#if defined(MADV_HUGEPAGE)
+  if (kHugePageAdvise == option_.huge_page)
+    madvise(header_, map_size_, MADV_HUGEPAGE);
+#endif
+#if defined(__linux__) && defined(SYS_mbind)
+  if (option_.numa_node >= 0 && option_.numa_node < 64) {
+    const int32_t kMpolBind = 2;
+    unsigned long mask = 1UL << option_.numa_node;
+    if (syscall(SYS_mbind, header_, map_size_, kMpolBind, &mask, 
+                sizeof(mask) * 8, 0) != 0) {
+      SLOW_WARNINGLOG(GLOBALS["app.name"].c_str(),
+                      "[sys.memory.share] (Base::map_advise) bind the node"
+                      " %d failed, error: %d",
+                      option_.numa_node,
+                      errno);
+    }
+  }
+#endif
+  //The mmap populated it already.
+  bool populated = option_.backend != kBackendSysV && option_.numa_node < 0;
+  if (option_.populate && !populated) {
+    volatile char value{0};
+    for (size_t i = 0; i < map_size_; i += 4096) value = header_[i];
+    (void)value;
+  }
+}
+
+#else
+
+bool Base::map_create(uint32_t, size_t) { return false; }
+bool Base::map_attach(uint32_t, size_t) { return false; }
+void Base::map_release() {}
+void Base::map_advise() {}
+
+#endif
+
 char *Base::get(uint32_t index, size_t _size) {
     Assert(_size > 0);
     Assert(_size * index < size_);
@@ -345,6 +540,13 @@ void lock(mutex_t &mutex, int8_t type) {
   }
 }
 
+bool try_lock(mutex_t &mutex, int8_t type) {
+  if (GLOBALS["app.cmdmodel"] == kCmdModelRecover ||
+      GLOBALS["app.status"] == kAppStatusStop) return true;
+  int8_t flag{kFlagFree};
+  return mutex.compare_exchange_strong(flag, type);
+}
+
 void unlock(mutex_t &mutex, int8_t type) {
   if (GLOBALS["app.cmdmodel"] == kCmdModelRecover ||
       GLOBALS["app.status"] == kAppStatusStop) return;
@@ -373,16 +575,27 @@ GroupPool::GroupPool(uint32_t _key, const std::vector<group_item_t> &group) :
   size_{0},
   ready_{false}{
   size_ += sizeof(group_header_t);
+  int16_t index_max{-1};
+  for (const group_item_t &item : group)
+    if (item.index > index_max) index_max = item.index;
+  group_item_t invalid;
+  invalid.index = INDEX_INVALID;
+  group_conf_.assign(static_cast<size_t>(index_max + 1), invalid);
+  group_data_.assign(group_conf_.size(), nullptr);
   for (size_t i = 0; i < group.size(); ++i) {
     const group_item_t &item = group[i];
+    if (item.index < 0) continue;
     group_item_t temp;
     temp.index = item.index;
-    temp.position = static_cast<uint32_t>(size_);
+    temp.position = size_;
     temp.size = item.size;
     temp.header_size = item.header_size;
     temp.data_size = item.data_size;
     temp.same_header = item.same_header;
-    group_conf_[item.index] = temp;
+    temp.name = item.name;
+    temp.stride = 
+      item.same_header ? item.data_size : item.header_size + item.data_size;
+    temp.data_offset = sizeof(group_item_header_t) + item.header_size;
     size_t _size{0};
     if (item.same_header) {
       _size = sizeof(group_item_header_t) + 
@@ -390,8 +603,9 @@ GroupPool::GroupPool(uint32_t _key, const std::vector<group_item_t> &group) :
               item.data_size * item.size;
     } else {
       _size = sizeof(group_item_header_t) +
-              (item.header_size + item.data_size) * _size;
+              (item.header_size + item.data_size) * item.size;
     }
+    group_conf_[item.index] = temp;
     size_ += _size; 
   }
 }
@@ -405,9 +619,11 @@ bool GroupPool::init(bool create) {
   if (is_null(ref_obj_pointer_)) return false;
   bool result = true;
   bool need_init = false;
-  result = ref_obj_pointer_->attach(key_, size_, false);
+  //The item positions include the group header.
+  auto full_size = sizeof(header_t) + size_;
+  result = ref_obj_pointer_->attach(key_, full_size, false);
   if (create && !result) {
-    result = ref_obj_pointer_->create(key_, size_);
+    result = ref_obj_pointer_->create(key_, full_size);
     need_init = true;
   } else if (!result) {
     return false;
@@ -421,45 +637,63 @@ bool GroupPool::init(bool create) {
     Assert(result);
     return false;
   }
-
+  char *data = ref_obj_pointer_->get();
+  for (size_t i = 0; i < group_conf_.size(); ++i) {
+    if (group_conf_[i].index != static_cast<int16_t>(i)) continue;
+    group_data_[i] = data + group_conf_[i].position;
+  }
   if (need_init) {
-    char *data = ref_obj_pointer_->get();
-    memset(data, 0, size_);
-    auto it = group_conf_.begin();
-    auto it_end = group_conf_.end();
-    for (;it != it_end; ++it) {
-      auto _header = item_header(it->first);
+    //The new pages of the segment are zero already.
+    if (!ref_obj_pointer_->zeroed()) memset(data, 0, size_);
+    for (const group_item_t &item : group_conf_) {
+      if (INDEX_INVALID == item.index) continue;
+      auto _header = item_header(item.index);
       _header->clear();
+      _header->size = static_cast<uint32_t>(item.size);
+      _header->stride = static_cast<uint32_t>(item.stride);
     }
+  } else if (!check_layout()) {
+    return false;
   }
   ready_ = true;
   return true;
 }
 
+bool GroupPool::check_layout() {
+  for (const group_item_t &item : group_conf_) {
+    if (INDEX_INVALID == item.index) continue;
+    auto _header = item_header(item.index);
+    if (_header->size != item.size || _header->stride != item.stride) {
+      SLOW_ERRORLOG(
+          "sharememory",
+          "[sys][sharememory] (GroupPool::check_layout) the item %d layout"
+          " changed, size: %u/%zu, stride: %u/%zu",
+          item.index,
+          _header->size,
+          item.size,
+          _header->stride,
+          item.stride);
+      return false;
+    }
+  }
+  return true;
+}
+
 char *GroupPool::get_data(int16_t index) {
-  if (INDEX_INVALID == index || !is_valid_index(index)) return nullptr;
-  const group_item_t &item = group_conf_[index];
-  return ref_obj_pointer_->get() + sizeof(group_header_t) + item.position;
+  if (!is_valid_index(index)) return nullptr;
+  return group_data_[index];
 }
 
 group_header_t *GroupPool::header() {
   return reinterpret_cast<group_header_t *>(ref_obj_pointer_->get());
 }
    
-char *GroupPool::item_data_header(int16_t index, int16_t data_index) {
-  if (INDEX_INVALID == index || INDEX_INVALID == data_index) return nullptr;
-  if (!is_valid_index(index)) return nullptr;
-  char *data = get_data(index);
+char *GroupPool::item_data_header(int16_t index, int32_t data_index) {
+  if (!is_valid_index(index) || data_index < 0) return nullptr;
   const group_item_t &item = group_conf_[index];
-  char *result = nullptr;
-  size_t header_size = sizeof(group_item_header_t);
   if (static_cast<size_t>(data_index) >= item.size) return nullptr;
-  if (item.same_header) {
-    result = data + header_size;
-  } else {
-    result = 
-      data + header_size + (item.header_size + item.data_size) * data_index;
-  }
+  char *result = group_data_[index] + sizeof(group_item_header_t);
+  if (!item.same_header) result += item.stride * data_index;
   return result;
 }
   
@@ -468,89 +702,63 @@ group_item_header_t *GroupPool::item_header(int16_t index) {
   return reinterpret_cast<group_item_header_t *>(data);
 }
 
-int32_t GroupPool::item_data_postion(int16_t index, int16_t data_index) {
-  if (!is_valid_index(index)) return INDEX_INVALID;
-  int32_t position{INDEX_INVALID};
+int64_t GroupPool::item_data_postion(int16_t index, int32_t data_index) {
+  if (!is_valid_index(index) || data_index < 0) return INDEX_INVALID;
   const group_item_t &item = group_conf_[index];
-  if (item.same_header) {
-    position = static_cast<int32_t>(item.header_size + data_index * item.data_size + 
-               sizeof(group_item_header_t));
-  } else {
-    position = static_cast<int32_t>(item.header_size + 
-               (item.header_size + item.data_size) * data_index +
-               sizeof(group_item_header_t));
-  }
-  return position;
+  return static_cast<int64_t>(item.data_offset + item.stride * data_index);
 }
    
-char *GroupPool::item_data(int16_t index, int16_t data_index) {
-  if (INDEX_INVALID == index || INDEX_INVALID == data_index) return nullptr;
-  if (!is_valid_index(index)) return nullptr;
-  char *data = get_data(index);
+char *GroupPool::item_data(int16_t index, int32_t data_index) {
+  if (!is_valid_index(index) || data_index < 0) return nullptr;
   const group_item_t &item = group_conf_[index];
-  char *result = nullptr;
-  auto position = item_data_postion(index, data_index);
-  auto _size = item.data_size;
-  if (!item.same_header) _size += item.header_size;
-  auto fullsize = item.position + position + _size;
-  Assert(fullsize <= size_);
-  if (fullsize <= size_) {
-    result = data + position;
-  }
-  return result;
+  if (static_cast<size_t>(data_index) >= item.size) return nullptr;
+  return group_data_[index] + item.data_offset + item.stride * data_index;
 }
 
 void GroupPool::free() {
-  for (size_t i = 0; i < group_conf_.size(); ++i) {
-    const group_item_t &item = group_conf_[static_cast<int16_t>(i)];
+  for (const group_item_t &item : group_conf_) {
+    if (INDEX_INVALID == item.index) continue;
     group_item_header_t *_header = item_header(item.index);
     unique_lock< group_item_header_t > auto_lock(*_header, kFlagMixedWrite);
     _header->pool_position = 0;
   }
 }
 
-char *GroupPool::alloc(int16_t index, int16_t &data_index) {
+char *GroupPool::alloc(int16_t index, int32_t &data_index) {
   group_item_header_t *_header = item_header(index);
   Assert(_header);
+  if (is_null(_header)) return nullptr;
   unique_lock<group_item_header_t> auto_lock(*_header, kFlagMixedWrite);
-  char *data = get_data(index);
   const group_item_t &item = group_conf_[index];
-  char *result = nullptr;
   if (static_cast<size_t>(_header->pool_position) >= item.size) return nullptr;
   data_index = _header->pool_position;
-  auto position = item_data_postion(index, data_index);
-  auto _size = item.data_size;
-  if (!item.same_header) _size += item.header_size;
-  auto fullsize = item.position + position + _size;
-  Assert(fullsize <= size_);
-  if (fullsize <= size_) {
-    result = data + position;
-  }
+  char *result = item_data(index, data_index);
   if (is_null(result)) return nullptr;
-  memset(result, 0, _size);
+  //Clear the data with its header.
+  memset(result + item.data_size - item.stride, 0, item.stride);
   _header->pool_position += 1;
   return result;
 }
 
-int16_t GroupPool::free(int16_t index, int16_t data_index) {
+int32_t GroupPool::free(int16_t index, int32_t data_index) {
   group_item_header_t *_header = item_header(index);
   Assert(_header);
+  if (is_null(_header)) return INDEX_INVALID;
   unique_lock<group_item_header_t> auto_lock(*_header, kFlagMixedWrite);
-  const group_item_t &item = group_conf_[index];
   --(_header->pool_position);
   if (data_index >= _header->pool_position) return INDEX_INVALID;
-  size_t header_size{0};
-  if (!item.same_header) {
-    header_size = item.header_size;
-  }
-  char *swap_data = item_data(index, _header->pool_position) - header_size;
-  size_t data_size = header_size + item.data_size;
-  char *delete_data = item_data(index, data_index) - header_size;
-  memset(delete_data, 0, data_size);
-  memcpy(delete_data, swap_data, data_size);
+  move_row(index, _header->pool_position, data_index);
   return _header->pool_position;
 }
 
+void GroupPool::move_row(int16_t index, int32_t from, int32_t to) {
+  const group_item_t &item = group_conf_[index];
+  auto header_size = item.stride - item.data_size;
+  char *swap_data = item_data(index, from) - header_size;
+  char *delete_data = item_data(index, to) - header_size;
+  memcpy(delete_data, swap_data, item.stride);
+}
+
 //functions end --
 
 } //namespace share
@@ -4,7 +4,9 @@
 #include <psapi.h>
 #elif OS_UNIX
 #include <unistd.h>
+#include <dirent.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #endif
 #include "pf/basic/util.h"
 #include "pf/basic/io.tcc"
@@ -223,6 +225,111 @@ bool daemon() {
   return result;
 }
 
+#if OS_UNIX
+//Read a small /proc file into the buffer, the size of the content.
+static size_t read_procfile(const char *filename, char *buffer, size_t size) {
+  FILE *fp = fopen(filename, "r");
+  if (nullptr == fp) return 0;
+  auto result = fread(buffer, 1, size - 1, fp);
+  fclose(fp);
+  buffer[result] = '\0';
+  return result;
+}
+
+//The value of the "name:  value" line in /proc/self/status.
+static uint64_t status_value(const char *status, const char *name) {
+  auto line = strstr(status, name);
+  if (nullptr == line) return 0;
+  return strtoull(line + strlen(name), nullptr, 10);
+}
+#endif
+
+bool get_usage(usage_t &usage) {
+#if OS_UNIX
+  char buffer[4096]{0};
+  if (0 == read_procfile("/proc/self/stat", buffer, sizeof(buffer)))
+    return false;
+  //The name may has spaces, the fields start after the last ')'.
+  auto fields = strrchr(buffer, ')');
+  if (nullptr == fields) return false;
+  uint64_t vsz{0};
+  int64_t rss{0};
+  auto count = sscanf(fields + 2,
+                      "%*c %*d %*d %*d %*d %*d %*u "
+                      "%" SCNu64 " %*u %" SCNu64 " %*u "
+                      "%" SCNu64 " %" SCNu64 " %*d %*d %*d %*d "
+                      "%" SCNu64 " %*d %*u %" SCNu64 " %" SCNd64,
+                      &usage.minflt, &usage.majflt,
+                      &usage.utime, &usage.stime,
+                      &usage.threads, &vsz, &rss);
+  if (count != 7) return false;
+  usage.vsz = vsz / 1024;
+  usage.rss = static_cast<uint64_t>(rss) * (sysconf(_SC_PAGESIZE) / 1024);
+  if (read_procfile("/proc/self/status", buffer, sizeof(buffer)) > 0) {
+    usage.swap = status_value(buffer, "VmSwap:");
+    usage.voluntary_switches = 
+      status_value(buffer, "\nvoluntary_ctxt_switches:");
+    usage.involuntary_switches = 
+      status_value(buffer, "nonvoluntary_ctxt_switches:");
+  }
+  usage.fds = 0;
+  auto dir = opendir("/proc/self/fd");
+  if (dir != nullptr) {
+    while (readdir(dir) != nullptr) ++usage.fds;
+    closedir(dir);
+    usage.fds = usage.fds > 3 ? usage.fds - 3 : 0; //".", ".." and the dir.
+  }
+  if (read_procfile("/proc/stat", buffer, 256) > 0) {
+    uint64_t ticks[8]{0};
+    sscanf(buffer, 
+           "cpu %" SCNu64 " %" SCNu64 " %" SCNu64 " %" SCNu64 
+           " %" SCNu64 " %" SCNu64 " %" SCNu64 " %" SCNu64,
+           &ticks[0], &ticks[1], &ticks[2], &ticks[3], 
+           &ticks[4], &ticks[5], &ticks[6], &ticks[7]);
+    usage.system_total = 0;
+    for (auto tick : ticks) usage.system_total += tick;
+    usage.system_steal = ticks[7];
+  }
+  return true;
+#else
+  UNUSED(usage);
+  return false;
+#endif
+}
+
+bool get_schedstat(int32_t threadid, schedstat_t &stat) {
+#if OS_UNIX
+  char filename[64]{0};
+  char buffer[128]{0};
+  snprintf(
+      filename, sizeof(filename), "/proc/self/task/%d/schedstat", threadid);
+  if (0 == read_procfile(filename, buffer, sizeof(buffer))) return false;
+  return sscanf(buffer, 
+                "%" SCNu64 " %" SCNu64 " %" SCNu64,
+                &stat.run, &stat.delay, &stat.timeslices) == 3;
+#else
+  UNUSED(threadid); UNUSED(stat);
+  return false;
+#endif
+}
+
+int32_t get_threadid() {
+#if OS_UNIX
+  return static_cast<int32_t>(syscall(SYS_gettid));
+#else
+  return static_cast<int32_t>(GetCurrentThreadId());
+#endif
+}
+
+int64_t get_clockticks() {
+#if OS_UNIX
+  static const int64_t ticks = sysconf(_SC_CLK_TCK);
+  return ticks > 0 ? ticks : 100;
+#else
+  return 100;
+#endif
+}
+
 } //namespace process
 
 } //namespace pf_sys
@@ -0,0 +1,153 @@
+#include "pf/basic/logger.h"
+#include "pf/sys/work_pool.h"
+
+namespace pf_sys {
+
+namespace {
+
+//The pool and worker index of the current thread.
+thread_local WorkPool *current_pool = nullptr;
+thread_local size_t current_index = 0;
+
+} //namespace
+
+WorkPool::WorkPool(size_t threads) :
+  pending_{0},
+  sleeping_{0},
+  next_{0},
+  steals_{0},
+  stop_{false} {
+  if (0 == threads) threads = 1;
+  for (int32_t i = 0; i < kTaskPriorityCount; ++i) lane_pending_[i] = 0;
+  for (size_t i = 0; i < threads; ++i) {
+    std::unique_ptr<queue_t> queue(new queue_t);
+    queues_.push_back(std::move(queue));
+  }
+  for (size_t i = 0; i < threads; ++i)
+    workers_.emplace_back([this, i]() { this->work(i); });
+}
+
+WorkPool::~WorkPool() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+  for (std::thread &worker : workers_)
+    worker.join();
+}
+
+bool WorkPool::run_one() {
+  Task task;
+  if (!pop(current(), task)) return false;
+  execute(task);
+  return true;
+}
+
+size_t WorkPool::current() const {
+  return this == current_pool ? current_index : queues_.size();
+}
+
+void WorkPool::push(Task &&task, task_priority_t priority) {
+  auto index = current();
+  if (index >= queues_.size()) index = next_++ % queues_.size();
+  ++lane_pending_[priority]; //Count first, the pop not see a negative.
+  ++pending_;
+  {
+    auto &queue = *queues_[index];
+    std::unique_lock<std::mutex> lock(queue.mutex);
+    queue.lanes[priority].push_back(std::move(task));
+  }
+  notify(1);
+}
+
+void WorkPool::push_bulk(std::vector<Task> &tasks, task_priority_t priority) {
+  if (tasks.empty()) return;
+  auto count = queues_.size();
+  auto start = next_++;
+  auto each = (tasks.size() + count - 1) / count;
+  lane_pending_[priority] += tasks.size();
+  pending_ += tasks.size();
+  size_t position = 0;
+  for (size_t i = 0; i < count && position < tasks.size(); ++i) {
+    auto &queue = *queues_[(start + i) % count];
+    std::unique_lock<std::mutex> lock(queue.mutex);
+    for (size_t n = 0; n < each && position < tasks.size(); ++n)
+      queue.lanes[priority].push_back(std::move(tasks[position++]));
+  }
+  notify(tasks.size());
+}
+
+void WorkPool::notify(size_t count) {
+  if (0 == sleeping_) return;
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (1 == count) {
+    condition_.notify_one();
+  } else {
+    condition_.notify_all();
+  }
+}
+
+bool WorkPool::pop(size_t index, Task &task) {
+  if (0 == pending_) return false;
+  for (int32_t lane = 0; lane < kTaskPriorityCount; ++lane) {
+    if (0 == lane_pending_[lane]) continue;
+    if (index < queues_.size() && pop_lane(index, lane, false, task))
+      return true;
+    auto count = queues_.size();
+    for (size_t i = 1; i <= count; ++i) {
+      auto victim = (index + i) % count;
+      if (victim == index) continue;
+      if (pop_lane(victim, lane, true, task)) {
+        if (index < count) ++steals_;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool WorkPool::pop_lane(size_t index, int32_t lane, bool steal, Task &task) {
+  auto &queue = *queues_[index];
+  std::unique_lock<std::mutex> lock(queue.mutex);
+  auto &tasks = queue.lanes[lane];
+  if (tasks.empty()) return false;
+  //The owner takes the oldest, the thief takes the newest.
+  if (steal) {
+    task = std::move(tasks.back());
+    tasks.pop_back();
+  } else {
+    task = std::move(tasks.front());
+    tasks.pop_front();
+  }
+  --lane_pending_[lane];
+  --pending_;
+  return true;
+}
+
+void WorkPool::execute(Task &task) {
+  try {
+    task();
+  } catch (...) {
+    SaveErrorLog();
+  }
+}
+
+void WorkPool::work(size_t index) {
+  current_pool = this;
+  current_index = index;
+  for (;;) {
+    Task task;
+    if (pop(index, task)) {
+      execute(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++sleeping_;
+    condition_.wait(lock, [this]() { return stop_ || pending_ > 0; });
+    --sleeping_;
+    if (stop_ && 0 == pending_) return;
+  }
+}
+
+} //namespace pf_sys
@@ -3,12 +3,29 @@
 
 using namespace pf_util::compressor;
 
+static const double kRollingWeight = 0.125; //The weight of the new frame.
+static const int32_t kSmallScoreLimit = 8;
+
 Assistant::Assistant()
   : workmemory_{nullptr},
   isenable_{false},
   log_isenable_{false},
   compressframe_{0},
-  compressframe_success_{0} {
+  compressframe_success_{0},
+  adaptive_{false},
+  active_{true},
+  frame_min_{UTIL_COMPRESSOR_ASSISTANT_FRAME_MIN},
+  ratio_max_{UTIL_COMPRESSOR_ASSISTANT_RATIO_MAX},
+  cost_max_{UTIL_COMPRESSOR_ASSISTANT_COST_MAX},
+  ratio_{0.0},
+  cpu_per_byte_{0.0},
+  probe_interval_{UTIL_COMPRESSOR_ASSISTANT_PROBE_MIN},
+  probe_countdown_{0},
+  small_score_{0},
+  skipped_{0},
+  probes_{0},
+  bytes_in_{0},
+  bytes_out_{0} {
 }
 
 Assistant::~Assistant() {
@@ -20,7 +37,102 @@ void Assistant::enable(bool _enable, uint64_t threadid) {
     if (!UTIL_COMPRESSOR_MINIMANAGER_POINTER ||
         nullptr == UTIL_COMPRESSOR_MINIMANAGER_POINTER->alloc(threadid)) {
       isenable_ = false;
+      return;
     }
   }
   isenable_ = _enable;
 }
+
+bool Assistant::should_compress(uint32_t insize) {
+  if (!adaptive_) return true;
+  if (insize < frame_min_) {
+    ++skipped_;
+    return false;
+  }
+  if (active_) return true;
+  if (probe_countdown_ > 0) {
+    --probe_countdown_;
+    ++skipped_;
+    return false;
+  }
+  ++probes_;
+  return true;
+}
+
+void Assistant::feedback(uint32_t insize, 
+                         uint32_t outsize, 
+                         uint64_t nanoseconds) {
+  if (0 == insize) return;
+  if (0 == outsize || outsize > insize) outsize = insize; //Failed, sent raw.
+  bool first = 0 == bytes_in_;
+  bytes_in_ += insize;
+  bytes_out_ += outsize;
+  double ratio = static_cast<double>(outsize) / insize;
+  double cpu_per_byte = static_cast<double>(nanoseconds) / insize;
+  if (first) {
+    ratio_ = ratio;
+    cpu_per_byte_ = cpu_per_byte;
+  } else {
+    ratio_ += (ratio - ratio_) * kRollingWeight;
+    cpu_per_byte_ += (cpu_per_byte - cpu_per_byte_) * kRollingWeight;
+  }
+  if (!adaptive_) return;
+  bool good = ratio <= ratio_max_;
+  tune_frame_min(insize, good);
+  if (worth()) {
+    active_ = true;
+    probe_interval_ = UTIL_COMPRESSOR_ASSISTANT_PROBE_MIN;
+  } else {
+    if (!active_ && probe_interval_ < UTIL_COMPRESSOR_ASSISTANT_PROBE_MAX)
+      probe_interval_ *= 2; //The probe failed again.
+    active_ = false;
+    probe_countdown_ = probe_interval_;
+  }
+}
+
+void Assistant::reset() {
+  compressframe_ = compressframe_success_ = 0;
+  active_ = true;
+  frame_min_ = UTIL_COMPRESSOR_ASSISTANT_FRAME_MIN;
+  ratio_ = cpu_per_byte_ = 0.0;
+  probe_interval_ = UTIL_COMPRESSOR_ASSISTANT_PROBE_MIN;
+  probe_countdown_ = 0;
+  small_score_ = 0;
+  skipped_ = probes_ = bytes_in_ = bytes_out_ = 0;
+}
+
+Assistant::stat_t Assistant::get_stat() const {
+  stat_t stat;
+  stat.frames = compressframe_;
+  stat.success = compressframe_success_;
+  stat.skipped = skipped_;
+  stat.probes = probes_;
+  stat.bytes_in = bytes_in_;
+  stat.bytes_out = bytes_out_;
+  stat.ratio = ratio_;
+  stat.cpu_per_byte = cpu_per_byte_;
+  stat.frame_min = frame_min_;
+  stat.active = active_;
+  return stat;
+}
+
+//The cost of one saved byte must be cheap enough.
+bool Assistant::worth() const {
+  if (ratio_ > ratio_max_) return false;
+  double saved = 1.0 - ratio_;
+  if (saved <= 0.0) return false;
+  return cpu_per_byte_ / saved <= cost_max_;
+}
+
+//The frames near the min decide it up or down.
+void Assistant::tune_frame_min(uint32_t insize, bool good) {
+  if (insize >= frame_min_ * 2) return;
+  small_score_ += good ? 1 : -1;
+  if (small_score_ >= kSmallScoreLimit) {
+    small_score_ = 0;
+    if (frame_min_ / 2 >= UTIL_COMPRESSOR_ASSISTANT_FRAME_MIN) frame_min_ /= 2;
+  } else if (small_score_ <= -kSmallScoreLimit) {
+    small_score_ = 0;
+    if (frame_min_ * 2 <= UTIL_COMPRESSOR_ASSISTANT_FRAME_MAX) frame_min_ *= 2;
+  }
+}
@@ -0,0 +1,176 @@
+#include "pf/util/compressor/minimanager.h"
+#include "pf/util/compressor/lz4.h"
+#include "pf/util/compressor/codec.h"
+
+namespace pf_util {
+
+namespace compressor {
+
+class LzoCodec : public Codec {
+
+ public:
+   virtual uint8_t id() const { return kCodecLzo; }
+   virtual const char *name() const { return "lzo"; }
+   virtual uint32_t bound(uint32_t insize) const {
+     return insize + insize / 16 + 64 + 3;
+   }
+   virtual bool compress(CodecContext *,
+                         const unsigned char *in,
+                         uint32_t insize,
+                         unsigned char *out,
+                         uint32_t &outsize) const {
+     if (outsize < bound(insize)) return false;
+     lzo_uint _outsize = outsize;
+     int32_t result = lzo1x_1_compress(
+         in, insize, out, &_outsize, MiniManager::alloc());
+     outsize = static_cast<uint32_t>(_outsize);
+     return LZO_E_OK == result && outsize + 2 < insize;
+   }
+   virtual bool decompress(CodecContext *,
+                           const unsigned char *in,
+                           uint32_t insize,
+                           unsigned char *out,
+                           uint32_t &outsize) const {
+     lzo_uint _outsize = outsize;
+     int32_t result =
+       lzo1x_decompress_safe(in, insize, out, &_outsize, nullptr);
+     outsize = static_cast<uint32_t>(_outsize);
+     return LZO_E_OK == result;
+   }
+
+};
+
+class Lz4Codec : public Codec {
+
+ public:
+   virtual uint8_t id() const { return kCodecLz4; }
+   virtual const char *name() const { return "lz4"; }
+   virtual uint32_t bound(uint32_t insize) const {
+     return UTIL_COMPRESSOR_LZ4_GET_OUTLENGTH(insize);
+   }
+   virtual bool compress(CodecContext *,
+                         const unsigned char *in,
+                         uint32_t insize,
+                         unsigned char *out,
+                         uint32_t &outsize) const {
+     outsize = lz4::compress(in, insize, out, outsize);
+     return outsize != 0 && outsize + 2 < insize;
+   }
+   virtual bool decompress(CodecContext *,
+                           const unsigned char *in,
+                           uint32_t insize,
+                           unsigned char *out,
+                           uint32_t &outsize) const {
+     int32_t result = lz4::decompress(in, insize, out, outsize);
+     if (result < 0) return false;
+     outsize = static_cast<uint32_t>(result);
+     return true;
+   }
+
+};
+
+class Lz4StreamContext : public CodecContext {
+
+ public:
+   explicit Lz4StreamContext(uint32_t frame_max) : stream(frame_max) {}
+
+ public:
+   lz4::Stream stream;
+
+};
+
+class Lz4StreamCodec : public Lz4Codec {
+
+ public:
+   virtual uint8_t id() const { return kCodecLz4Stream; }
+   virtual const char *name() const { return "lz4-stream"; }
+   virtual CodecContext *create_context(uint32_t frame_max) const {
+     return new Lz4StreamContext(frame_max);
+   }
+   virtual bool compress(CodecContext *context,
+                         const unsigned char *in,
+                         uint32_t insize,
+                         unsigned char *out,
+                         uint32_t &outsize) const {
+     if (is_null(context))
+       return Lz4Codec::compress(context, in, insize, out, outsize);
+     lz4::Stream &stream = static_cast<Lz4StreamContext *>(context)->stream;
+     outsize = stream.compress(in, insize, out, outsize);
+     if (0 == outsize || outsize + 2 >= insize) return false;
+     stream.commit(insize); //Only the sent frame can be the dictionary.
+     return true;
+   }
+   virtual bool decompress(CodecContext *context,
+                           const unsigned char *in,
+                           uint32_t insize,
+                           unsigned char *out,
+                           uint32_t &outsize) const {
+     if (is_null(context))
+       return Lz4Codec::decompress(context, in, insize, out, outsize);
+     lz4::Stream &stream = static_cast<Lz4StreamContext *>(context)->stream;
+     int32_t result = stream.decompress(in, insize, out, outsize);
+     if (result < 0) return false;
+     outsize = static_cast<uint32_t>(result);
+     return true;
+   }
+
+};
+
+namespace codec {
+
+//The prefer order when negotiate.
+static const uint8_t kPreferOrder[] = {
+  kCodecLz4Stream, kCodecLz4, kCodecLzo
+};
+
+static Codec **codecs() {
+  static Codec *list[UTIL_COMPRESSOR_CODEC_MAX] = {nullptr};
+  static std::once_flag flag;
+  std::call_once(flag, []() {
+    lzo_init();
+    static LzoCodec lzo;
+    static Lz4Codec lz4;
+    static Lz4StreamCodec lz4stream;
+    list[lzo.id()] = &lzo;
+    list[lz4.id()] = &lz4;
+    list[lz4stream.id()] = &lz4stream;
+  });
+  return list;
+}
+
+void add(Codec *codec) {
+  if (is_null(codec) || codec->id() >= UTIL_COMPRESSOR_CODEC_MAX) return;
+  codecs()[codec->id()] = codec;
+}
+
+Codec *get(uint8_t id) {
+  if (id >= UTIL_COMPRESSOR_CODEC_MAX) return nullptr;
+  return codecs()[id];
+}
+
+uint32_t mask() {
+  uint32_t result = 0;
+  Codec **list = codecs();
+  for (uint8_t i = 0; i < UTIL_COMPRESSOR_CODEC_MAX; ++i) {
+    if (!is_null(list[i])) result |= 1U << i;
+  }
+  return result;
+}
+
+uint8_t negotiate(uint32_t local_mask, uint32_t remote_mask) {
+  uint32_t both = local_mask & remote_mask & mask();
+  for (uint8_t id : kPreferOrder) {
+    if (both & (1U << id)) return id;
+  }
+  //The custom codecs, the bigger id first.
+  for (int32_t i = UTIL_COMPRESSOR_CODEC_MAX - 1; i > kCodecNone; --i) {
+    if (both & (1U << i)) return static_cast<uint8_t>(i);
+  }
+  return kCodecNone;
+}
+
+} //namespace codec
+
+} //namespace compressor
+
+} //namespace pf_util
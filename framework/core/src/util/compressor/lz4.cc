@@ -0,0 +1,256 @@
+#include <algorithm>
+#include "pf/util/compressor/lz4.h"
+
+namespace pf_util {
+
+namespace compressor {
+
+namespace lz4 {
+
+static const uint32_t kMinMatch = 4;
+static const uint32_t kLastLiterals = 5; //The last bytes are literals.
+static const uint32_t kMFLimit = 12; //The last match start before it.
+static const uint32_t kDistanceMax = 65535;
+
+inline uint32_t read32(const unsigned char *p) {
+  uint32_t result;
+  memcpy(&result, p, sizeof(result));
+  return result;
+}
+
+inline uint32_t hash(uint32_t value) {
+  return (value * 2654435761U) >> (32 - UTIL_COMPRESSOR_LZ4_HASHLOG);
+}
+
+inline unsigned char *write_length(unsigned char *op, uint32_t length) {
+  while (length >= 255) {
+    *op++ = 255;
+    length -= 255;
+  }
+  *op++ = static_cast<unsigned char>(length);
+  return op;
+}
+
+//Compress base[start, start + insize), the matches can reference back to
+//base[low], the table keep the positions from base.
+static uint32_t compress_generic(const unsigned char *base,
+                                 uint32_t low,
+                                 uint32_t start,
+                                 uint32_t insize,
+                                 unsigned char *out,
+                                 uint32_t outcapacity,
+                                 uint32_t *table) {
+  const unsigned char *ip = base + start;
+  const unsigned char *anchor = ip;
+  const unsigned char *iend = ip + insize;
+  const unsigned char *mflimit = iend - kMFLimit;
+  const unsigned char *matchlimit = iend - kLastLiterals;
+  const unsigned char *lowlimit = base + low;
+  unsigned char *op = out;
+  unsigned char *oend = out + outcapacity;
+  uint32_t misses = 0;
+  if (insize > kMFLimit) {
+    while (ip < mflimit) {
+      uint32_t sequence = read32(ip);
+      uint32_t h = hash(sequence);
+      const unsigned char *ref = base + table[h];
+      table[h] = static_cast<uint32_t>(ip - base);
+      if (ref < lowlimit || ref >= ip ||
+          static_cast<uint32_t>(ip - ref) > kDistanceMax ||
+          read32(ref) != sequence) {
+        ip += 1 + (misses++ >> 6); //Skip faster the incompressible data.
+        continue;
+      }
+      misses = 0;
+      while (ip > anchor && ref > lowlimit && ip[-1] == ref[-1]) {
+        --ip;
+        --ref;
+      }
+      const unsigned char *mp = ip + kMinMatch;
+      const unsigned char *rp = ref + kMinMatch;
+      while (mp < matchlimit && *mp == *rp) {
+        ++mp;
+        ++rp;
+      }
+      uint32_t litlength = static_cast<uint32_t>(ip - anchor);
+      uint32_t matchlength = static_cast<uint32_t>(mp - ip) - kMinMatch;
+      if (op + 1 + litlength + litlength / 255 + 1 + 2 + matchlength / 255 + 1
+          + 1 + kLastLiterals > oend) return 0;
+      unsigned char *token = op++;
+      if (litlength >= 15) {
+        *token = 15 << 4;
+        op = write_length(op, litlength - 15);
+      } else {
+        *token = static_cast<unsigned char>(litlength << 4);
+      }
+      memcpy(op, anchor, litlength);
+      op += litlength;
+      uint32_t offset = static_cast<uint32_t>(ip - ref);
+      *op++ = static_cast<unsigned char>(offset & 0xff);
+      *op++ = static_cast<unsigned char>(offset >> 8);
+      if (matchlength >= 15) {
+        *token |= 15;
+        op = write_length(op, matchlength - 15);
+      } else {
+        *token |= static_cast<unsigned char>(matchlength);
+      }
+      ip = anchor = mp;
+      if (ip < mflimit)
+        table[hash(read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - base);
+    }
+  }
+  uint32_t litlength = static_cast<uint32_t>(iend - anchor);
+  if (op + 1 + litlength + litlength / 255 + 1 > oend) return 0;
+  unsigned char *token = op++;
+  if (litlength >= 15) {
+    *token = 15 << 4;
+    op = write_length(op, litlength - 15);
+  } else {
+    *token = static_cast<unsigned char>(litlength << 4);
+  }
+  memcpy(op, anchor, litlength);
+  op += litlength;
+  return static_cast<uint32_t>(op - out);
+}
+
+inline bool read_length(const unsigned char *&ip,
+                        const unsigned char *iend,
+                        uint32_t &length) {
+  uint32_t value = 0;
+  do {
+    if (ip >= iend) return false;
+    value = *ip++;
+    length += value;
+    if (length > 0x7fffffff) return false;
+  } while (255 == value);
+  return true;
+}
+
+//Decompress to base[start, start + outcapacity), the matches can reference
+//back to base[low].
+static int32_t decompress_generic(const unsigned char *in,
+                                  uint32_t insize,
+                                  unsigned char *base,
+                                  uint32_t low,
+                                  uint32_t start,
+                                  uint32_t outcapacity) {
+  const unsigned char *ip = in;
+  const unsigned char *iend = in + insize;
+  unsigned char *op = base + start;
+  unsigned char *oend = op + outcapacity;
+  const unsigned char *lowlimit = base + low;
+  if (0 == insize) return -1;
+  for (;;) {
+    uint32_t token = *ip++;
+    uint32_t length = token >> 4;
+    if (15 == length && !read_length(ip, iend, length)) return -1;
+    if (length > static_cast<uint32_t>(iend - ip) ||
+        length > static_cast<uint32_t>(oend - op)) return -1;
+    memcpy(op, ip, length);
+    op += length;
+    ip += length;
+    if (ip == iend) break; //The last literals.
+    if (iend - ip < 2) return -1;
+    uint32_t offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (0 == offset || offset > static_cast<uint32_t>(op - lowlimit))
+      return -1;
+    length = token & 15;
+    if (15 == length && !read_length(ip, iend, length)) return -1;
+    length += kMinMatch;
+    if (length > static_cast<uint32_t>(oend - op)) return -1;
+    const unsigned char *ref = op - offset;
+    if (offset >= length) {
+      memcpy(op, ref, length);
+      op += length;
+    } else { //Overlap copy, repeat the pattern.
+      for (uint32_t i = 0; i < length; ++i) *op++ = *ref++;
+    }
+    if (ip >= iend) return -1;
+  }
+  return static_cast<int32_t>(op - (base + start));
+}
+
+uint32_t compress(const unsigned char *in,
+                  uint32_t insize,
+                  unsigned char *out,
+                  uint32_t outcapacity) {
+  uint32_t table[UTIL_COMPRESSOR_LZ4_HASH_SIZE];
+  memset(table, 0, sizeof(table));
+  return compress_generic(in, 0, 0, insize, out, outcapacity, table);
+}
+
+int32_t decompress(const unsigned char *in,
+                   uint32_t insize,
+                   unsigned char *out,
+                   uint32_t outcapacity) {
+  return decompress_generic(in, insize, out, 0, 0, outcapacity);
+}
+
+Stream::Stream(uint32_t frame_max) :
+  frame_max_{frame_max},
+  buffer_(UTIL_COMPRESSOR_LZ4_WINDOW * 2 + frame_max), //Slide less.
+  table_(UTIL_COMPRESSOR_LZ4_HASH_SIZE, 0),
+  position_{0} {
+}
+
+Stream::~Stream() {
+  //do nothing
+}
+
+void Stream::reset() {
+  std::fill(table_.begin(), table_.end(), 0);
+  position_ = 0;
+}
+
+uint32_t Stream::compress(const unsigned char *in,
+                          uint32_t insize,
+                          unsigned char *out,
+                          uint32_t outcapacity) {
+  if (insize > frame_max_) return 0;
+  slide();
+  memcpy(&buffer_[position_], in, insize);
+  uint32_t low =
+    position_ > UTIL_COMPRESSOR_LZ4_WINDOW ?
+    position_ - UTIL_COMPRESSOR_LZ4_WINDOW : 0;
+  return compress_generic(
+      &buffer_[0], low, position_, insize, out, outcapacity, &table_[0]);
+}
+
+void Stream::commit(uint32_t insize) {
+  position_ += insize;
+}
+
+int32_t Stream::decompress(const unsigned char *in,
+                           uint32_t insize,
+                           unsigned char *out,
+                           uint32_t outcapacity) {
+  slide();
+  uint32_t low =
+    position_ > UTIL_COMPRESSOR_LZ4_WINDOW ?
+    position_ - UTIL_COMPRESSOR_LZ4_WINDOW : 0;
+  int32_t result = decompress_generic(
+      in, insize, &buffer_[0], low, position_, frame_max_);
+  if (result < 0 || static_cast<uint32_t>(result) > outcapacity) return -1;
+  memcpy(out, &buffer_[position_], result);
+  position_ += result;
+  return result;
+}
+
+//Both sides slide at the same position, keep the last window as dictionary.
+void Stream::slide() {
+  if (position_ + frame_max_ <= buffer_.size()) return;
+  uint32_t keep =
+    position_ > UTIL_COMPRESSOR_LZ4_WINDOW ?
+    UTIL_COMPRESSOR_LZ4_WINDOW : position_;
+  uint32_t delta = position_ - keep;
+  memmove(&buffer_[0], &buffer_[delta], keep);
+  for (auto &value : table_) value = value > delta ? value - delta : 0;
+  position_ = keep;
+}
+
+} //namespace lz4
+
+} //namespace compressor
+
+} //namespace pf_util
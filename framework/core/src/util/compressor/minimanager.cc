@@ -20,13 +20,7 @@ MiniManager &MiniManager::getsingleton() {
 
 MiniManager::MiniManager()
   : log_isenable_{false},
-  workmemory_size_{0},
-  uncompress_size_{0},
-  compress_size_{0} {
-  for (uint16_t i = 0; i < UTIL_COMPRESSOR_MINI_MANAGER_THREAD_SIZEMAX; ++i) {
-    workmemory_[i].pointer = nullptr;
-    workmemory_[i].threadid = 0;
-  }
+  shard_index_{0} {
 }
 
 MiniManager::~MiniManager() {
@@ -39,29 +33,38 @@ bool MiniManager::init() {
 }
 
 void MiniManager::destory() {
-  workmemory_size_ = 0;
-  uncompress_size_ = 0;
-  compress_size_ = 0;
-  for (uint16_t i = 0; i < UTIL_COMPRESSOR_MINI_MANAGER_THREAD_SIZEMAX; ++i) {
-    char *pointer = reinterpret_cast<char *>(workmemory_[i].pointer);
-    safe_delete_array(pointer);
-    workmemory_[i].threadid = 0;
+  for (uint32_t i = 0; i < UTIL_COMPRESSOR_MINI_MANAGER_STAT_SHARDS; ++i) {
+    stat_shards_[i].compress_size = 0;
+    stat_shards_[i].uncompress_size = 0;
+    stat_shards_[i].compress_count = 0;
   }
 }
 
-void *MiniManager::alloc(uint64_t threadid) {
-  std::unique_lock<std::mutex> autolock(mutex_);
-  for (uint16_t i = 0; i < UTIL_COMPRESSOR_MINI_MANAGER_THREAD_SIZEMAX; ++i) {
-    if (workmemory_[i].threadid == threadid) return workmemory_[i].pointer;
+void *MiniManager::alloc(uint64_t) {
+  //Freed when the thread exit.
+  static thread_local std::unique_ptr<lzo_align_t[]> workmemory{
+    new lzo_align_t[UTIL_COMPRESSOR_MINI_MANAGER_WORK_MEMORY_SIZE]};
+  return workmemory.get();
+}
+
+MiniManager::stat_t MiniManager::snapshot() const {
+  stat_t stat;
+  for (uint32_t i = 0; i < UTIL_COMPRESSOR_MINI_MANAGER_STAT_SHARDS; ++i) {
+    const stat_shard_t &shard = stat_shards_[i];
+    stat.compress_size += shard.compress_size.load(std::memory_order_relaxed);
+    stat.uncompress_size += 
+      shard.uncompress_size.load(std::memory_order_relaxed);
+    stat.compress_count += 
+      shard.compress_count.load(std::memory_order_relaxed);
   }
-  if (workmemory_size_ > UTIL_COMPRESSOR_MINI_MANAGER_THREAD_SIZEMAX) 
-    return nullptr;
-  lzo_align_t* workmemory = 
-    new lzo_align_t[UTIL_COMPRESSOR_MINI_MANAGER_WORK_MEMORY_SIZE];
-  workmemory_[workmemory_size_].pointer = workmemory;
-  workmemory_[workmemory_size_].threadid = threadid;
-  ++workmemory_size_;
-  return workmemory;
+  return stat;
+}
+
+MiniManager::stat_shard_t &MiniManager::getshard() {
+  static thread_local uint32_t index = 
+    shard_index_.fetch_add(1, std::memory_order_relaxed) % 
+    UTIL_COMPRESSOR_MINI_MANAGER_STAT_SHARDS;
+  return stat_shards_[index];
 }
 
 bool MiniManager::compress(const unsigned char *in,
@@ -69,8 +72,10 @@ bool MiniManager::compress(const unsigned char *in,
                            unsigned char *out,
                            uint32_t &outsize,
                            void *workmemory) {
-  int32_t result = 
-    lzo1x_1_compress(in, insize, out, (lzo_uint *)&outsize, workmemory);
+  if (is_null(workmemory)) workmemory = alloc();
+  lzo_uint _outsize = outsize;
+  int32_t result = lzo1x_1_compress(in, insize, out, &_outsize, workmemory);
+  outsize = static_cast<uint32_t>(_outsize);
   if (result != LZO_E_OK || outsize + 2 >= insize) return false;
   return true;
 }
@@ -79,7 +84,8 @@ int32_t MiniManager::decompress(const unsigned char *in,
                                 uint32_t insize,
                                 unsigned char *out,
                                 uint32_t &outsize) {
-  int32_t result = 
-    lzo1x_decompress(in, insize, out, (lzo_uint *)&outsize, nullptr);
+  lzo_uint _outsize = outsize;
+  int32_t result = lzo1x_decompress(in, insize, out, &_outsize, nullptr);
+  outsize = static_cast<uint32_t>(_outsize);
   return result;
 }
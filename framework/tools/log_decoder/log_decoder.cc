@@ -0,0 +1,61 @@
+#include "pf/basic/binary_log.h"
+
+//Usage: log_decoder file.blog [file.blog ...] [--output=file.log]
+//Render the binary logs(GLOBALS["log.binary_file"]) to the text lines as the
+//text logs, the formats are defined in each file by the format records.
+
+static bool read_file(const char *filename, std::string &data) {
+  FILE *fp = fopen(filename, "rb");
+  if (nullptr == fp) return false;
+  char buffer[64 * 1024];
+  size_t size{0};
+  while ((size = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+    data.append(buffer, size);
+  fclose(fp);
+  return true;
+}
+
+int32_t main(int32_t argc, char *argv[]) {
+  std::vector<const char *> filenames;
+  const char *output{nullptr};
+  for (int32_t i = 1; i < argc; ++i) {
+    if (0 == strncmp(argv[i], "--output=", 9)) {
+      output = argv[i] + 9;
+    } else {
+      filenames.push_back(argv[i]);
+    }
+  }
+  if (filenames.empty()) {
+    fprintf(stderr, "usage: %s file.blog [...] [--output=file.log]\n", argv[0]);
+    return 1;
+  }
+  FILE *out = is_null(output) ? stdout : fopen(output, "wb");
+  if (is_null(out)) {
+    fprintf(stderr, "can't open the output: %s\n", output);
+    return 1;
+  }
+  int32_t result{0};
+  for (auto filename : filenames) {
+    std::string data;
+    if (!read_file(filename, data)) {
+      fprintf(stderr, "can't read the file: %s\n", filename);
+      result = 1;
+      continue;
+    }
+    std::map<uint32_t, std::string> formats;
+    std::string text;
+    auto size = pf_basic::binary_log::decode(
+        data.data(), data.size(), text, &formats);
+    fwrite(text.data(), 1, text.size(), out);
+    if (size != data.size()) {
+      fprintf(stderr,
+              "%s: broken record at %zu of %zu bytes\n",
+              filename,
+              size,
+              data.size());
+      result = 1;
+    }
+  }
+  if (out != stdout) fclose(out);
+  return result;
+}
@@ -0,0 +1,237 @@
+#include "gtest/gtest.h"
+#include "pf/basic/global.h"
+#include "pf/basic/logger.h"
+#include "pf/basic/binary_log.h"
+
+using namespace pf_basic;
+
+class BasicBinaryLog : public testing::Test {
+
+ public:
+   //The text of the printf.
+   static std::string print(const char *format, ...) {
+     char buffer[binary_log::kRecordMax]{0};
+     va_list argptr;
+     va_start(argptr, format);
+     vsnprintf(buffer, sizeof(buffer), format, argptr);
+     va_end(argptr);
+     return buffer;
+   }
+
+   //The text of the record encoded and rendered.
+   template <typename... Args>
+   static std::string render(const char *format, const Args &... args) {
+     char record[binary_log::kRecordMax];
+     auto length =
+       binary_log::encode(record, sizeof(record), 0, format, args...);
+     if (0 == length) return "(encode failed)";
+     std::string text;
+     binary_log::render(format,
+                        record + sizeof(binary_log::header_t),
+                        length - sizeof(binary_log::header_t),
+                        text);
+     return text;
+   }
+
+   //All the integer conversions and flags of the modifier with the values.
+   template <typename T>
+   static void integers(const char *modifier,
+                        const std::vector<int64_t> &values) {
+     const char *flags[] =
+       {"", "-", "+", " ", "#", "0", "8", "-8", "08", ".3", "+10.4", "#012"};
+     const char *conversions = "diouxX";
+     for (const char *flag : flags) {
+       for (const char *c = conversions; *c != '\0'; ++c) {
+         std::string format{"["};
+         format = format + "%" + flag + modifier + *c + "]";
+         for (int64_t value : values) {
+           auto arg = static_cast<T>(value);
+           ASSERT_EQ(print(format.c_str(), arg), render(format.c_str(), arg))
+             << format << " " << value;
+         }
+       }
+     }
+   }
+
+   //The name of the binary file of the log.
+   static std::string blog_filename(const char *logname) {
+     char filename[FILENAME_MAX]{0};
+     Logger::get_log_filename(logname, filename);
+     auto extension = strrchr(filename, '.');
+     if (extension)
+       snprintf(extension, sizeof(filename) - (extension - filename), ".blog");
+     return filename;
+   }
+
+};
+
+TEST_F(BasicBinaryLog, testIntegers) {
+  std::vector<int64_t> values =
+    {0, 1, -1, 7, 127, 128, 255, 256, 300, 32767, -32768, 65535, 70000,
+     2147483647LL, -2147483647LL - 1, 4000000000LL, 4294967295LL,
+     9223372036854775807LL, -9223372036854775807LL - 1};
+  integers<int>("", values);
+  integers<unsigned int>("", values);
+  integers<int>("hh", values);
+  integers<int>("h", values);
+  integers<long>("l", values);
+  integers<unsigned long>("l", values);
+  integers<long long>("ll", values);
+  integers<unsigned long long>("ll", values);
+  integers<size_t>("z", values);
+  integers<intmax_t>("j", values);
+  integers<ptrdiff_t>("t", values);
+  integers<int8_t>("", values);
+  integers<uint16_t>("", values);
+}
+
+TEST_F(BasicBinaryLog, testMismatchedSign) {
+  //The argument read as the conversion says, the same as the printf.
+  ASSERT_EQ("4294967295", render("%u", -1));
+  ASSERT_EQ("-294967296", render("%d", 4000000000u));
+  ASSERT_EQ("ffffffff", render("%x", -1));
+  ASSERT_EQ("44", render("%hhd", 300));
+  ASSERT_EQ("4464", render("%hu", 70000));
+  ASSERT_EQ(print("%" PRIu64, static_cast<uint64_t>(-1)),
+            render("%" PRIu64, static_cast<uint64_t>(-1)));
+  ASSERT_EQ(print("%" PRId64, INT64_MIN), render("%" PRId64, INT64_MIN));
+}
+
+TEST_F(BasicBinaryLog, testOthers) {
+  const char *floats[] = {"%f", "%.2f", "%10.3f", "%-10.1f|", "%+e", "%E",
+                          "%g", "%G", "%#g", "%a", "%A", "%08.2f", "%F"};
+  double doubles[] = {0.0, 1.5, -2.25, 123456.789, 1e-10, 3.0e20};
+  for (const char *format : floats) {
+    for (double value : doubles)
+      ASSERT_EQ(print(format, value), render(format, value)) << format;
+  }
+  ASSERT_EQ(print("%f", 1.5f), render("%f", 1.5f));
+  ASSERT_EQ(print("%Lf", 2.5L), render("%Lf", 2.5L));
+  const char *strings[] = {"%s", "[%10s]", "[%-10s]", "[%.3s]", "[%8.2s]"};
+  for (const char *format : strings) {
+    ASSERT_EQ(print(format, "player"), render(format, "player")) << format;
+    ASSERT_EQ(print(format, ""), render(format, "")) << format;
+  }
+  std::string name{"sword"};
+  char buffer[16]{0};
+  snprintf(buffer, sizeof(buffer), "shield");
+  ASSERT_EQ(print("%s %s", name.c_str(), buffer),
+            render("%s %s", name.c_str(), buffer));
+  ASSERT_EQ(print("[%c][%-3c][%3c]", 'a', 'b', 'c'),
+            render("[%c][%-3c][%3c]", 'a', 'b', 'c'));
+  int32_t value{0};
+  ASSERT_EQ(print("%p", &value), render("%p", &value));
+  ASSERT_EQ(print("%p", static_cast<void *>(nullptr)),
+            render("%p", static_cast<void *>(nullptr)));
+  ASSERT_EQ(print("100%% %d%%", 5), render("100%% %d%%", 5));
+  ASSERT_EQ(print("[%*d][%-*d]", 6, 42, 6, 42),
+            render("[%*d][%-*d]", 6, 42, 6, 42));
+  ASSERT_EQ(print("[%.*f][%*.*s]", 2, 3.14159, 8, 3, "player"),
+            render("[%.*f][%*.*s]", 2, 3.14159, 8, 3, "player"));
+  ASSERT_EQ(print("%d %s %.1f %u %c", -3, "mix", 0.5, 9u, 'z'),
+            render("%d %s %.1f %u %c", -3, "mix", 0.5, 9u, 'z'));
+  ASSERT_EQ("no arguments", render("no arguments"));
+}
+
+TEST_F(BasicBinaryLog, testTextFallback) {
+  //The string longer than kStringMax fails the encode, the caller formats
+  //the text and saves it as a "%s" record.
+  std::string longer(binary_log::kStringMax + 100, 'x');
+  std::string line = print("long %s end %d", longer.c_str(), 7);
+  char record[binary_log::kRecordMax];
+  ASSERT_EQ(0u, binary_log::encode(
+        record, sizeof(record), 0, "long %s end %d", longer.c_str(), 7));
+  auto length =
+    binary_log::encode_text(record, sizeof(record), 0, line.c_str());
+  ASSERT_GT(length, 0u);
+  std::string text;
+  ASSERT_EQ(length, binary_log::decode(record, length, text));
+  ASSERT_GT(text.size(), line.size() + strlen(LF));
+  ASSERT_EQ(line + LF, text.substr(text.size() - line.size() - strlen(LF)));
+  std::string limit(binary_log::kStringMax, 'y');
+  ASSERT_EQ(limit, render("%s", limit.c_str()));
+  std::string overflow(binary_log::kTextMax + 1, 'z');
+  ASSERT_EQ(0u, binary_log::encode_text(
+        record, sizeof(record), 0, overflow.c_str()));
+}
+
+TEST_F(BasicBinaryLog, testRedefinedFormats) {
+  //The file appended after a restart defines the same id again.
+  char record[binary_log::kRecordMax];
+  std::string data;
+  auto first = binary_log::format_id("first run %d");
+  auto length = binary_log::encode(
+      record, sizeof(record), 0, "first run %d", 1);
+  ASSERT_GT(length, 0u);
+  std::set<uint32_t> written;
+  binary_log::define_formats(record, length, written, data);
+  data.append(record, length);
+  length = binary_log::encode(
+      record, sizeof(record), 0, "second run %s", "restart");
+  ASSERT_GT(length, 0u);
+  written.clear();
+  std::string second;
+  binary_log::define_formats(record, length, written, second);
+  second.append(record, length);
+  //The new process registered the other format as the same id.
+  binary_log::header_t header;
+  for (size_t position = 0; position < second.size();
+       position += header.size) {
+    memcpy(&header, &second[position], sizeof(header));
+    header.format = first;
+    memcpy(&second[position], &header, sizeof(header));
+  }
+  data += second;
+  std::map<uint32_t, std::string> formats;
+  std::string text;
+  ASSERT_EQ(data.size(),
+            binary_log::decode(data.data(), data.size(), text, &formats));
+  auto line = text.find(LF);
+  ASSERT_NE(std::string::npos, line);
+  ASSERT_NE(std::string::npos, text.substr(0, line).find("first run 1"));
+  ASSERT_NE(std::string::npos, text.find("second run restart", line));
+  ASSERT_EQ("second run %s", formats[first]);
+}
+
+TEST_F(BasicBinaryLog, testAppendAcrossRestarts) {
+  const char *logname = "binary_log_test";
+  auto binary = GLOBALS["log.binary"].get<bool>();
+  auto binary_file = GLOBALS["log.binary_file"].get<bool>();
+  auto active = GLOBALS["log.active"].get<bool>();
+  GLOBALS["log.binary"] = true;
+  GLOBALS["log.binary_file"] = true;
+  GLOBALS["log.active"] = true;
+  auto filename = blog_filename(logname);
+  remove(filename.c_str());
+  //Each run is a new logger, the formats written to the file again.
+  g_logger.reset();
+  std::string longer(binary_log::kStringMax + 10, 'x');
+  for (int32_t run = 0; run < 2; ++run) {
+    Logger logger;
+    logger.fast_savelog<0>(logname, "run %d value %u", run, -1);
+    logger.fast_savelog<0>(logname, "run %d long %s", run, longer.c_str());
+    logger.flush_log(logname);
+  }
+  auto logger = new Logger();
+  unique_move(Logger, logger, g_logger);
+  GLOBALS["log.binary"] = binary;
+  GLOBALS["log.binary_file"] = binary_file;
+  GLOBALS["log.active"] = active;
+  std::ifstream file(filename, std::ios::binary);
+  ASSERT_TRUE(file.good());
+  std::string data((std::istreambuf_iterator<char>(file)),
+                   std::istreambuf_iterator<char>());
+  std::map<uint32_t, std::string> formats;
+  std::string text;
+  ASSERT_EQ(data.size(),
+            binary_log::decode(data.data(), data.size(), text, &formats));
+  size_t position{0};
+  for (int32_t run = 0; run < 2; ++run) {
+    position = text.find(print("run %d value 4294967295", run), position);
+    ASSERT_NE(std::string::npos, position);
+    position = text.find(print("run %d long %s", run, longer.c_str()),
+                         position);
+    ASSERT_NE(std::string::npos, position);
+  }
+  remove(filename.c_str());
+}
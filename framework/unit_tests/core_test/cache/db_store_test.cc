@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+#include "pf/sys/memory/share.h"
+#include "pf/cache/db_store.h"
+
+using namespace pf_cache;
+
+//The share memory keys 0xce0001-0xce0004, removed after the tests.
+#define TEST_CACHE_KEY_MAP (0xce0001)
+#define TEST_CACHE_RECYCLE_MAP (0xce0002)
+#define TEST_CACHE_QUERY_MAP (0xce0003)
+#define TEST_CACHE_POOL (0xce0004)
+
+class CacheDBStore : public testing::Test {
+
+ public:
+   static void SetUpTestCase() {
+     const char *filename = "db_store_test.txt";
+     FILE *fp = fopen(filename, "w");
+     ASSERT_TRUE(fp != nullptr);
+     fprintf(fp,
+             "STRING\tINT\tINT\tSTRING\tINT\tINT\tINT\tINT\tINT\tINT\n"
+             "index\tsize\tsame_columns\tsave_columns\tno_save\t"
+             "save_interval\tgroup_index\tshare_key\trecycle_size\t"
+             "data_size\n"
+             "t_player\t16\t1\tid\t0\t0\t0\t%d\t4\t256\n",
+             TEST_CACHE_POOL);
+     fclose(fp);
+     store_.reset(new DBStore());
+     store_->set_key(
+         TEST_CACHE_KEY_MAP, TEST_CACHE_RECYCLE_MAP, TEST_CACHE_QUERY_MAP);
+     store_->set_service(true);
+     ASSERT_TRUE(store_->load_config(filename));
+     ASSERT_TRUE(store_->init());
+     remove(filename);
+   }
+
+   static void TearDownTestCase() {
+     using namespace pf_sys::memory::share;
+     store_.reset();
+     for (uint32_t key = TEST_CACHE_KEY_MAP; key <= TEST_CACHE_POOL; ++key) {
+       auto handle = api::open(key, 0, false);
+       if (handle != HANDLE_INVALID) api::close(handle);
+     }
+   }
+
+ protected:
+   static std::unique_ptr<DBStore> store_;
+
+};
+
+std::unique_ptr<DBStore> CacheDBStore::store_{nullptr};
+
+TEST_F(CacheDBStore, testSetResult) {
+  const char *key = "t_player#1";
+  char value[] = "";
+  store_->put(key, value, 0);
+  ASSERT_TRUE(store_->getitem(key) != nullptr);
+  std::string columns{"columns"};
+  std::string rows{"the whole rows"};
+  ASSERT_TRUE(store_->set_result(key, true, columns, rows));
+  char *cached_columns{nullptr};
+  char *cached_rows{nullptr};
+  ASSERT_TRUE(store_->get(key, cached_columns, cached_rows));
+  ASSERT_EQ(rows, std::string(cached_rows, rows.size()));
+  //The truncated or failed result not replace the cached rows.
+  std::string partial{"the part"};
+  ASSERT_FALSE(store_->set_result(key, false, columns, partial));
+  ASSERT_TRUE(store_->get(key, cached_columns, cached_rows));
+  ASSERT_EQ(rows, std::string(cached_rows, rows.size()));
+  ASSERT_EQ(kQueryError, store_->getitem(key)->status);
+}
+
+TEST_F(CacheDBStore, testSetResultTruncatedFirst) {
+  //The first answer truncated, the cache not filled with the part rows.
+  const char *key = "t_player#2";
+  char value[] = "";
+  store_->put(key, value, 0);
+  ASSERT_TRUE(store_->getitem(key) != nullptr);
+  std::string partial{"the part"};
+  ASSERT_FALSE(store_->set_result(key, false, "columns", partial));
+  char *cached_columns{nullptr};
+  char *cached_rows{nullptr};
+  ASSERT_TRUE(store_->get(key, cached_columns, cached_rows));
+  ASSERT_NE(partial, std::string(cached_rows, partial.size()));
+  ASSERT_EQ(kQueryError, store_->getitem(key)->status);
+}
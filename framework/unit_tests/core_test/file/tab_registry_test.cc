@@ -0,0 +1,166 @@
+#include "gtest/gtest.h"
+#include "pf/sys/thread.h"
+#include "pf/file/tab_registry.h"
+#include <utime.h>
+
+using namespace pf_file;
+
+#define TEST_TAB_FILENAME "tab_registry_test.txt"
+
+class FileTabRegistry : public testing::Test {
+
+ public:
+   //Write the table with the rows(id, name), the modified time set to it.
+   static void write(const char *filename, int32_t rows, time_t modified) {
+     FILE *fp = fopen(filename, "w");
+     ASSERT_TRUE(fp != nullptr);
+     fprintf(fp, "INT\tSTRING\nid\tname\n");
+     for (int32_t i = 1; i <= rows; ++i) fprintf(fp, "%d\titem%d\n", i, i);
+     fclose(fp);
+     touch(filename, modified);
+   }
+
+   static void touch(const char *filename, time_t modified) {
+     struct utimbuf times;
+     times.actime = modified;
+     times.modtime = modified;
+     utime(filename, &times);
+   }
+
+ protected:
+   virtual void SetUp() {
+     write(TEST_TAB_FILENAME, 2, 1000);
+     registry_.reset(new TabRegistry(&pool_));
+   }
+
+   virtual void TearDown() {
+     registry_.reset();
+     remove(TEST_TAB_FILENAME);
+   }
+
+   bool load() {
+     return registry_->load({std::make_pair("item", TEST_TAB_FILENAME)});
+   }
+
+ protected:
+   pf_sys::ThreadPool pool_{2};
+   std::unique_ptr<TabRegistry> registry_;
+
+};
+
+TEST_F(FileTabRegistry, testLoad) {
+  ASSERT_FALSE(registry_->has("item"));
+  ASSERT_EQ(0u, registry_->get_version("item"));
+  ASSERT_TRUE(load());
+  ASSERT_TRUE(registry_->has("item"));
+  ASSERT_EQ(1u, registry_->get_version("item"));
+  auto tab = registry_->get("item");
+  ASSERT_EQ(2, tab->get_record_number());
+  ASSERT_STREQ("item2", tab->get_fielddata(1, "name")->string_value);
+  ASSERT_TRUE(nullptr == registry_->get("unknown"));
+  ASSERT_FALSE(registry_->reload("unknown"));
+  ASSERT_FALSE(registry_->load({std::make_pair("missing", "missing.txt")}));
+  ASSERT_FALSE(registry_->has("missing"));
+}
+
+TEST_F(FileTabRegistry, testReload) {
+  ASSERT_TRUE(load());
+  auto old = registry_->get("item");
+  write(TEST_TAB_FILENAME, 3, 2000);
+  ASSERT_TRUE(registry_->reload("item"));
+  ASSERT_EQ(2u, registry_->get_version("item"));
+  ASSERT_EQ(3, registry_->get("item")->get_record_number());
+  //The snapshot taken before is kept.
+  ASSERT_EQ(2, old->get_record_number());
+}
+
+TEST_F(FileTabRegistry, testReloadModified) {
+  ASSERT_TRUE(load());
+  ASSERT_EQ(0, registry_->reload_modified());
+  write(TEST_TAB_FILENAME, 4, 2000);
+  ASSERT_EQ(1, registry_->reload_modified());
+  ASSERT_EQ(2u, registry_->get_version("item"));
+  ASSERT_EQ(4, registry_->get("item")->get_record_number());
+  ASSERT_EQ(0, registry_->reload_modified());
+
+  //The missing file keep the table and not queued.
+  remove(TEST_TAB_FILENAME);
+  ASSERT_EQ(0, registry_->reload_modified());
+  ASSERT_EQ(4, registry_->get("item")->get_record_number());
+
+  //The failed load queued once, then wait the file changed again.
+  FILE *fp = fopen(TEST_TAB_FILENAME, "w");
+  ASSERT_TRUE(fp != nullptr);
+  fprintf(fp, "BAD\nid\n");
+  fclose(fp);
+  touch(TEST_TAB_FILENAME, 3000);
+  ASSERT_EQ(1, registry_->reload_modified());
+  ASSERT_EQ(0, registry_->reload_modified());
+  ASSERT_EQ(2u, registry_->get_version("item"));
+  ASSERT_EQ(4, registry_->get("item")->get_record_number());
+  write(TEST_TAB_FILENAME, 1, 4000);
+  ASSERT_EQ(1, registry_->reload_modified());
+  ASSERT_EQ(3u, registry_->get_version("item"));
+  ASSERT_EQ(1, registry_->get("item")->get_record_number());
+}
+
+TEST_F(FileTabRegistry, testPrepare) {
+  registry_->set_prepare([](const std::string &, Tab &tab) {
+    tab.create_index("name", {1}, true);
+  });
+  ASSERT_TRUE(load());
+  auto tab = registry_->get("item");
+  auto index = tab->get_indexid("name");
+  ASSERT_NE(INDEX_INVALID, index);
+  auto record = tab->search_unique(index, Tab::field_data("item2"));
+  ASSERT_TRUE(record != nullptr);
+  ASSERT_EQ(2, record[0].int_value);
+}
+
+TEST_F(FileTabRegistry, testStaleReload) {
+  ASSERT_TRUE(load());
+  //The first reload read the old file and finish after the second one.
+  std::atomic<int32_t> prepared{0};
+  registry_->set_prepare([&prepared](const std::string &, Tab &tab) {
+    if (5 == tab.get_record_number())
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ++prepared;
+  });
+  write(TEST_TAB_FILENAME, 5, 2000);
+  ASSERT_TRUE(registry_->reload("item", false));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  write(TEST_TAB_FILENAME, 6, 3000);
+  ASSERT_TRUE(registry_->reload("item"));
+  while (prepared < 2) std::this_thread::yield();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  //The older one dropped.
+  ASSERT_EQ(2u, registry_->get_version("item"));
+  ASSERT_EQ(6, registry_->get("item")->get_record_number());
+}
+
+TEST_F(FileTabRegistry, testConcurrentReload) {
+  ASSERT_TRUE(load());
+  write(TEST_TAB_FILENAME, 3, 2000);
+  std::atomic<bool> stop{false};
+  std::thread reader([this, &stop]() {
+    while (!stop) {
+      auto tab = registry_->get("item");
+      ASSERT_TRUE(tab != nullptr);
+      auto count = tab->get_record_number();
+      ASSERT_TRUE(2 == count || 3 == count);
+    }
+  });
+  std::vector<std::thread> writers;
+  for (int32_t i = 0; i < 4; ++i) {
+    writers.emplace_back([this]() {
+      for (int32_t j = 0; j < 20; ++j) registry_->reload("item");
+    });
+  }
+  for (auto &writer : writers) writer.join();
+  stop = true;
+  reader.join();
+  //The loads finished after a newer one not published.
+  ASSERT_GT(registry_->get_version("item"), 1u);
+  ASSERT_LE(registry_->get_version("item"), 81u);
+  ASSERT_EQ(3, registry_->get("item")->get_record_number());
+}
@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+#include "pf/file/tab.h"
+
+using namespace pf_file;
+
+class FileTab : public testing::Test {
+
+ protected:
+   //Each test has its own table, the indexes not shared.
+   virtual void SetUp() {
+     const char *content = 
+       "INT\tINT\tFLOAT\tSTRING\n"
+       "id\tlevel\texp\tname\n"
+       "1\t1\t0.5\tsword\n"
+       "2\t5\t1.5\tshield\n"
+       "3\t5\t2.5\tsword\n"
+       "4\t10\t3.5\tbow\n";
+     tab_.reset(new Tab(0));
+     ASSERT_TRUE(
+         tab_->open_from_memory(content, content + strlen(content) + 1));
+   }
+
+ protected:
+   std::unique_ptr<Tab> tab_;
+
+};
+
+TEST_F(FileTab, testFieldIndex) {
+  ASSERT_EQ(4, tab_->get_record_number());
+  ASSERT_EQ(1, tab_->get_fieldindex("level"));
+  ASSERT_EQ(3, tab_->get_fieldindex("name"));
+  ASSERT_EQ(INDEX_INVALID, tab_->get_fieldindex("unknown"));
+  ASSERT_TRUE(nullptr == tab_->get_fielddata(0, "unknown"));
+  ASSERT_EQ(10, tab_->get_fielddata(3, "level")->int_value);
+}
+
+TEST_F(FileTab, testHashIndex) {
+  auto name = tab_->create_index("name", {3});
+  ASSERT_NE(INDEX_INVALID, name);
+  ASSERT_EQ(name, tab_->get_indexid("name"));
+  //The duplicate keys of the unique index assert(the debug build).
+  testing::internal::CaptureStdout();
+  ASSERT_EQ(INDEX_INVALID, tab_->create_index("unique_name", {3}, true));
+  auto output = testing::internal::GetCapturedStdout();
+#ifndef NDEBUG
+  ASSERT_NE(std::string::npos, output.find("multi index"));
+#endif
+  ASSERT_EQ(INDEX_INVALID, tab_->get_indexid("unique_name"));
+  Tab::record_list records;
+  ASSERT_EQ(2, tab_->search_multi(name, Tab::field_data("sword"), records));
+  ASSERT_EQ(0, tab_->search_multi(name, Tab::field_data("axe"), records));
+
+  //Composite.
+  auto level_name = tab_->create_index("level_name", {1, 3}, true);
+  ASSERT_NE(INDEX_INVALID, level_name);
+  Tab::index_key_t key;
+  key.add(Tab::field_data(5)).add(Tab::field_data("sword"));
+  auto record = tab_->search_unique(level_name, key);
+  ASSERT_TRUE(record != nullptr);
+  ASSERT_EQ(3, record[0].int_value);
+
+  //The key count not the index columns.
+  ASSERT_TRUE(nullptr == tab_->search_unique(level_name, Tab::field_data(5)));
+  key.add(Tab::field_data(1)).add(Tab::field_data(2));
+  ASSERT_TRUE(nullptr == tab_->search_unique(level_name, key));
+  ASSERT_EQ(0, tab_->search_multi(name, key, records));
+
+  //Float column and first column search use the index.
+  auto exp = tab_->create_index("exp", {2}, true);
+  record = tab_->search_unique(exp, Tab::field_data(2.5f));
+  ASSERT_TRUE(record != nullptr);
+  ASSERT_EQ(3, record[0].int_value);
+  record = tab_->search_first_column_equal(3, Tab::field_data("sword"));
+  ASSERT_EQ(1, record[0].int_value);
+}
+
+TEST_F(FileTab, testSortedIndex) {
+  auto level = tab_->create_sorted_index("level", 1);
+  ASSERT_NE(INDEX_INVALID, level);
+  Tab::record_list records;
+  ASSERT_EQ(2, tab_->search_range(
+        level, Tab::field_data(2), Tab::field_data(9), records));
+  ASSERT_EQ(2, records[0][0].int_value);
+  ASSERT_EQ(3, records[1][0].int_value);
+  auto record = tab_->search_floor(level, Tab::field_data(7));
+  ASSERT_EQ(3, record[0].int_value);
+  ASSERT_TRUE(nullptr == tab_->search_floor(level, Tab::field_data(0)));
+}
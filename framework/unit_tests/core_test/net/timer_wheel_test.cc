@@ -0,0 +1,59 @@
+#include "gtest/gtest.h"
+#include "pf/net/connection/manager/timer_wheel.h"
+
+using namespace pf_net::connection::manager;
+
+class NetTimerWheel : public testing::Test {
+
+ protected:
+   //The expired ids of the advance.
+   std::vector<int16_t> advance(uint32_t now) {
+     std::vector<int16_t> expired;
+     wheel_.advance(now, expired);
+     return expired;
+   }
+
+ protected:
+   TimerWheel wheel_;
+
+};
+
+TEST_F(NetTimerWheel, testAdvance) {
+  uint32_t now{1050};
+  ASSERT_TRUE(wheel_.init(8, now, 100, 16));
+  wheel_.schedule(1, now + 250);
+  wheel_.schedule(2, now + 30);
+  wheel_.schedule(3, now + 5000); //More than a round.
+  ASSERT_EQ(3u, wheel_.size());
+  ASSERT_EQ(std::vector<int16_t>{2}, advance(now + 100));
+  ASSERT_TRUE(advance(now + 200).empty());
+  ASSERT_EQ(std::vector<int16_t>{1}, advance(now + 300));
+  wheel_.cancel(3);
+  ASSERT_FALSE(wheel_.is_scheduled(3));
+  ASSERT_TRUE(advance(now + 6000).empty());
+  ASSERT_EQ(0u, wheel_.size());
+
+  //The time jumped more than a round.
+  now += 6000;
+  wheel_.schedule(4, now + 3000);
+  wheel_.schedule(5, now + 99999);
+  ASSERT_EQ(std::vector<int16_t>{4}, advance(now + 90000));
+  ASSERT_EQ(std::vector<int16_t>{5}, advance(now + 100000));
+}
+
+TEST_F(NetTimerWheel, testWrapAround) {
+  //The tick count wraps in the wheel.
+  uint32_t now{0xffffffff - 250};
+  ASSERT_TRUE(wheel_.init(8, now, 100, 16));
+  wheel_.schedule(1, now + 500);
+  wheel_.schedule(2, now + 120);
+  ASSERT_TRUE(advance(now + 100).empty());
+  ASSERT_EQ(std::vector<int16_t>{2}, advance(now + 200));
+  ASSERT_TRUE(advance(now + 400).empty());
+  ASSERT_TRUE(wheel_.is_scheduled(1));
+  ASSERT_EQ(std::vector<int16_t>{1}, advance(now + 500));
+  wheel_.schedule(3, now + 900);
+  ASSERT_TRUE(advance(now + 800).empty());
+  ASSERT_EQ(std::vector<int16_t>{3}, advance(now + 1000));
+  ASSERT_EQ(0u, wheel_.size());
+}
@@ -0,0 +1,165 @@
+#include "gtest/gtest.h"
+#include "pf/util/compressor/lz4.h"
+#include "pf/util/compressor/codec.h"
+
+using namespace pf_util::compressor;
+
+class UtilLz4 : public testing::Test {
+
+ public:
+   static std::vector<unsigned char> text(uint32_t size, uint32_t seed) {
+     static const char *words[] =
+       {"player ", "level ", "sword ", "shield ", "exp ", "guild "};
+     std::vector<unsigned char> result;
+     while (result.size() < size) {
+       seed = seed * 1103515245 + 12345;
+       const char *word = words[(seed >> 16) % 6];
+       result.insert(result.end(), word, word + strlen(word));
+     }
+     result.resize(size);
+     return result;
+   }
+
+   static std::vector<unsigned char> noise(uint32_t size, uint32_t seed) {
+     std::vector<unsigned char> result(size);
+     for (auto &value : result) {
+       seed = seed * 1103515245 + 12345;
+       value = static_cast<unsigned char>(seed >> 16);
+     }
+     return result;
+   }
+
+};
+
+TEST_F(UtilLz4, testRoundTrip) {
+  uint32_t sizes[] = {0, 1, 12, 13, 64, 1000, 20000, 200000};
+  for (uint32_t size : sizes) {
+    for (int32_t kind = 0; kind < 3; ++kind) {
+      auto in = 0 == kind ? text(size, size) :
+                1 == kind ? noise(size, size) :
+                std::vector<unsigned char>(size, 'a');
+      std::vector<unsigned char> out(UTIL_COMPRESSOR_LZ4_GET_OUTLENGTH(size));
+      uint32_t outsize = lz4::compress(
+          in.data(), size, out.data(), static_cast<uint32_t>(out.size()));
+      ASSERT_NE(0, outsize);
+      std::vector<unsigned char> back(size + 1);
+      ASSERT_EQ(static_cast<int32_t>(size),
+                lz4::decompress(out.data(), outsize, back.data(), size));
+      ASSERT_TRUE(std::equal(in.begin(), in.end(), back.begin()));
+    }
+  }
+}
+
+TEST_F(UtilLz4, testOutNotEnough) {
+  auto in = noise(1000, 1);
+  std::vector<unsigned char> out(UTIL_COMPRESSOR_LZ4_GET_OUTLENGTH(1000));
+  ASSERT_EQ(0, lz4::compress(in.data(), 1000, out.data(), 500));
+  auto outsize = lz4::compress(
+      in.data(), 1000, out.data(), static_cast<uint32_t>(out.size()));
+  std::vector<unsigned char> back(1000);
+  ASSERT_EQ(-1, lz4::decompress(out.data(), outsize, back.data(), 999));
+}
+
+TEST_F(UtilLz4, testMalformed) {
+  std::vector<unsigned char> back(256);
+  auto decompress = [&back](std::vector<unsigned char> in) {
+    return lz4::decompress(
+        in.data(), static_cast<uint32_t>(in.size()), back.data(), 256);
+  };
+  ASSERT_EQ(-1, lz4::decompress(nullptr, 0, back.data(), 256));
+  ASSERT_EQ(3, decompress({0x30, 'a', 'b', 'c'}));
+  ASSERT_EQ(-1, decompress({0x30, 'a', 'b'})); //Literals cut.
+  ASSERT_EQ(-1, decompress({0xf0})); //Length cut.
+  ASSERT_EQ(-1, decompress({0xf0, 255, 255})); //Length cut.
+  ASSERT_EQ(-1, decompress({0xf0, 255, 255, 255, 255, 255})); //Too long.
+  ASSERT_EQ(-1, decompress({0x10, 'a', 0x00, 0x00, 0x00})); //Zero offset.
+  ASSERT_EQ(-1, decompress({0x10, 'a', 0x02, 0x00, 0x00})); //Before out.
+  ASSERT_EQ(-1, decompress({0x10, 'a', 0x01})); //Offset cut.
+  ASSERT_EQ(-1, decompress({0x10, 'a', 0x01, 0x00})); //No last literals.
+  ASSERT_EQ(-1, decompress({0x1f, 'a', 0x01, 0x00, 255})); //Match cut.
+  ASSERT_EQ(-1, decompress({0x1f, 'a', 0x01, 0x00, 255, 0, 0x00}));//Too long.
+  //The overlap match repeat the byte.
+  ASSERT_EQ(10, decompress({0x15, 'a', 0x01, 0x00, 0x00}));
+  ASSERT_EQ(std::string(10, 'a'), std::string(back.begin(), back.begin() + 10));
+
+  //The random damage never write out the capacity.
+  auto in = text(4000, 7);
+  std::vector<unsigned char> out(UTIL_COMPRESSOR_LZ4_GET_OUTLENGTH(4000));
+  auto outsize = lz4::compress(
+      in.data(), 4000, out.data(), static_cast<uint32_t>(out.size()));
+  std::vector<unsigned char> guard(4000 + 64, 0xcc);
+  for (uint32_t i = 0; i < outsize; i += 3) {
+    auto damaged = out;
+    damaged[i] ^= static_cast<unsigned char>(0x5a + i);
+    auto result =
+      lz4::decompress(damaged.data(), outsize - i % 5, guard.data(), 4000);
+    ASSERT_LE(result, 4000);
+    for (uint32_t j = 4000; j < guard.size(); ++j) ASSERT_EQ(0xcc, guard[j]);
+  }
+}
+
+TEST_F(UtilLz4, testStream) {
+  const uint32_t frame_max = 16 * 1024;
+  lz4::Stream compressor(frame_max);
+  lz4::Stream decompressor(frame_max);
+  std::vector<unsigned char> out(UTIL_COMPRESSOR_LZ4_GET_OUTLENGTH(frame_max));
+  std::vector<unsigned char> back(frame_max);
+  uint32_t total{0};
+  //Enough frames to slide the window many times.
+  for (uint32_t i = 0; i < 200; ++i) {
+    uint32_t size = 100 + (i * 977) % (frame_max - 100);
+    auto in = 0 == i % 7 ? noise(size, i) : text(size, i % 3);
+    auto outsize = compressor.compress(
+        in.data(), size, out.data(), static_cast<uint32_t>(out.size()));
+    ASSERT_NE(0, outsize);
+    if (0 == i % 5) continue; //Not commit, the peer never see it.
+    compressor.commit(size);
+    ASSERT_EQ(static_cast<int32_t>(size), decompressor.decompress(
+          out.data(), outsize, back.data(), frame_max));
+    ASSERT_TRUE(std::equal(in.begin(), in.end(), back.begin()));
+    total += size;
+  }
+  ASSERT_GT(total, static_cast<uint32_t>(UTIL_COMPRESSOR_LZ4_WINDOW * 4));
+  auto in = text(frame_max + 1, 0);
+  ASSERT_EQ(0, compressor.compress(
+        in.data(), frame_max + 1, out.data(),
+        static_cast<uint32_t>(out.size())));
+
+  //A corrupt frame fail without the out overflow.
+  std::vector<unsigned char> bad = {0x10, 'a', 0xff, 0xff, 0x00};
+  ASSERT_EQ(-1, decompressor.decompress(
+        bad.data(), static_cast<uint32_t>(bad.size()), back.data(), 1));
+}
+
+TEST_F(UtilLz4, testCodec) {
+  for (uint8_t id : {kCodecLzo, kCodecLz4, kCodecLz4Stream}) {
+    auto codec = codec::get(id);
+    ASSERT_TRUE(codec != nullptr);
+    std::unique_ptr<CodecContext> compress_context(
+        codec->create_context(8192));
+    std::unique_ptr<CodecContext> decompress_context(
+        codec->create_context(8192));
+    for (uint32_t i = 0; i < 10; ++i) {
+      auto in = text(8000, i);
+      std::vector<unsigned char> out(codec->bound(8000));
+      uint32_t outsize = static_cast<uint32_t>(out.size());
+      ASSERT_TRUE(codec->compress(
+            compress_context.get(), in.data(), 8000, out.data(), outsize));
+      std::vector<unsigned char> back(8192);
+      uint32_t backsize = 8192;
+      ASSERT_TRUE(codec->decompress(decompress_context.get(),
+            out.data(), outsize, back.data(), backsize));
+      ASSERT_EQ(8000, backsize);
+      ASSERT_TRUE(std::equal(in.begin(), in.end(), back.begin()));
+    }
+    //The incompressible data is not compressed.
+    auto in = noise(1000, 3);
+    std::vector<unsigned char> out(codec->bound(1000));
+    uint32_t outsize = static_cast<uint32_t>(out.size());
+    ASSERT_FALSE(codec->compress(
+          compress_context.get(), in.data(), 1000, out.data(), outsize));
+  }
+  ASSERT_EQ(kCodecLz4Stream, codec::negotiate(codec::mask(), codec::mask()));
+  ASSERT_EQ(kCodecLzo, codec::negotiate(codec::mask(), 1U << kCodecLzo));
+  ASSERT_EQ(kCodecNone, codec::negotiate(codec::mask(), 0));
+}